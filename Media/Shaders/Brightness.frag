@@ -1,12 +1,22 @@
 uniform sampler2D source;
+uniform vec2 offsetFactor;
 
 const float Threshold = 0.95;
 const float Factor   = 4.0;
 
-void main()
+vec4 filterBright(vec4 sourceFragment)
 {
-	vec4 sourceFragment = texture2D(source, gl_TexCoord[0].xy);
 	float luminance = sourceFragment.r * 0.2126 + sourceFragment.g * 0.7152 + sourceFragment.b * 0.0722;
-	sourceFragment *= clamp(luminance - Threshold, 0.0, 1.0) * Factor;
-	gl_FragColor = sourceFragment;
+	return sourceFragment * clamp(luminance - Threshold, 0.0, 1.0) * Factor;
+}
+
+// Filters and downsamples in one pass: four bilinear samples around the output pixel, offsetFactor apart
+void main()
+{
+	vec2 textureCoordinates = gl_TexCoord[0].xy;
+	vec4 color = filterBright(texture2D(source, textureCoordinates + vec2(-1.0, -1.0) * offsetFactor));
+	color     += filterBright(texture2D(source, textureCoordinates + vec2( 1.0, -1.0) * offsetFactor));
+	color     += filterBright(texture2D(source, textureCoordinates + vec2(-1.0,  1.0) * offsetFactor));
+	color     += filterBright(texture2D(source, textureCoordinates + vec2( 1.0,  1.0) * offsetFactor));
+	gl_FragColor = color / 4.0;
 }
\ No newline at end of file
@@ -1,18 +1,17 @@
 uniform sampler2D 	source;
 uniform vec2 		offsetFactor;
 
+// The 9 tap Gaussian applied twice, as one 13 tap kernel in 7 samples: each pair of outer taps is one bilinear
+// sample between them, at the offset weighted by their share. Only exact if offsetFactor is one texel.
 void main()
 {
 	vec2 textureCoordinates = gl_TexCoord[0].xy;
-	vec4 color = vec4(0.0);
-	color += texture2D(source, textureCoordinates - 4.0 * offsetFactor) * 0.0162162162;
-	color += texture2D(source, textureCoordinates - 3.0 * offsetFactor) * 0.0540540541;
-	color += texture2D(source, textureCoordinates - 2.0 * offsetFactor) * 0.1216216216;
-	color += texture2D(source, textureCoordinates - offsetFactor) * 0.1945945946;
-	color += texture2D(source, textureCoordinates) * 0.2270270270;
-	color += texture2D(source, textureCoordinates + offsetFactor) * 0.1945945946;
-	color += texture2D(source, textureCoordinates + 2.0 * offsetFactor) * 0.1216216216;
-	color += texture2D(source, textureCoordinates + 3.0 * offsetFactor) * 0.0540540541;
-	color += texture2D(source, textureCoordinates + 4.0 * offsetFactor) * 0.0162162162;
+	vec4 color = texture2D(source, textureCoordinates) * 0.1638894593;
+	color += texture2D(source, textureCoordinates - 1.4394779772 * offsetFactor) * 0.2697509314;
+	color += texture2D(source, textureCoordinates + 1.4394779772 * offsetFactor) * 0.2697509314;
+	color += texture2D(source, textureCoordinates - 3.3558404044 * offsetFactor) * 0.1218719747;
+	color += texture2D(source, textureCoordinates + 3.3558404044 * offsetFactor) * 0.1218719747;
+	color += texture2D(source, textureCoordinates - 5.2608213097 * offsetFactor) * 0.0264323642;
+	color += texture2D(source, textureCoordinates + 5.2608213097 * offsetFactor) * 0.0264323642;
 	gl_FragColor = color;
-}
\ No newline at end of file
+}
@@ -0,0 +1,6 @@
+uniform sampler2D source;
+
+void main()
+{
+    gl_FragColor = gl_Color * texture2D(source, gl_TexCoord[0].xy);
+}
\ No newline at end of file
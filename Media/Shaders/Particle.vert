@@ -0,0 +1,32 @@
+uniform float time;
+uniform float lifetime;
+uniform float maxSpeed;
+uniform vec2 startSize;
+uniform vec2 endSize;
+uniform vec4 startColor;
+uniform vec4 endColor;
+
+// The color bytes hold the velocity, each component as 16 bit fixed point in [-maxSpeed, maxSpeed]
+vec2 decodeVelocity(vec4 color)
+{
+	vec4 bytes = floor(color * 255.0 + 0.5);
+	vec2 fixedPoint = vec2(bytes.r * 256.0 + bytes.g, bytes.b * 256.0 + bytes.a);
+	return (fixedPoint / 65535.0 * 2.0 - 1.0) * maxSpeed;
+}
+
+// gl_Vertex is the spawn position, gl_MultiTexCoord0.x the quad corner as u + 2v, gl_MultiTexCoord0.y the spawn time
+void main()
+{
+	float corner = gl_MultiTexCoord0.x;
+	vec2 uv = vec2(mod(corner, 2.0), floor(corner / 2.0));
+
+	float age = time - gl_MultiTexCoord0.y;
+	float ratio = clamp(age / lifetime, 0.0, 1.0);
+
+	vec2 center = gl_Vertex.xy + decodeVelocity(gl_Color) * age;
+	vec2 size = mix(startSize, endSize, ratio);
+
+	gl_Position = gl_ModelViewProjectionMatrix * vec4(center + (uv - 0.5) * size, 0.0, 1.0);
+	gl_TexCoord[0] = vec4(uv, 0.0, 1.0);
+	gl_FrontColor = mix(startColor, endColor, ratio);
+}
\ No newline at end of file
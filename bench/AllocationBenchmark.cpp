@@ -0,0 +1,256 @@
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+
+#include <SFML/Network/TcpSocket.hpp>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "CommandQueue.h"
+#include "Player.h"
+#include "ResourceHolder.h"
+#include "ResourceIdentifiers.h"
+#include "SceneNode.h"
+#include "SendBuffer.h"
+#include "Utility.h"
+#include "World.h"
+
+namespace
+{
+	const std::size_t WarmupFrames = 10;
+	const std::size_t MeasuredFrames = 100;
+	const std::size_t EnemyCount = 50;
+
+	// Same fixed step as GameRoom, the enemy wave has spawned and every buffer has grown after the warm-up
+	const sf::Time TimePerStep = sf::seconds(1.f / 60.f);
+	const std::size_t WarmupSteps = 120;
+	const std::size_t MeasuredSteps = 1200;
+	const std::size_t WaveSize = 30;
+	const std::size_t WeavePeriod = 90;
+	const unsigned int RandomSeed = 42;
+
+	class BenchNode : public SceneNode
+	{
+	public:
+		explicit BenchNode(Category category)
+			: category_(category)
+			, checksum_(0.f)
+		{
+		}
+
+		virtual Category getCategory() const override
+		{
+			return category_;
+		}
+
+		void receive(float value)
+		{
+			checksum_ += value;
+		}
+
+	private:
+		Category category_;
+		float checksum_;
+	};
+
+	// Same shape as the functor Player binds to its movement actions
+	struct Mover
+	{
+		void operator() (BenchNode& node, sf::Time) const
+		{
+			node.receive(velocity.x + static_cast<float>(identifier));
+		}
+
+		sf::Vector2f velocity;
+		int identifier;
+	};
+
+	// Commands of one frame with the captures used in the game: player movement, positioned sounds,
+	// network notifications and particle system finders. push() wraps the typed functor into an action.
+	template <typename Push>
+	void queueFrame(Push push, BenchNode& emitter)
+	{
+		for (int identifier = 0; identifier < 2; ++identifier)
+		{
+			push(Category::PlayerAircraft, Mover{ sf::Vector2f(1.f, 0.f), identifier });
+		}
+
+		for (std::size_t i = 0; i < EnemyCount; ++i)
+		{
+			int effect = static_cast<int>(i % 3);
+			sf::Vector2f position(static_cast<float>(i), 10.f);
+
+			push(Category::SoundEffect, [effect, position](BenchNode& node, sf::Time)
+				{
+					node.receive(position.x + static_cast<float>(effect));
+				});
+
+			if (i % 5 == 0)
+			{
+				push(Category::Network, [position](BenchNode& node, sf::Time)
+					{
+						node.receive(position.y);
+					});
+			}
+
+			if (i % 2 == 0)
+			{
+				BenchNode* source = &emitter;
+				push(Category::ParticleSystem, [source, effect](BenchNode& node, sf::Time)
+					{
+						source->receive(static_cast<float>(effect));
+						node.receive(1.f);
+					});
+			}
+		}
+	}
+
+	template <typename Frame>
+	double allocationsPerFrame(Frame frame)
+	{
+		for (std::size_t i = 0; i < WarmupFrames; ++i)
+		{
+			frame();
+		}
+
+		std::size_t before = Benchmark::getAllocationCount();
+		for (std::size_t i = 0; i < MeasuredFrames; ++i)
+		{
+			frame();
+		}
+
+		return static_cast<double>(Benchmark::getAllocationCount() - before) / MeasuredFrames;
+	}
+
+	struct WorldResult
+	{
+		double allocationsPerStep;
+		double meanStep;
+		std::size_t gameActions;
+	};
+
+	// Server world of a GameRoom: a remote player flies and fires on its relayed realtime actions, the enemy wave
+	// fires back and explodes. The queue carries the game's own commands: AircraftMover, fire, playLocalSound,
+	// the network notifications of the explosions and the world's missile guidance and cleanup commands.
+	// Spawns and missile launches create nodes, the wave spawns during the warm-up and no missile is launched.
+	WorldResult runWorldSteps()
+	{
+		seedRandomEngine(RandomSeed);
+
+		FontHolder fonts;
+		World world(fonts, true);
+		world.addAircraft(1)->setHitpoints(1000000);
+
+		sf::TcpSocket socket;
+		SendBuffer sendBuffer(socket);
+		Player player(&sendBuffer, 1, nullptr);
+		player.handleNetworkRealtimeChange(PlayerAction::Fire, true);
+
+		for (std::size_t i = 0; i < WaveSize; ++i)
+		{
+			float x = (static_cast<float>(i % 10) - 4.5f) * 80.f;
+			float y = 150.f + static_cast<float>(i / 10) * 100.f;
+			world.addEnemy(i % 2 == 0 ? Aircraft::Raptor : Aircraft::Avenger, x, y);
+		}
+		world.sortEnemies();
+
+		WorldResult result{ 0.0, 0.0, 0 };
+		std::size_t before = 0;
+		for (std::size_t step = 0; step < WarmupSteps + MeasuredSteps; ++step)
+		{
+			if (step == WarmupSteps)
+			{
+				before = Benchmark::getAllocationCount();
+			}
+
+			bool isMovingLeft = (step / WeavePeriod) % 2 == 0;
+			player.handleNetworkRealtimeChange(PlayerAction::MoveLeft, isMovingLeft);
+			player.handleNetworkRealtimeChange(PlayerAction::MoveRight, !isMovingLeft);
+
+			double elapsed = Benchmark::measure([&]()
+				{
+					player.handleRealtimeNetworkInput(world.getCommandQueue());
+					world.update(TimePerStep);
+
+					GameActions::Action gameAction;
+					while (world.pollGameAction(gameAction))
+					{
+						result.gameActions += step >= WarmupSteps ? 1 : 0;
+					}
+				});
+
+			result.meanStep += step >= WarmupSteps ? elapsed / MeasuredSteps : 0.0;
+		}
+
+		result.allocationsPerStep = static_cast<double>(Benchmark::getAllocationCount() - before) / MeasuredSteps;
+		return result;
+	}
+}
+
+void runAllocationBenchmark()
+{
+	Benchmark::printTitle("Command queue heap allocations (steady state)");
+	Benchmark::printHeader({ "method", "allocs/frame", "mean us" });
+
+	// Every command is executed on this node, only queueing and invocation are compared
+	std::unique_ptr<BenchNode> emitter(new BenchNode(Category::None));
+
+	// Previous implementation: std::function actions in a std::queue, popped by value
+	typedef std::function<void(SceneNode&, sf::Time)> Function;
+	std::queue<std::pair<Category, Function>> functionQueue;
+	auto functionFrame = [&]()
+		{
+			queueFrame([&](Category category, auto fn)
+				{
+					// What derivedAction used to return
+					Function action = [fn](SceneNode& node, sf::Time dt) { fn(static_cast<BenchNode&>(node), dt); };
+					functionQueue.push(std::make_pair(category, action));
+				}, *emitter);
+
+			while (!functionQueue.empty())
+			{
+				std::pair<Category, Function> command = functionQueue.front();
+				functionQueue.pop();
+				command.second(*emitter, sf::Time::Zero);
+			}
+		};
+
+	double functionAllocations = allocationsPerFrame(functionFrame);
+	Benchmark::Samples functionSamples = Benchmark::repeat(functionFrame);
+	Benchmark::printRow({ "std::function", Benchmark::format(functionAllocations), Benchmark::format(functionSamples.mean()) });
+
+	CommandQueue commandQueue;
+	auto commandFrame = [&]()
+		{
+			queueFrame([&](Category category, auto fn)
+				{
+					Command command;
+					command.category = category;
+					command.action = derivedAction<BenchNode>(fn);
+					commandQueue.push(command);
+				}, *emitter);
+
+			Command command;
+			while (commandQueue.pop(command))
+			{
+				command.action(*emitter, sf::Time::Zero);
+			}
+		};
+
+	double commandAllocations = allocationsPerFrame(commandFrame);
+	Benchmark::Samples commandSamples = Benchmark::repeat(commandFrame);
+	Benchmark::printRow({ "CommandAction", Benchmark::format(commandAllocations), Benchmark::format(commandSamples.mean()) });
+
+	Benchmark::check(commandAllocations == 0.0, "no heap allocation per steady-state frame in CommandQueue");
+
+	Benchmark::printTitle("Server world steps with a player and an enemy wave (steady state)");
+	Benchmark::printHeader({ "steps", "allocs/step", "mean us", "game actions" });
+
+	WorldResult world = runWorldSteps();
+	Benchmark::printRow({ std::to_string(MeasuredSteps), Benchmark::format(world.allocationsPerStep), Benchmark::format(world.meanStep),
+		std::to_string(world.gameActions) });
+
+	Benchmark::check(world.gameActions > 0, "enemies exploded while the allocations were counted");
+	Benchmark::check(world.allocationsPerStep == 0.0, "no heap allocation per steady-state World::update");
+}
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "Benchmark.h"
+
+// Replaces the global allocation functions of the benchmark executable to count heap allocations.
+// The array and nothrow forms, aligned or not, forward to these by default.
+namespace
+{
+	std::atomic<std::size_t> allocationCount(0);
+}
+
+void* operator new(std::size_t size)
+{
+	++allocationCount;
+
+	if (void* memory = std::malloc(size == 0 ? 1 : size))
+	{
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+// Over-aligned types use their own overloads, an allocation there must not slip past the counter.
+// MSVC has no std::aligned_alloc, its aligned blocks need their own free function.
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	++allocationCount;
+
+	// aligned_alloc wants the size in multiples of the alignment
+	const std::size_t align = static_cast<std::size_t>(alignment);
+	const std::size_t alignedSize = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+#ifdef _MSC_VER
+	void* memory = _aligned_malloc(alignedSize, align);
+#else
+	void* memory = std::aligned_alloc(align, alignedSize);
+#endif
+	if (memory)
+	{
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+#ifdef _MSC_VER
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(memory, alignment);
+}
+
+namespace Benchmark
+{
+	std::size_t getAllocationCount()
+	{
+		return allocationCount.load();
+	}
+}
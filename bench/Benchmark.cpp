@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+#include "Benchmark.h"
+
+namespace
+{
+	const int ColumnWidth = 16;
+
+	bool failedChecks = false;
+}
+
+namespace Benchmark
+{
+	void Samples::add(double microseconds)
+	{
+		values_.push_back(microseconds);
+	}
+
+	void Samples::clear()
+	{
+		values_.clear();
+	}
+
+	std::size_t Samples::size() const
+	{
+		return values_.size();
+	}
+
+	double Samples::mean() const
+	{
+		if (values_.empty())
+		{
+			return 0.0;
+		}
+
+		return std::accumulate(values_.begin(), values_.end(), 0.0) / static_cast<double>(values_.size());
+	}
+
+	double Samples::min() const
+	{
+		return values_.empty() ? 0.0 : *std::min_element(values_.begin(), values_.end());
+	}
+
+	double Samples::max() const
+	{
+		return values_.empty() ? 0.0 : *std::max_element(values_.begin(), values_.end());
+	}
+
+	double Samples::percentile(double fraction) const
+	{
+		if (values_.empty())
+		{
+			return 0.0;
+		}
+
+		std::vector<double> sorted(values_);
+		std::sort(sorted.begin(), sorted.end());
+
+		auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+		return sorted[std::min(index, sorted.size() - 1)];
+	}
+
+	void check(bool condition, const std::string& description)
+	{
+		std::cout << (condition ? "[PASS] " : "[FAIL] ") << description << std::endl;
+		failedChecks = failedChecks || !condition;
+	}
+
+	bool hasFailedChecks()
+	{
+		return failedChecks;
+	}
+
+	void printTitle(const std::string& title)
+	{
+		std::cout << "\n== " << title << " ==\n";
+	}
+
+	void printHeader(const std::vector<std::string>& columns)
+	{
+		printRow(columns);
+		std::cout << std::string(columns.size() * ColumnWidth, '-') << '\n';
+	}
+
+	void printRow(const std::vector<std::string>& values)
+	{
+		for (const auto& value : values)
+		{
+			std::cout << std::left << std::setw(ColumnWidth) << value;
+		}
+		std::cout << std::endl;
+	}
+
+	std::string format(double value, int precision)
+	{
+		std::ostringstream stream;
+		stream << std::fixed << std::setprecision(precision) << value;
+		return stream.str();
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+
+namespace Benchmark
+{
+	// Collection of timing samples in microseconds
+	class Samples
+	{
+	public:
+		void add(double microseconds);
+		void clear();
+
+		std::size_t size() const;
+		double mean() const;
+		double min() const;
+		double max() const;
+		double percentile(double fraction) const;
+
+	private:
+		std::vector<double> values_;
+	};
+
+	// Measure a single invocation of fn, in microseconds
+	template <typename Function>
+	double measure(Function&& fn)
+	{
+		auto start = std::chrono::steady_clock::now();
+		fn();
+		auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double, std::micro>(end - start).count();
+	}
+
+	// Repeat fn until minTime has passed (at least once, at most maxIterations times)
+	template <typename Function>
+	Samples repeat(Function&& fn, double minTimeMicroseconds = 500000.0, std::size_t maxIterations = 1000)
+	{
+		Samples samples;
+		double total = 0.0;
+
+		while (samples.size() < maxIterations && (samples.size() == 0 || total < minTimeMicroseconds))
+		{
+			double elapsed = measure(fn);
+			samples.add(elapsed);
+			total += elapsed;
+		}
+
+		return samples;
+	}
+
+	// Number of heap allocations (global operator new) since program start
+	std::size_t getAllocationCount();
+
+	// Failed checks are reported and make the benchmark executable exit with an error code
+	void check(bool condition, const std::string& description);
+	bool hasFailedChecks();
+
+	// Table output
+	void printTitle(const std::string& title);
+	void printHeader(const std::vector<std::string>& columns);
+	void printRow(const std::vector<std::string>& values);
+	std::string format(double value, int precision = 2);
+}
+
@@ -0,0 +1,24 @@
+#pragma once
+
+// Benchmark scenarios, each prints its own result table
+void runAllocationBenchmark();
+void runBroadcastBenchmark();
+void runCoalescingBenchmark();
+void runCollisionBenchmark();
+void runCommandBenchmark();
+void runDrainBenchmark();
+void runEffectBenchmark();
+void runEmitterBenchmark();
+void runFrameBenchmark();
+void runIntegrationBenchmark();
+void runInterpolationBenchmark();
+void runParticleBenchmark();
+void runProjectileBenchmark();
+void runRelayBenchmark();
+void runRoomBenchmark();
+void runServerTickBenchmark();
+void runSnapshotBenchmark();
+void runSoakBenchmark();
+void runTransportBenchmark();
+void runTransformBenchmark();
+
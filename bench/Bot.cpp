@@ -0,0 +1,94 @@
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/SocketSelector.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include "Bot.h"
+#include "NetworkProtocol.h"
+
+namespace
+{
+	const sf::Time ConnectTimeout = sf::seconds(1.f);
+	const sf::Time RetryInterval = sf::milliseconds(10);
+}
+
+Bot::Bot()
+	: socket()
+	, aircraftIdentifier(0)
+	, isMovingLeft(false)
+	, receivedBytes(0)
+	, lastReceiveTime(sf::Time::Zero)
+{
+}
+
+bool Bot::connect()
+{
+	// The server thread may not be listening yet
+	sf::Clock connectClock;
+	while (socket.connect(sf::IpAddress::LocalHost, ServerPort, ConnectTimeout) != sf::Socket::Done)
+	{
+		if (connectClock.getElapsedTime() >= ConnectTimeout)
+		{
+			return false;
+		}
+
+		sf::sleep(RetryInterval);
+	}
+
+	sf::SocketSelector selector;
+	selector.add(socket);
+
+	sf::Packet packet;
+	while (selector.wait(ConnectTimeout) && socket.receive(packet) == sf::Socket::Done)
+	{
+		sf::Int32 packetType;
+		packet >> packetType;
+		if (static_cast<ServerPacketType>(packetType) == ServerPacketType::SpawnSelf)
+		{
+			packet >> aircraftIdentifier;
+			socket.setBlocking(false);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void Bot::start()
+{
+	sendRealtimeChange(PlayerAction::Fire, true);
+	sendRealtimeChange(isMovingLeft ? PlayerAction::MoveLeft : PlayerAction::MoveRight, true);
+}
+
+void Bot::turn()
+{
+	sendRealtimeChange(isMovingLeft ? PlayerAction::MoveLeft : PlayerAction::MoveRight, false);
+	isMovingLeft = !isMovingLeft;
+	sendRealtimeChange(isMovingLeft ? PlayerAction::MoveLeft : PlayerAction::MoveRight, true);
+}
+
+void Bot::quit()
+{
+	sf::Packet packet;
+	packet << static_cast<sf::Int32>(ClientPacketType::Quit);
+	socket.send(packet);
+}
+
+void Bot::receiveAll(sf::Time now)
+{
+	sf::Packet packet;
+	while (socket.receive(packet) == sf::Socket::Done)
+	{
+		receivedBytes += packet.getDataSize();
+		lastReceiveTime = now;
+	}
+}
+
+void Bot::sendRealtimeChange(PlayerAction action, bool isEnabled)
+{
+	sf::Packet packet;
+	packet << static_cast<sf::Int32>(ClientPacketType::PlayerRealtimeChange) << aircraftIdentifier
+		<< static_cast<sf::Int32>(action) << isEnabled;
+	socket.send(packet);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/System/Time.hpp>
+
+#include "KeyBinding.h"
+
+
+// Headless loopback client that flies and shoots through realtime actions only, like a player holding keys
+struct Bot
+{
+	Bot();
+
+	// Connects to the local server and waits for SpawnSelf, which carries the bot's aircraft identifier
+	bool connect();
+
+	// Fire constantly, turn around on every call to turn()
+	void start();
+	void turn();
+	void quit();
+
+	// Reads everything pending, the bots only count the server's traffic
+	void receiveAll(sf::Time now);
+
+	void sendRealtimeChange(PlayerAction action, bool isEnabled);
+
+	sf::TcpSocket socket;
+	sf::Int32 aircraftIdentifier;
+	bool isMovingLeft;
+	std::size_t receivedBytes;
+	sf::Time lastReceiveTime;
+};
@@ -0,0 +1,196 @@
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "BroadcastPacket.h"
+#include "NetworkProtocol.h"
+#include "Snapshot.h"
+
+namespace
+{
+	const std::size_t PeerCount = 10;
+	const std::size_t TickCount = 20 * 60;
+	const float TicksPerSecond = 20.f;
+	const float ScrollSpeed = -50.f;
+	const float InterestMargin = 200.f;
+
+	// Every bot turns every 700 ms, which is two realtime changes
+	const std::size_t TurnTicks = 14;
+
+	// Ticks until the server has a snapshot's acknowledgement; the last peer is one tick slower
+	const std::size_t AckLatency = 2;
+
+	// sf::TcpSocket prefixes every packet with its Uint32 size
+	const std::size_t PacketSizeHeader = 4;
+
+	sf::FloatRect getBattlefield(std::size_t tick)
+	{
+		return sf::FloatRect(0.f, 4232.f + ScrollSpeed * tick / TicksPerSecond, 1024.f, 768.f);
+	}
+
+	// Aircraft follow the scrolling view; the last one fell behind it, as after a respawn or while being destroyed
+	sf::Vector2f getPosition(std::size_t peer, std::size_t tick)
+	{
+		float time = tick / TicksPerSecond;
+		float x = 100.f + 80.f * peer;
+		if (peer % 2 == 0)
+		{
+			x += 120.f * std::sin(time + peer);
+		}
+
+		float behind = peer == PeerCount - 1 ? 1500.f : 0.f;
+		return sf::Vector2f(x, 4600.f + ScrollSpeed * time + behind);
+	}
+
+	// The copy sf::TcpSocket::send(sf::Packet&) makes to put the size in front of the data
+	std::size_t frame(const sf::Packet& packet, std::vector<char>& buffer)
+	{
+		buffer.resize(PacketSizeHeader + packet.getDataSize());
+		std::memcpy(buffer.data() + PacketSizeHeader, packet.getData(), packet.getDataSize());
+		return buffer.size();
+	}
+
+	struct Peer
+	{
+		std::deque<sf::Uint16> pendingAcks;
+		bool hasSnapshotAck = false;
+		sf::Uint16 ackedSnapshot = 0;
+	};
+
+	struct BroadcastResult
+	{
+		std::size_t bytes;
+		Benchmark::Samples serialization;
+	};
+
+	// Same traffic through both versions of GameRoom's broadcasting: every peer gets a snapshot each tick and
+	// the realtime changes of the others. isFiltered turns on the new path: shared serialization, no echoes
+	// to the origin and interest management.
+	BroadcastResult runBroadcast(bool isFiltered)
+	{
+		BroadcastResult result{ 0, Benchmark::Samples() };
+
+		std::vector<Peer> peers(PeerCount);
+		SnapshotHistory snapshots;
+		Snapshot snapshot;
+		std::vector<char> socketBuffer;
+
+		for (std::size_t tick = 0; tick < TickCount; ++tick)
+		{
+			sf::FloatRect battlefield = getBattlefield(tick);
+			sf::FloatRect interestRect(battlefield.left - InterestMargin, battlefield.top - InterestMargin,
+				battlefield.width + 2.f * InterestMargin, battlefield.height + 2.f * InterestMargin);
+
+			result.serialization.add(Benchmark::measure([&]
+			{
+				// Relayed realtime changes of the bots turning this tick
+				for (std::size_t origin = 0; origin < PeerCount; ++origin)
+				{
+					if ((tick + origin) % TurnTicks != 0)
+					{
+						continue;
+					}
+
+					for (sf::Int32 change = 0; change < 2; ++change)
+					{
+						sf::Packet payload;
+						payload << static_cast<sf::Int32>(origin + 1) << change << (change == 1);
+
+						BroadcastPacket shared(ServerPacketType::PlayerRealtimeChange, payload);
+						for (std::size_t peer = 0; peer < PeerCount; ++peer)
+						{
+							if (!isFiltered)
+							{
+								sf::Packet packet;
+								writeServerPacketType(packet, ServerPacketType::PlayerRealtimeChange, ProtocolVersion);
+								packet.append(payload.getData(), payload.getDataSize());
+								result.bytes += frame(packet, socketBuffer);
+							}
+							else if (peer != origin)
+							{
+								result.bytes += shared.getBytes(ProtocolVersion).size();
+							}
+						}
+					}
+				}
+
+				// State update, as in GameRoom::updateClientState()
+				++snapshot.sequence;
+				snapshot.battleFieldPosition = Snapshot::quantize(battlefield.top + battlefield.height);
+				snapshot.entries.clear();
+				for (std::size_t peer = 0; peer < PeerCount; ++peer)
+				{
+					sf::Vector2f position = getPosition(peer, tick);
+					if (!isFiltered || interestRect.contains(position))
+					{
+						snapshot.setAircraft(static_cast<sf::Int32>(peer + 1), position, 100, 2);
+					}
+				}
+				snapshots.add(snapshot);
+
+				std::map<sf::Uint16, sf::Packet> snapshotPayloads;
+				std::map<sf::Uint16, BroadcastPacket> snapshotPackets;
+				for (const Peer& peer : peers)
+				{
+					const Snapshot* base = peer.hasSnapshotAck ? snapshots.find(peer.ackedSnapshot) : nullptr;
+					if (!isFiltered)
+					{
+						sf::Packet packet;
+						writeServerPacketType(packet, ServerPacketType::Snapshot, ProtocolVersion);
+						snapshot.write(packet, base);
+						result.bytes += frame(packet, socketBuffer);
+						continue;
+					}
+
+					sf::Uint16 baseSequence = base ? base->sequence : snapshot.sequence;
+					auto found = snapshotPackets.find(baseSequence);
+					if (found == snapshotPackets.end())
+					{
+						sf::Packet& payload = snapshotPayloads[baseSequence];
+						snapshot.write(payload, base);
+						found = snapshotPackets.emplace(baseSequence, BroadcastPacket(ServerPacketType::Snapshot, payload)).first;
+					}
+					result.bytes += found->second.getBytes(ProtocolVersion).size();
+				}
+			}));
+
+			// Acknowledgements reach the server a few ticks later
+			for (std::size_t i = 0; i < PeerCount; ++i)
+			{
+				Peer& peer = peers[i];
+				peer.pendingAcks.push_back(snapshot.sequence);
+				if (peer.pendingAcks.size() > AckLatency + (i == PeerCount - 1 ? 1 : 0))
+				{
+					peer.ackedSnapshot = peer.pendingAcks.front();
+					peer.hasSnapshotAck = true;
+					peer.pendingAcks.pop_front();
+				}
+			}
+		}
+
+		return result;
+	}
+}
+
+void runBroadcastBenchmark()
+{
+	Benchmark::printTitle("Server broadcasts to " + std::to_string(PeerCount) + " peers at 20 Hz (per tick)");
+
+	BroadcastResult perPeer = runBroadcast(false);
+	BroadcastResult shared = runBroadcast(true);
+
+	Benchmark::printHeader({ "broadcast", "bytes/tick", "serialize us", "serialize p99" });
+	Benchmark::printRow({ "per peer", Benchmark::format(static_cast<double>(perPeer.bytes) / TickCount),
+		Benchmark::format(perPeer.serialization.mean()), Benchmark::format(perPeer.serialization.percentile(0.99)) });
+	Benchmark::printRow({ "shared+interest", Benchmark::format(static_cast<double>(shared.bytes) / TickCount),
+		Benchmark::format(shared.serialization.mean()), Benchmark::format(shared.serialization.percentile(0.99)) });
+
+	Benchmark::check(shared.bytes < perPeer.bytes, "interest management and no echoes send fewer bytes");
+	Benchmark::check(shared.serialization.mean() < perPeer.serialization.mean(), "shared serialization is faster than per peer packets");
+}
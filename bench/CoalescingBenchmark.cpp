@@ -0,0 +1,180 @@
+#include <iostream>
+#include <string>
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/TcpListener.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "NetworkProtocol.h"
+#include "PacketQueue.h"
+#include "SendBuffer.h"
+
+namespace
+{
+	const std::size_t TickCount = 20 * 30;
+
+	// A busy tick of a full room, seen by one peer: relayed input of the others, spawns, a pickup and the snapshot
+	const std::size_t RealtimeChangesPerTick = 6;
+	const std::size_t EnemiesPerTick = 2;
+
+	// Bytes offered to a peer that never reads before its buffer must have stalled, socket buffers included
+	const std::size_t StalledPeerLimit = 256 * 1024 * 1024;
+
+	struct CoalescingResult
+	{
+		SendBuffer::Counters sends;
+		Benchmark::Samples sendTimes;
+		std::size_t received;
+	};
+
+	template <typename Send>
+	void produceTick(std::size_t tick, Send send)
+	{
+		for (std::size_t i = 0; i < RealtimeChangesPerTick; ++i)
+		{
+			sf::Packet packet;
+			packet << static_cast<sf::Uint8>(ServerPacketType::PlayerRealtimeChange) << static_cast<sf::Int32>(i + 2)
+				<< static_cast<sf::Int32>(i % 5) << (tick % 2 == 0);
+			send(packet);
+		}
+
+		for (std::size_t i = 0; i < EnemiesPerTick; ++i)
+		{
+			sf::Packet packet;
+			packet << static_cast<sf::Uint8>(ServerPacketType::SpawnEnemy) << sf::Int32(1) << 500.f << static_cast<float>(i * 100);
+			send(packet);
+		}
+
+		sf::Packet pickup;
+		pickup << static_cast<sf::Uint8>(ServerPacketType::SpawnPickup) << sf::Int32(0) << 300.f << 4000.f;
+		send(pickup);
+
+		// Roughly a delta snapshot of ten aircraft
+		sf::Packet snapshot;
+		snapshot << static_cast<sf::Uint8>(ServerPacketType::Snapshot) << static_cast<sf::Uint16>(tick) << static_cast<sf::Uint16>(tick - 2)
+			<< sf::Int16(0) << sf::Uint8(0) << sf::Uint8(10);
+		for (sf::Uint16 i = 0; i < 10; ++i)
+		{
+			snapshot << i << sf::Int8(1) << sf::Int8(-1);
+		}
+		send(snapshot);
+	}
+
+	std::size_t drain(sf::TcpSocket& client, PacketQueue& queue)
+	{
+		std::size_t received = 0;
+		while (queue.receive(client) > 0)
+		{
+			while (!queue.isEmpty())
+			{
+				queue.pop();
+				++received;
+			}
+		}
+
+		return received;
+	}
+
+	template <typename Tick>
+	CoalescingResult runTicks(sf::TcpSocket& client, Tick tick)
+	{
+		CoalescingResult result{ SendBuffer::Counters(), Benchmark::Samples(), 0 };
+		PacketQueue queue;
+
+		for (std::size_t i = 0; i < TickCount; ++i)
+		{
+			result.sendTimes.add(Benchmark::measure([&] { tick(i, result.sends); }));
+			result.received += drain(client, queue);
+		}
+
+		// Loopback delivers quickly, give the last tick a moment to arrive
+		sf::sleep(sf::milliseconds(50));
+		result.received += drain(client, queue);
+
+		return result;
+	}
+
+	void printResult(const std::string& name, const CoalescingResult& result)
+	{
+		Benchmark::printRow({ name, Benchmark::format(static_cast<double>(result.sends.messages) / TickCount),
+			Benchmark::format(static_cast<double>(result.sends.sendCalls) / TickCount),
+			Benchmark::format(static_cast<double>(result.sends.bytes) / TickCount), Benchmark::format(result.sendTimes.mean()) });
+	}
+}
+
+void runCoalescingBenchmark()
+{
+	Benchmark::printTitle("Server sends to one peer per tick over loopback");
+
+	// Any free port, the game's own server may be running
+	sf::TcpListener listener;
+	sf::TcpSocket server;
+	sf::TcpSocket client;
+	if (listener.listen(sf::Socket::AnyPort) != sf::Socket::Done
+		|| client.connect(sf::IpAddress::LocalHost, listener.getLocalPort()) != sf::Socket::Done
+		|| listener.accept(server) != sf::Socket::Done)
+	{
+		std::cout << "Skipped: could not open a loopback connection" << std::endl;
+		return;
+	}
+	client.setBlocking(false);
+	server.setBlocking(false);
+
+	Benchmark::printHeader({ "sends", "messages/tick", "send calls/tick", "bytes/tick", "send us/tick" });
+
+	// Previous GameServer: every message is its own send call
+	CoalescingResult direct = runTicks(client, [&](std::size_t tick, SendBuffer::Counters& sends)
+		{
+			produceTick(tick, [&](sf::Packet& packet)
+				{
+					std::size_t size = packet.getDataSize();
+					server.send(packet);
+					++sends.messages;
+					++sends.sendCalls;
+					sends.bytes += sizeof(sf::Uint32) + size;
+				});
+		});
+	printResult("per message", direct);
+
+	SendBuffer buffer(server);
+	CoalescingResult coalesced = runTicks(client, [&](std::size_t tick, SendBuffer::Counters& sends)
+		{
+			produceTick(tick, [&](sf::Packet& packet) { buffer.append(packet); });
+			buffer.flush();
+			sends.add(buffer.takeCounters());
+		});
+	printResult("coalesced", coalesced);
+
+	Benchmark::check(coalesced.received == coalesced.sends.messages, "the peer receives every coalesced message as its own packet");
+	Benchmark::check(coalesced.sends.sendCalls * 4 <= direct.sends.sendCalls, "coalescing cuts send calls at least fourfold");
+
+	// A peer that never reads: once the socket buffers are full, the pending bytes hit the cap instead of growing
+	sf::TcpSocket stalledServer;
+	sf::TcpSocket stalledClient;
+	if (stalledClient.connect(sf::IpAddress::LocalHost, listener.getLocalPort()) != sf::Socket::Done
+		|| listener.accept(stalledServer) != sf::Socket::Done)
+	{
+		std::cout << "Skipped: could not open a second loopback connection" << std::endl;
+		return;
+	}
+	stalledServer.setBlocking(false);
+
+	SendBuffer stalledBuffer(stalledServer);
+	sf::Packet filler;
+	filler.append(std::string(1024, 'x').data(), 1024);
+
+	std::size_t appendedBytes = 0;
+	while (!stalledBuffer.isStalled() && appendedBytes < StalledPeerLimit)
+	{
+		stalledBuffer.append(filler);
+		appendedBytes += filler.getDataSize();
+	}
+	stalledBuffer.flush();
+
+	std::cout << "Stalled peer dropped after " << appendedBytes / 1024 << " KiB" << std::endl;
+	Benchmark::check(stalledBuffer.isStalled(), "a peer that stops reading stalls its send buffer");
+}
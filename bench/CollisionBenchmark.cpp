@@ -0,0 +1,115 @@
+#include <array>
+#include <random>
+#include <set>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "CollisionGrid.h"
+#include "SceneNode.h"
+
+namespace
+{
+	// Scene node with a fixed category and size, stands in for aircraft, projectiles and pickups
+	class BenchNode : public SceneNode
+	{
+	public:
+		BenchNode(Category category, sf::Vector2f size)
+			: category_(category)
+			, size_(size)
+		{
+		}
+
+		virtual Category getCategory() const override
+		{
+			return category_;
+		}
+
+		virtual sf::FloatRect getBoundingRect() const override
+		{
+			return getWorldTransform().transformRect(sf::FloatRect(-size_ / 2.f, size_));
+		}
+
+	private:
+		Category category_;
+		sf::Vector2f size_;
+	};
+
+	// Same pairs World registers in its constructor
+	void registerPairs(CollisionGrid& grid)
+	{
+		grid.addCollisionPair(Category::PlayerAircraft, Category::EnemyAircraft);
+		grid.addCollisionPair(Category::PlayerAircraft, Category::Pickup);
+		grid.addCollisionPair(Category::EnemyAircraft, Category::AlliedProjectile);
+		grid.addCollisionPair(Category::PlayerAircraft, Category::EnemyProjectile);
+	}
+
+	// Entities spread over a few screens of the world, mostly projectiles like in a busy battle
+	SceneNode::Ptr buildScene(std::size_t entityCount)
+	{
+		std::mt19937 engine(42);
+		std::uniform_real_distribution<float> xDistribution(0.f, 640.f);
+		std::uniform_real_distribution<float> yDistribution(0.f, 480.f * 4.f);
+		std::uniform_int_distribution<int> typeDistribution(0, 9);
+
+		const std::array<Category, 10> categories = {
+			Category::PlayerAircraft, Category::EnemyAircraft, Category::EnemyAircraft, Category::Pickup,
+			Category::AlliedProjectile, Category::AlliedProjectile, Category::AlliedProjectile,
+			Category::EnemyProjectile, Category::EnemyProjectile, Category::EnemyProjectile,
+		};
+
+		SceneNode::Ptr root(new SceneNode());
+		SceneNode::Ptr layer(new SceneNode(Category::SceneAirLayer));
+
+		for (std::size_t i = 0; i < entityCount; ++i)
+		{
+			Category category = categories[typeDistribution(engine)];
+			bool isProjectile = (category & Category::Projectile) != Category::None;
+			sf::Vector2f size = isProjectile ? sf::Vector2f(3.f, 14.f) : sf::Vector2f(48.f, 64.f);
+
+			std::unique_ptr<BenchNode> node(new BenchNode(category, size));
+			node->setPosition(xDistribution(engine), yDistribution(engine));
+			layer->attachChild(std::move(node));
+		}
+
+		root->attachChild(std::move(layer));
+		return root;
+	}
+}
+
+void runCollisionBenchmark()
+{
+	Benchmark::printTitle("Collision detection (per frame, microseconds)");
+	Benchmark::printHeader({ "entities", "method", "mean", "p99", "max", "pairs" });
+
+	for (std::size_t entityCount : { 100u, 1000u, 10000u })
+	{
+		SceneNode::Ptr scene = buildScene(entityCount);
+
+		// Old path: every node against the whole scene graph, its pair count includes pairs no one handles
+		std::set<SceneNode::Pair> pairSet;
+		Benchmark::Samples traversal = Benchmark::repeat([&]()
+			{
+				pairSet.clear();
+				scene->checkSceneCollision(*scene, pairSet);
+			}, 500000.0, 200);
+
+		Benchmark::printRow({ std::to_string(entityCount), "traversal",
+			Benchmark::format(traversal.mean()), Benchmark::format(traversal.percentile(0.99)),
+			Benchmark::format(traversal.max()), std::to_string(pairSet.size()) });
+
+		// New path: uniform grid broad phase with category filtering
+		CollisionGrid grid;
+		registerPairs(grid);
+		std::vector<SceneNode::Pair> pairs;
+		Benchmark::Samples gridSamples = Benchmark::repeat([&]()
+			{
+				grid.clear();
+				scene->insertColliders(grid);
+				grid.computePairs(pairs);
+			});
+
+		Benchmark::printRow({ std::to_string(entityCount), "grid",
+			Benchmark::format(gridSamples.mean()), Benchmark::format(gridSamples.percentile(0.99)),
+			Benchmark::format(gridSamples.max()), std::to_string(pairs.size()) });
+	}
+}
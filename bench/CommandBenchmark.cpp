@@ -0,0 +1,121 @@
+#include <array>
+#include <random>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "CategoryRegistry.h"
+#include "SceneNode.h"
+
+namespace
+{
+	class BenchNode : public SceneNode
+	{
+	public:
+		explicit BenchNode(Category category)
+			: category_(category)
+		{
+		}
+
+		virtual Category getCategory() const override
+		{
+			return category_;
+		}
+
+	private:
+		Category category_;
+	};
+
+	// Roughly the commands of one frame: player input, particle and sound finders, network, out-of-view cleanup
+	std::vector<Command> buildFrameCommands(std::size_t& counter)
+	{
+		const std::array<Category, 8> categories = {
+			Category::PlayerAircraft, Category::PlayerAircraft, Category::PlayerAircraft,
+			Category::ParticleSystem, Category::ParticleSystem, Category::SoundEffect, Category::Network,
+			Category::Aircraft | Category::Projectile | Category::Pickup,
+		};
+
+		std::vector<Command> commands;
+		for (Category category : categories)
+		{
+			Command command;
+			command.category = category;
+			command.action = [&counter](SceneNode&, sf::Time) { ++counter; };
+			commands.push_back(command);
+		}
+
+		return commands;
+	}
+
+	// Entities in a layer, each projectile/aircraft carrying an emitter-like child without category
+	void buildScene(SceneNode& root, std::size_t entityCount)
+	{
+		std::mt19937 engine(42);
+		std::uniform_int_distribution<int> typeDistribution(0, 9);
+
+		const std::array<Category, 10> categories = {
+			Category::EnemyAircraft, Category::EnemyAircraft, Category::Pickup, Category::AlliedProjectile,
+			Category::AlliedProjectile, Category::AlliedProjectile, Category::EnemyProjectile,
+			Category::EnemyProjectile, Category::EnemyProjectile, Category::EnemyProjectile,
+		};
+
+		SceneNode::Ptr layer(new SceneNode(Category::SceneAirLayer));
+		layer->attachChild(SceneNode::Ptr(new BenchNode(Category::PlayerAircraft)));
+		layer->attachChild(SceneNode::Ptr(new BenchNode(Category::ParticleSystem)));
+		layer->attachChild(SceneNode::Ptr(new BenchNode(Category::ParticleSystem)));
+		layer->attachChild(SceneNode::Ptr(new BenchNode(Category::SoundEffect)));
+		layer->attachChild(SceneNode::Ptr(new BenchNode(Category::Network)));
+
+		for (std::size_t i = 0; i < entityCount; ++i)
+		{
+			SceneNode::Ptr node(new BenchNode(categories[typeDistribution(engine)]));
+			node->attachChild(SceneNode::Ptr(new SceneNode()));
+			layer->attachChild(std::move(node));
+		}
+
+		root.attachChild(std::move(layer));
+	}
+}
+
+void runCommandBenchmark()
+{
+	Benchmark::printTitle("Command dispatch (per frame, microseconds)");
+	Benchmark::printHeader({ "entities", "method", "mean", "p99", "visited", "matched" });
+
+	for (std::size_t entityCount : { 100u, 1000u, 10000u })
+	{
+		std::size_t matched = 0;
+		std::vector<Command> commands = buildFrameCommands(matched);
+
+		CategoryRegistry registry;
+		SceneNode root;
+		root.setCategoryRegistry(&registry);
+		buildScene(root, entityCount);
+
+		// Old path: every command visits the whole graph (root, layer, 5 singletons, 2 nodes per entity)
+		Benchmark::Samples walk = Benchmark::repeat([&]()
+			{
+				matched = 0;
+				for (const Command& command : commands)
+				{
+					root.onCommand(command, sf::Time::Zero);
+				}
+			});
+
+		const std::size_t graphSize = 7 + 2 * entityCount;
+		Benchmark::printRow({ std::to_string(entityCount), "graph walk", Benchmark::format(walk.mean()),
+			Benchmark::format(walk.percentile(0.99)), std::to_string(graphSize * commands.size()), std::to_string(matched) });
+
+		Benchmark::Samples dispatch = Benchmark::repeat([&]()
+			{
+				matched = 0;
+				registry.resetCounters();
+				for (const Command& command : commands)
+				{
+					registry.dispatch(command, sf::Time::Zero);
+				}
+			});
+
+		Benchmark::printRow({ std::to_string(entityCount), "registry", Benchmark::format(dispatch.mean()),
+			Benchmark::format(dispatch.percentile(0.99)), std::to_string(registry.getVisitedCount()), std::to_string(registry.getMatchedCount()) });
+	}
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <iostream>
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/TcpListener.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "NetworkProtocol.h"
+#include "PacketQueue.h"
+
+namespace
+{
+	const std::size_t FrameCount = 240;
+	const std::size_t SpawnsPerFrame = 8;
+	const sf::Time PacketBudget = sf::milliseconds(4);
+
+	struct DrainResult
+	{
+		double handledPerFrame;
+		std::size_t maxBacklog;
+		std::size_t finalBacklog;
+	};
+
+	// Client side of a SpawnEnemy packet, without the world
+	void handleSpawnEnemy(sf::Packet& packet)
+	{
+		sf::Int32 packetType;
+		sf::Int32 enemyType;
+		float height;
+		float relativeX;
+		packet >> packetType >> enemyType >> height >> relativeX;
+	}
+
+	// Server floods SpawnEnemy every frame; the backlog counts packets sent but not yet handled by the client
+	template <typename ClientFrame>
+	DrainResult runFlood(sf::TcpSocket& server, ClientFrame clientFrame)
+	{
+		DrainResult result{ 0.0, 0, 0 };
+		std::size_t sent = 0;
+		std::size_t handled = 0;
+
+		for (std::size_t frame = 0; frame < FrameCount; ++frame)
+		{
+			for (std::size_t i = 0; i < SpawnsPerFrame; ++i, ++sent)
+			{
+				sf::Packet packet;
+				packet << static_cast<sf::Int32>(ServerPacketType::SpawnEnemy) << sf::Int32(1) << 500.f << static_cast<float>(i);
+				server.send(packet);
+			}
+
+			handled += clientFrame();
+			result.maxBacklog = std::max(result.maxBacklog, sent - handled);
+		}
+
+		result.handledPerFrame = static_cast<double>(handled) / FrameCount;
+		result.finalBacklog = sent - handled;
+		return result;
+	}
+
+	void printResult(const std::string& name, const DrainResult& result)
+	{
+		Benchmark::printRow({ name, Benchmark::format(result.handledPerFrame), std::to_string(result.maxBacklog),
+			std::to_string(result.finalBacklog) });
+	}
+}
+
+void runDrainBenchmark()
+{
+	Benchmark::printTitle("Client receive loop, " + std::to_string(SpawnsPerFrame) + " SpawnEnemy per frame over loopback");
+
+	// Any free port, the game's own server may be running
+	sf::TcpListener listener;
+	sf::TcpSocket server;
+	sf::TcpSocket client;
+	if (listener.listen(sf::Socket::AnyPort) != sf::Socket::Done
+		|| client.connect(sf::IpAddress::LocalHost, listener.getLocalPort()) != sf::Socket::Done
+		|| listener.accept(server) != sf::Socket::Done)
+	{
+		std::cout << "Skipped: could not open a loopback connection" << std::endl;
+		return;
+	}
+	client.setBlocking(false);
+
+	Benchmark::printHeader({ "client", "packets/frame", "max backlog", "final backlog" });
+
+	// Previous MultiplayerGameState::update(): one receive per frame
+	printResult("one per frame", runFlood(server, [&]()
+		{
+			sf::Packet packet;
+			if (client.receive(packet) != sf::Socket::Done)
+			{
+				return std::size_t(0);
+			}
+
+			handleSpawnEnemy(packet);
+			return std::size_t(1);
+		}));
+
+	// Let the old client catch up, so the next run starts with an empty socket
+	PacketQueue queue;
+	while (queue.receive(client) > 0)
+	{
+		while (!queue.isEmpty())
+		{
+			queue.pop();
+		}
+	}
+
+	// Drain everything available, handle it within the frame budget
+	DrainResult drained = runFlood(server, [&]()
+		{
+			queue.receive(client);
+
+			sf::Clock budgetClock;
+			std::size_t handled = 0;
+			while (!queue.isEmpty() && budgetClock.getElapsedTime() < PacketBudget)
+			{
+				handleSpawnEnemy(queue.front());
+				queue.pop();
+				++handled;
+			}
+			return handled;
+		});
+	printResult("drain + budget", drained);
+
+	Benchmark::check(drained.finalBacklog <= SpawnsPerFrame, "backlog stays within one frame of packets when draining");
+}
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "CommandQueue.h"
+#include "EmitterNode.h"
+#include "ParticleNode.h"
+#include "ParticleRegistry.h"
+#include "ResourceHolder.h"
+#include "ResourceIdentifiers.h"
+
+namespace
+{
+	const std::size_t FrameCount = 600;
+	const sf::Time FrameTime = sf::seconds(1.f / 60.f);
+
+	// A heavy dogfight: every frame two aircraft explode and hundreds of bullets hit, while the engine
+	// trails and missile trails of everything in view keep emitting
+	const std::size_t ExplosionsPerFrame = 2;
+	const std::size_t BulletHitsPerFrame = 300;
+	const std::size_t EngineCount = 400;
+	const std::size_t MissileCount = 50;
+
+	sf::Vector2f getPosition(std::size_t index)
+	{
+		return sf::Vector2f(static_cast<float>(index * 37 % 1024), static_cast<float>(index * 53 % 768));
+	}
+
+	struct EffectResult
+	{
+		Benchmark::Samples frames;
+		double requestedPerFrame;
+		std::size_t mostEmitted;
+		double emittedPerFrame;
+		std::size_t liveParticles;
+	};
+
+	EffectResult runStress(std::size_t budget)
+	{
+		// Registry first, it outlives the emitters registered in it
+		TextureHolder textures;
+		ParticleRegistry particles;
+		SceneNode root;
+		particles.setBudget(budget);
+
+		std::vector<ParticleNode*> systems;
+		for (std::size_t type = 0; type < Particle::ParticleCount; ++type)
+		{
+			std::unique_ptr<ParticleNode> system = std::make_unique<ParticleNode>(static_cast<Particle::Type>(type), textures);
+			particles.addSystem(*system);
+			systems.push_back(system.get());
+			root.attachChild(std::move(system));
+		}
+
+		auto attachEmitter = [&](Particle::Type type, std::size_t index)
+			{
+				std::unique_ptr<EmitterNode> emitter = std::make_unique<EmitterNode>(type, particles, sf::Vector2f(0.f, 1.f));
+				emitter->setPosition(getPosition(index));
+				root.attachChild(std::move(emitter));
+			};
+
+		for (std::size_t i = 0; i < EngineCount; ++i)
+		{
+			attachEmitter(Particle::EngineTrail, i);
+		}
+		for (std::size_t i = 0; i < MissileCount; ++i)
+		{
+			attachEmitter(Particle::Smoke, EngineCount + i);
+			attachEmitter(Particle::Propellant, EngineCount + i);
+		}
+
+		EffectResult result{ Benchmark::Samples(), 0.0, 0, 0.0, 0 };
+		CommandQueue commands;
+		std::size_t emittedCount = 0;
+		std::size_t requestedCount = 0;
+		std::size_t next = 0;
+
+		for (std::size_t frame = 0; frame < FrameCount; ++frame)
+		{
+			for (std::size_t i = 0; i < ExplosionsPerFrame; ++i, ++next)
+			{
+				particles.burst(Particle::Debris, getPosition(next), sf::Vector2f());
+			}
+			for (std::size_t i = 0; i < BulletHitsPerFrame; ++i, ++next)
+			{
+				particles.burst(Particle::Spark, getPosition(next), sf::Vector2f(0.f, 1.f));
+			}
+
+			result.frames.add(Benchmark::measure([&]()
+				{
+					particles.emit(FrameTime);
+					root.integrate(FrameTime, commands);
+				}));
+
+			requestedCount += particles.getEmittedCount() + particles.getSkippedCount();
+			result.mostEmitted = std::max(result.mostEmitted, particles.getEmittedCount());
+			emittedCount += particles.getEmittedCount();
+		}
+
+		// Averaged, the engine trails emit in phase and a single frame may hold only the bursts
+		result.requestedPerFrame = static_cast<double>(requestedCount) / FrameCount;
+		result.emittedPerFrame = static_cast<double>(emittedCount) / FrameCount;
+		for (const ParticleNode* system : systems)
+		{
+			result.liveParticles += system->getParticleCount();
+		}
+
+		return result;
+	}
+}
+
+void runEffectBenchmark()
+{
+	Benchmark::printTitle("Particle effects stress scene, emission and aging per frame (microseconds)");
+	Benchmark::printHeader({ "budget", "mean", "p99", "requested", "emitted", "alive" });
+
+	std::vector<EffectResult> results;
+	for (std::size_t budget : { std::numeric_limits<std::size_t>::max(), ParticleRegistry::DefaultBudget, std::size_t(500) })
+	{
+		EffectResult result = runStress(budget);
+		std::string name = (budget == std::numeric_limits<std::size_t>::max()) ? "none" : std::to_string(budget);
+
+		Benchmark::printRow({ name, Benchmark::format(result.frames.mean()), Benchmark::format(result.frames.percentile(0.99)),
+			Benchmark::format(result.requestedPerFrame), Benchmark::format(result.emittedPerFrame), std::to_string(result.liveParticles) });
+
+		Benchmark::check(result.mostEmitted <= budget, "no step emits more than the budget of " + name);
+		results.push_back(result);
+	}
+
+	Benchmark::check(results[0].requestedPerFrame > ParticleRegistry::DefaultBudget, "the stress scene is over the default budget");
+	Benchmark::check(results[2].frames.mean() < results[0].frames.mean(), "a lower budget makes the frame cheaper");
+}
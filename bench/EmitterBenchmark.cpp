@@ -0,0 +1,207 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "CategoryRegistry.h"
+#include "Command.h"
+#include "CommandQueue.h"
+#include "EmitterNode.h"
+#include "ParticleNode.h"
+#include "ParticleRegistry.h"
+#include "ResourceHolder.h"
+#include "ResourceIdentifiers.h"
+
+namespace
+{
+	const std::size_t MissileCount = 50;
+	const std::size_t FrameCount = 600;
+	const sf::Time FrameTime = sf::seconds(1.f / 60.f);
+
+	// Every this many frames the oldest missile hits or leaves the view and a new one is launched
+	const std::size_t LaunchInterval = 2;
+
+	// Previous EmitterNode: pushes a particle system finder command every frame until its system answered
+	class FinderEmitter : public SceneNode
+	{
+	public:
+		explicit FinderEmitter(Particle::Type type)
+			: SceneNode()
+			, accumulatedTime_(sf::Time::Zero)
+			, type_(type)
+			, particleSystem_(nullptr)
+		{
+		}
+
+	private:
+		virtual void updateCurrent(sf::Time dt, CommandQueue& commands) override
+		{
+			if (particleSystem_)
+			{
+				const sf::Time interval = sf::seconds(1.f) / 30.f;
+
+				accumulatedTime_ += dt;
+				while (accumulatedTime_ > interval)
+				{
+					accumulatedTime_ -= interval;
+					particleSystem_->addParticle(getWorldPosition(), sf::Vector2f());
+				}
+			}
+			else
+			{
+				Command command;
+				command.category = Category::ParticleSystem;
+				command.action = derivedAction<ParticleNode>([this](ParticleNode& container, sf::Time)
+					{
+						if (container.getParticleType() == type_)
+						{
+							particleSystem_ = &container;
+						}
+					});
+
+				commands.push(command);
+			}
+		}
+
+	private:
+		sf::Time accumulatedTime_;
+		Particle::Type type_;
+		ParticleNode* particleSystem_;
+	};
+
+	// Stands in for a missile: flies up, with a smoke and a propellant emitter at its tail
+	class BenchMissile : public SceneNode
+	{
+	public:
+		virtual Category getCategory() const override
+		{
+			return Category::AlliedProjectile;
+		}
+
+	private:
+		virtual void updateCurrent(sf::Time dt, CommandQueue&) override
+		{
+			move(0.f, -200.f * dt.asSeconds());
+		}
+	};
+
+	struct EmitterResult
+	{
+		Benchmark::Samples frames;
+		std::size_t dispatchedCommands;
+		std::size_t visitedNodes;
+	};
+
+	// Keeps MissileCount missiles in flight, replacing the oldest one every LaunchInterval frames
+	template <typename AttachEmitters, typename Emit>
+	EmitterResult runMissiles(AttachEmitters attachEmitters, Emit emit)
+	{
+		// Registries first, they outlive the nodes registered in them
+		TextureHolder textures;
+		CategoryRegistry categories;
+		ParticleRegistry particles;
+		SceneNode root;
+		root.setCategoryRegistry(&categories);
+
+		for (Particle::Type type : { Particle::Propellant, Particle::Smoke })
+		{
+			std::unique_ptr<ParticleNode> system = std::make_unique<ParticleNode>(type, textures);
+			particles.addSystem(*system);
+			root.attachChild(std::move(system));
+		}
+
+		std::vector<SceneNode*> missiles(MissileCount, nullptr);
+		std::size_t launched = 0;
+		auto launch = [&]()
+			{
+				SceneNode*& slot = missiles[launched % MissileCount];
+				if (slot != nullptr)
+				{
+					root.detachChild(*slot);
+				}
+
+				std::unique_ptr<SceneNode> missile = std::make_unique<BenchMissile>();
+				missile->setPosition(static_cast<float>(launched % 640), 5000.f);
+				attachEmitters(*missile, particles);
+				slot = missile.get();
+				root.attachChild(std::move(missile));
+				++launched;
+			};
+
+		// All missiles are in the air at once before measuring
+		for (std::size_t i = 0; i < MissileCount; ++i)
+		{
+			launch();
+		}
+
+		EmitterResult result{ Benchmark::Samples(), 0, 0 };
+		CommandQueue commands;
+		for (std::size_t frame = 0; frame < FrameCount; ++frame)
+		{
+			result.frames.add(Benchmark::measure([&]()
+				{
+					root.update(FrameTime, commands);
+
+					Command command;
+					while (commands.pop(command))
+					{
+						categories.dispatch(command, FrameTime);
+						++result.dispatchedCommands;
+					}
+
+					emit(particles);
+				}));
+
+			// After the update, so every missile is updated once before it is replaced
+			if (frame % LaunchInterval == 0)
+			{
+				launch();
+			}
+		}
+
+		result.visitedNodes = categories.getVisitedCount();
+		return result;
+	}
+
+	void printResult(const std::string& name, const EmitterResult& result)
+	{
+		Benchmark::printRow({ name, Benchmark::format(result.frames.mean()), Benchmark::format(result.frames.percentile(0.99)),
+			std::to_string(result.dispatchedCommands), std::to_string(result.visitedNodes) });
+	}
+}
+
+void runEmitterBenchmark()
+{
+	Benchmark::printTitle("Missile trail emitters, " + std::to_string(MissileCount) + " missiles in flight, one launched every "
+		+ std::to_string(LaunchInterval) + " of " + std::to_string(FrameCount) + " frames (microseconds)");
+	Benchmark::printHeader({ "emitters", "mean", "p99", "commands", "nodes visited" });
+
+	EmitterResult finder = runMissiles([](SceneNode& missile, ParticleRegistry&)
+		{
+			missile.attachChild(std::make_unique<FinderEmitter>(Particle::Smoke));
+			missile.attachChild(std::make_unique<FinderEmitter>(Particle::Propellant));
+		},
+		[](ParticleRegistry&) {});
+	printResult("finder commands", finder);
+
+	std::size_t remainingEmitters = 0;
+	EmitterResult registry = runMissiles([](SceneNode& missile, ParticleRegistry& particles)
+		{
+			missile.attachChild(std::make_unique<EmitterNode>(Particle::Smoke, particles, sf::Vector2f(0.f, 1.f)));
+			missile.attachChild(std::make_unique<EmitterNode>(Particle::Propellant, particles, sf::Vector2f(0.f, 1.f)));
+		},
+		[&](ParticleRegistry& particles)
+		{
+			particles.emit(FrameTime);
+			remainingEmitters = particles.getEmitterCount(Particle::Smoke) + particles.getEmitterCount(Particle::Propellant);
+		});
+	printResult("registry", registry);
+
+	// Each launched missile cost two finder commands, one per emitter, each visiting both particle systems
+	const std::size_t launchedMissiles = MissileCount + FrameCount / LaunchInterval;
+	Benchmark::check(finder.dispatchedCommands == 2 * launchedMissiles,
+		"the finder emitters dispatched " + std::to_string(finder.dispatchedCommands) + " commands, two per missile");
+	Benchmark::check(registry.dispatchedCommands == 0 && registry.visitedNodes == 0, "registry emitters dispatch no commands");
+	Benchmark::check(remainingEmitters == 2 * MissileCount, "destroyed missiles unregister their emitters");
+}
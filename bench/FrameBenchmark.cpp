@@ -0,0 +1,128 @@
+#include <vector>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "Aircraft.h"
+#include "Command.h"
+#include "Profiler.h"
+#include "ResourceHolder.h"
+#include "ResourceIdentifiers.h"
+#include "Utility.h"
+#include "World.h"
+
+namespace
+{
+	// Same fixed step as Application::TimePerFrame, enough steps to scroll through the whole level
+	const sf::Time TimePerFrame = sf::seconds(1.f / 60.f);
+	const std::size_t FrameCount = 6000;
+	const unsigned int RandomSeed = 42;
+
+	// Frames the scripted player flies in one direction before turning around
+	const std::size_t WeavePeriod = 90;
+	const std::size_t MissilePeriod = 120;
+
+	struct RunResult
+	{
+		sf::Vector2f playerPosition;
+		int playerHitpoints;
+		std::size_t frames;
+	};
+
+	// Player input for one frame: weave left and right, fire constantly and launch a missile now and then
+	Command createScriptedInput(std::size_t frame)
+	{
+		Command command;
+		command.category = Category::PlayerAircraft;
+		command.action = derivedAction<Aircraft>([frame](Aircraft& aircraft, sf::Time)
+			{
+				float direction = (frame / WeavePeriod) % 2 == 0 ? -1.f : 1.f;
+				aircraft.setVelocity(direction * aircraft.getMaxSpeed(), 0.f);
+				aircraft.fire();
+
+				if (frame % MissilePeriod == 0)
+				{
+					aircraft.launchMissile();
+				}
+			});
+
+		return command;
+	}
+
+	// Plays the level of World::addEnemies() headless, timing each update phase if a profiler is given
+	RunResult runLevel(Profiler* profiler, std::vector<Benchmark::Samples>* phaseSamples, Benchmark::Samples* totalSamples)
+	{
+		seedRandomEngine(RandomSeed);
+
+		FontHolder fonts;
+		World world(fonts);
+		world.setProfiler(profiler);
+
+		// The script keeps flying into enemy fire, the player must survive to cover the whole level
+		Aircraft* player = world.addAircraft(1);
+		player->setHitpoints(1000000);
+
+		RunResult result{};
+		for (std::size_t frame = 0; frame < FrameCount && world.hasAlivePlayer(); ++frame)
+		{
+			if (profiler)
+			{
+				profiler->beginFrame();
+			}
+
+			world.getCommandQueue().push(createScriptedInput(frame));
+			double elapsed = Benchmark::measure([&]()
+				{
+					world.update(TimePerFrame);
+				});
+
+			if (profiler)
+			{
+				// Sections keep their index once recorded, so the samples can be matched by position
+				const std::vector<Profiler::Section>& sections = profiler->getSections();
+				phaseSamples->resize(sections.size());
+				for (std::size_t i = 0; i < sections.size(); ++i)
+				{
+					(*phaseSamples)[i].add(sections[i].value);
+				}
+				totalSamples->add(elapsed);
+			}
+
+			++result.frames;
+		}
+
+		if (Aircraft* aircraft = world.getAircraft(1))
+		{
+			result.playerPosition = aircraft->getPosition();
+			result.playerHitpoints = aircraft->getHitpoints();
+		}
+
+		return result;
+	}
+}
+
+void runFrameBenchmark()
+{
+	Benchmark::printTitle("Headless level, " + std::to_string(FrameCount) + " fixed steps (per update phase, microseconds)");
+
+	Profiler profiler;
+	std::vector<Benchmark::Samples> phaseSamples;
+	Benchmark::Samples totalSamples;
+	RunResult profiled = runLevel(&profiler, &phaseSamples, &totalSamples);
+
+	Benchmark::printHeader({ "phase", "mean", "p99", "max" });
+	const std::vector<Profiler::Section>& sections = profiler.getSections();
+	for (std::size_t i = 0; i < sections.size(); ++i)
+	{
+		const Benchmark::Samples& samples = phaseSamples[i];
+		Benchmark::printRow({ sections[i].name, Benchmark::format(samples.mean()), Benchmark::format(samples.percentile(0.99)),
+			Benchmark::format(samples.max()) });
+	}
+	Benchmark::printRow({ "total", Benchmark::format(totalSamples.mean()), Benchmark::format(totalSamples.percentile(0.99)),
+		Benchmark::format(totalSamples.max()) });
+
+	// Same seed and input must give the same game, otherwise runs are not comparable
+	RunResult repeated = runLevel(nullptr, nullptr, nullptr);
+	Benchmark::check(profiled.frames == FrameCount, "scripted player survives all frames");
+	Benchmark::check(profiled.frames == repeated.frames && profiled.playerPosition == repeated.playerPosition
+		&& profiled.playerHitpoints == repeated.playerHitpoints, "headless runs are deterministic");
+}
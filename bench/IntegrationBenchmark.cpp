@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "Aircraft.h"
+#include "Profiler.h"
+#include "ResourceHolder.h"
+#include "ResourceIdentifiers.h"
+#include "ThreadPool.h"
+#include "Utility.h"
+#include "World.h"
+
+namespace
+{
+	const sf::Time TimePerFrame = sf::seconds(1.f / 60.f);
+	const std::size_t FrameCount = 60;
+	const unsigned int RandomSeed = 42;
+
+	struct IntegrationResult
+	{
+		Benchmark::Samples integrate;
+		Benchmark::Samples total;
+		sf::Vector2f playerPosition;
+		int playerHitpoints;
+	};
+
+	// A swarm of enemies already in view, each flying its pattern and firing, in a headless world
+	IntegrationResult runSwarm(std::size_t enemyCount, ThreadPool* threadPool)
+	{
+		seedRandomEngine(RandomSeed);
+
+		FontHolder fonts;
+		World world(fonts);
+		Profiler profiler;
+		world.setProfiler(&profiler);
+		world.setThreadPool(threadPool);
+
+		Aircraft* player = world.addAircraft(1);
+		player->setHitpoints(1000000);
+
+		for (std::size_t i = 0; i < enemyCount; ++i)
+		{
+			Aircraft::Type type = (i % 2 == 0) ? Aircraft::Raptor : Aircraft::Avenger;
+			world.addEnemy(type, static_cast<float>(i % 31) * 30.f - 450.f, static_cast<float>(i % 97) * 3.f);
+		}
+		world.sortEnemies();
+
+		IntegrationResult result{};
+		for (std::size_t frame = 0; frame < FrameCount; ++frame)
+		{
+			profiler.beginFrame();
+			result.total.add(Benchmark::measure([&]() { world.update(TimePerFrame); }));
+
+			for (const Profiler::Section& section : profiler.getSections())
+			{
+				if (std::string(section.name) == "integrate")
+				{
+					result.integrate.add(section.value);
+				}
+			}
+		}
+
+		if (Aircraft* aircraft = world.getAircraft(1))
+		{
+			result.playerPosition = aircraft->getPosition();
+			result.playerHitpoints = aircraft->getHitpoints();
+		}
+
+		return result;
+	}
+}
+
+void runIntegrationBenchmark()
+{
+	const std::size_t coreCount = std::max(1u, std::thread::hardware_concurrency());
+	Benchmark::printTitle("Integration phase of a headless world, " + std::to_string(FrameCount) + " fixed steps, "
+		+ std::to_string(coreCount) + " cores (microseconds)");
+
+	Benchmark::printHeader({ "enemies", "threads", "integrate mean", "integrate p99", "update mean" });
+
+	for (std::size_t enemyCount : { 1000, 4000, 16000 })
+	{
+		IntegrationResult serial = runSwarm(enemyCount, nullptr);
+		Benchmark::printRow({ std::to_string(enemyCount), "serial", Benchmark::format(serial.integrate.mean()),
+			Benchmark::format(serial.integrate.percentile(0.99)), Benchmark::format(serial.total.mean()) });
+
+		double fastest = serial.integrate.mean();
+		for (std::size_t threadCount = 2; threadCount <= coreCount; threadCount *= 2)
+		{
+			ThreadPool threadPool(threadCount);
+			IntegrationResult parallel = runSwarm(enemyCount, &threadPool);
+			Benchmark::printRow({ std::to_string(enemyCount), std::to_string(threadCount), Benchmark::format(parallel.integrate.mean()),
+				Benchmark::format(parallel.integrate.percentile(0.99)), Benchmark::format(parallel.total.mean()) });
+
+			// Buffered commands are merged in a fixed order, the game must not depend on the thread count
+			Benchmark::check(parallel.playerPosition == serial.playerPosition && parallel.playerHitpoints == serial.playerHitpoints,
+				"parallel integration with " + std::to_string(threadCount) + " threads plays like the serial one, "
+				+ std::to_string(enemyCount) + " enemies");
+
+			fastest = std::min(fastest, parallel.integrate.mean());
+		}
+
+		if (enemyCount == 16000 && coreCount > 1)
+		{
+			Benchmark::check(fastest < serial.integrate.mean(), "integration scales across cores with 16000 enemies");
+		}
+	}
+}
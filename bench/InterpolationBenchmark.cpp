@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "InterpolationBuffer.h"
+#include "NetworkProtocol.h"
+#include "Snapshot.h"
+
+namespace
+{
+	const sf::Time TimePerFrame = sf::seconds(1.f / 60.f);
+	const std::size_t FrameCount = 60 * 60;
+	const unsigned int RandomSeed = 42;
+
+	// One way latency of a server packet: fixed part plus uniform jitter, TCP keeps the order
+	const sf::Time BaseLatency = sf::milliseconds(60);
+	const sf::Time MaxJitter = sf::milliseconds(60);
+
+	// Close to the wrap of the Uint16 sequence number, which the server clock must count through
+	const sf::Uint16 FirstSequence = 65000;
+
+	const sf::Time MaxExtrapolation = sf::milliseconds(250);
+
+	struct ServerState
+	{
+		sf::Uint16 sequence;
+		sf::Vector2f position;
+		sf::Time arrival;
+	};
+
+	struct ErrorResult
+	{
+		Benchmark::Samples error;
+		double jitter;
+	};
+
+	// Remote aircraft weaving sideways while following the scrolling view, time counts from the start of the run
+	sf::Vector2f getTruePosition(sf::Time time)
+	{
+		float seconds = time.asSeconds();
+		return sf::Vector2f(500.f + 200.f * std::sin(1.5f * seconds) + 60.f * std::sin(7.f * seconds), 4600.f - 50.f * seconds);
+	}
+
+	// Snapshots of the whole run with their arrival time on the client clock, which starts at zero
+	std::deque<ServerState> createServerStates()
+	{
+		std::mt19937 randomEngine(RandomSeed);
+		std::uniform_int_distribution<sf::Int64> jitter(0, MaxJitter.asMicroseconds());
+
+		std::deque<ServerState> states;
+		sf::Time lastArrival = sf::Time::Zero;
+		for (std::size_t tick = 0; tick / ServerTickRate < FrameCount * TimePerFrame.asSeconds(); ++tick)
+		{
+			sf::Time sent = sf::seconds(tick / ServerTickRate);
+			sf::Vector2f position = getTruePosition(sent);
+			position.x = Snapshot::dequantize(Snapshot::quantize(position.x));
+			position.y = Snapshot::dequantize(Snapshot::quantize(position.y));
+
+			lastArrival = std::max(lastArrival, sent + BaseLatency + sf::microseconds(jitter(randomEngine)));
+			states.push_back(ServerState{ static_cast<sf::Uint16>(FirstSequence + tick), position, lastArrival });
+		}
+
+		return states;
+	}
+
+	// Plays the client frames; receive(state, localTime) takes an arrived state, display(localTime) returns the drawn position.
+	// The error is measured against where the aircraft really is on the server at that moment.
+	template <typename Receive, typename Display>
+	ErrorResult runClient(std::deque<ServerState> states, Receive receive, Display display)
+	{
+		ErrorResult result{ Benchmark::Samples(), 0.0 };
+		sf::Vector2f lastDisplayed;
+		sf::Vector2f lastTrue;
+		sf::Vector2f lastDisplayedStep;
+		sf::Vector2f lastTrueStep;
+
+		for (std::size_t frame = 0; frame < FrameCount; ++frame)
+		{
+			sf::Time localTime = TimePerFrame * static_cast<float>(frame);
+			while (!states.empty() && states.front().arrival <= localTime)
+			{
+				receive(states.front(), localTime);
+				states.pop_front();
+			}
+
+			sf::Vector2f displayed = display(localTime);
+			sf::Vector2f truth = getTruePosition(localTime);
+
+			// Skip the first second, until the client has seen a few states
+			if (localTime > sf::seconds(1.f))
+			{
+				sf::Vector2f error = displayed - truth;
+				result.error.add(std::hypot(error.x, error.y));
+
+				// Rubber-banding: changes of the frame to frame movement that the real aircraft did not make
+				sf::Vector2f jerk = (displayed - lastDisplayed - lastDisplayedStep) - (truth - lastTrue - lastTrueStep);
+				result.jitter += std::hypot(jerk.x, jerk.y);
+			}
+
+			lastDisplayedStep = displayed - lastDisplayed;
+			lastTrueStep = truth - lastTrue;
+			lastDisplayed = displayed;
+			lastTrue = truth;
+		}
+
+		result.jitter /= result.error.size();
+		return result;
+	}
+
+	// Previous MultiplayerGameState: move 10% toward each state in the frame it arrives
+	ErrorResult runNudge(const std::deque<ServerState>& states)
+	{
+		sf::Vector2f position = getTruePosition(sf::Time::Zero);
+		return runClient(states,
+			[&](const ServerState& state, sf::Time)
+			{
+				position += (state.position - position) * 0.1f;
+			},
+			[&](sf::Time)
+			{
+				return position;
+			});
+	}
+
+	// MultiplayerGameState with InterpolationBuffer, drawn delay behind the estimated server clock
+	ErrorResult runInterpolation(const std::deque<ServerState>& states, sf::Time delay)
+	{
+		InterpolationBuffer buffer;
+		ServerClock clock;
+		return runClient(states,
+			[&](const ServerState& state, sf::Time localTime)
+			{
+				buffer.push(clock.synchronize(state.sequence, localTime), state.position);
+			},
+			[&](sf::Time localTime)
+			{
+				return buffer.isEmpty() ? sf::Vector2f() : buffer.sample(clock.getTime(localTime) - delay, MaxExtrapolation);
+			});
+	}
+
+	void printResult(const std::string& name, const ErrorResult& result)
+	{
+		Benchmark::printRow({ name, Benchmark::format(result.error.mean()), Benchmark::format(result.error.percentile(0.99)),
+			Benchmark::format(result.jitter) });
+	}
+}
+
+void runInterpolationBenchmark()
+{
+	Benchmark::printTitle("Remote aircraft at 20 Hz, " + std::to_string(BaseLatency.asMilliseconds()) + " ms latency + up to "
+		+ std::to_string(MaxJitter.asMilliseconds()) + " ms jitter (pixels)");
+
+	std::deque<ServerState> states = createServerStates();
+
+	Benchmark::printHeader({ "client", "mean error", "p99 error", "jitter/frame" });
+	ErrorResult nudge = runNudge(states);
+	printResult("nudge 10%", nudge);
+
+	ErrorResult interpolated;
+	for (int delay : { 50, 100, 150 })
+	{
+		ErrorResult result = runInterpolation(states, sf::milliseconds(delay));
+		printResult("delay " + std::to_string(delay) + " ms", result);
+
+		if (delay == 100)
+		{
+			interpolated = result;
+		}
+	}
+
+	Benchmark::check(interpolated.error.mean() < nudge.error.mean(), "interpolation is closer to the server position than nudging");
+	Benchmark::check(interpolated.jitter < nudge.jitter, "interpolation moves more smoothly than nudging");
+}
@@ -0,0 +1,62 @@
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+
+
+int main(int argc, char* argv[])
+{
+	std::map<std::string, std::function<void()>> benchmarks;
+	benchmarks["allocations"] = runAllocationBenchmark;
+	benchmarks["broadcast"] = runBroadcastBenchmark;
+	benchmarks["coalescing"] = runCoalescingBenchmark;
+	benchmarks["collision"] = runCollisionBenchmark;
+	benchmarks["commands"] = runCommandBenchmark;
+	benchmarks["drain"] = runDrainBenchmark;
+	benchmarks["effects"] = runEffectBenchmark;
+	benchmarks["emitters"] = runEmitterBenchmark;
+	benchmarks["frame"] = runFrameBenchmark;
+	benchmarks["integration"] = runIntegrationBenchmark;
+	benchmarks["interpolation"] = runInterpolationBenchmark;
+	benchmarks["particles"] = runParticleBenchmark;
+	benchmarks["projectiles"] = runProjectileBenchmark;
+	benchmarks["relay"] = runRelayBenchmark;
+	benchmarks["rooms"] = runRoomBenchmark;
+	benchmarks["servertick"] = runServerTickBenchmark;
+	benchmarks["snapshot"] = runSnapshotBenchmark;
+	benchmarks["soak"] = runSoakBenchmark;
+	benchmarks["transform"] = runTransformBenchmark;
+	benchmarks["transport"] = runTransportBenchmark;
+
+	// No arguments: run every benchmark, otherwise only the named ones
+	if (argc < 2)
+	{
+		for (const auto& pair : benchmarks)
+		{
+			pair.second();
+		}
+		return Benchmark::hasFailedChecks() ? 1 : 0;
+	}
+
+	for (int i = 1; i < argc; ++i)
+	{
+		auto found = benchmarks.find(argv[i]);
+		if (found == benchmarks.end())
+		{
+			std::cout << "Unknown benchmark: " << argv[i] << "\nAvailable:";
+			for (const auto& pair : benchmarks)
+			{
+				std::cout << ' ' << pair.first;
+			}
+			std::cout << std::endl;
+			return 1;
+		}
+
+		found->second();
+	}
+
+	return Benchmark::hasFailedChecks() ? 1 : 0;
+}
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <deque>
+
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/System/Time.hpp>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "ParticleBuffer.h"
+
+namespace
+{
+	const std::size_t FrameCount = 300;
+	const sf::Time FrameTime = sf::seconds(1.f / 60.f);
+
+	// Like the smoke of a missile trail, emission keeps the particle count steady
+	const sf::Time Lifetime = sf::seconds(1.f);
+	const sf::Color Color(50, 50, 50);
+	const sf::Vector2f Size(19.f, 19.f);
+	const ParticleStyle Style{ Size, Size, Size, Color, sf::Color(Color.r, Color.g, Color.b, 0) };
+
+	sf::Vector2f getPosition(std::size_t index)
+	{
+		return sf::Vector2f(static_cast<float>(index % 1024), static_cast<float>(index % 768));
+	}
+
+	// Previous ParticleNode: a deque of particles, and the vertex array rebuilt by appending every frame
+	class DequeParticles
+	{
+	public:
+		DequeParticles()
+			: particles_()
+			, vertexArray_(sf::Quads)
+		{
+		}
+
+		void add(sf::Vector2f position)
+		{
+			particles_.push_back(Particle{ position, Color, Lifetime });
+		}
+
+		void age(sf::Time dt)
+		{
+			while (!particles_.empty() && particles_.front().lifetime <= sf::Time::Zero)
+			{
+				particles_.pop_front();
+			}
+
+			for (Particle& particle : particles_)
+			{
+				particle.lifetime -= dt;
+			}
+		}
+
+		const sf::VertexArray& computeVertices()
+		{
+			sf::Vector2f half = Size / 2.f;
+
+			vertexArray_.clear();
+			for (const Particle& particle : particles_)
+			{
+				sf::Color color = particle.color;
+				float ratio = particle.lifetime.asSeconds() / Lifetime.asSeconds();
+				color.a = static_cast<sf::Uint8>(255 * std::max(ratio, 0.f));
+
+				sf::Vector2f position = particle.position;
+				vertexArray_.append(sf::Vertex(sf::Vector2f(position.x - half.x, position.y - half.y), color, sf::Vector2f(0.f, 0.f)));
+				vertexArray_.append(sf::Vertex(sf::Vector2f(position.x + half.x, position.y - half.y), color, sf::Vector2f(Size.x, 0.f)));
+				vertexArray_.append(sf::Vertex(sf::Vector2f(position.x + half.x, position.y + half.y), color, sf::Vector2f(Size.x, Size.y)));
+				vertexArray_.append(sf::Vertex(sf::Vector2f(position.x - half.x, position.y + half.y), color, sf::Vector2f(0.f, Size.y)));
+			}
+
+			return vertexArray_;
+		}
+
+	private:
+		struct Particle
+		{
+			sf::Vector2f position;
+			sf::Color color;
+			sf::Time lifetime;
+		};
+
+	private:
+		std::deque<Particle> particles_;
+		sf::VertexArray vertexArray_;
+	};
+
+	struct ParticleResult
+	{
+		Benchmark::Samples frames;
+		std::size_t allocations;
+		std::size_t vertexCount;
+	};
+
+	// Emits enough particles per frame to keep particleCount alive, then times emission, aging and vertex building
+	template <typename Frame>
+	ParticleResult runFrames(std::size_t particleCount, Frame frame)
+	{
+		const std::size_t perFrame = particleCount * static_cast<std::size_t>(FrameTime.asMicroseconds()) / Lifetime.asMicroseconds();
+		ParticleResult result{ Benchmark::Samples(), 0, 0 };
+
+		// Warm up to the steady state count first
+		std::size_t next = 0;
+		for (std::size_t i = 0; i < FrameCount; ++i)
+		{
+			result.vertexCount = frame(next, perFrame);
+			next += perFrame;
+		}
+
+		for (std::size_t i = 0; i < FrameCount; ++i)
+		{
+			// Counted around the frame only, the samples allocate too
+			std::size_t allocations = Benchmark::getAllocationCount();
+			double elapsed = Benchmark::measure([&]() { result.vertexCount = frame(next, perFrame); });
+			result.allocations += Benchmark::getAllocationCount() - allocations;
+			result.frames.add(elapsed);
+			next += perFrame;
+		}
+
+		return result;
+	}
+
+	void printResult(std::size_t particleCount, const std::string& name, const ParticleResult& result)
+	{
+		Benchmark::printRow({ std::to_string(particleCount), name, Benchmark::format(result.frames.mean()),
+			Benchmark::format(result.frames.percentile(0.99)), Benchmark::format(static_cast<double>(result.allocations) / FrameCount) });
+	}
+}
+
+void runParticleBenchmark()
+{
+	Benchmark::printTitle("Particle update and vertex build per frame (microseconds)");
+	Benchmark::printHeader({ "particles", "storage", "mean", "p99", "allocs/frame" });
+
+	for (std::size_t particleCount : { 10000, 100000 })
+	{
+		DequeParticles deque;
+		ParticleResult dequeResult = runFrames(particleCount, [&](std::size_t first, std::size_t count)
+			{
+				for (std::size_t i = first; i < first + count; ++i)
+				{
+					deque.add(getPosition(i));
+				}
+				deque.age(FrameTime);
+				return deque.computeVertices().getVertexCount();
+			});
+		printResult(particleCount, "deque", dequeResult);
+
+		// Some headroom over the steady state count, like the capacities in the particle table
+		ParticleBuffer buffer(particleCount + particleCount / 4, Lifetime.asSeconds());
+		sf::VertexArray vertexArray(sf::Quads, buffer.getCapacity() * 4);
+		ParticleResult ringResult = runFrames(particleCount, [&](std::size_t first, std::size_t count)
+			{
+				for (std::size_t i = first; i < first + count; ++i)
+				{
+					buffer.add(getPosition(i), sf::Vector2f());
+				}
+				buffer.age(FrameTime.asSeconds());
+
+				vertexArray.resize(buffer.getSize() * 4);
+				buffer.writeVertices(&vertexArray[0], Style);
+				return vertexArray.getVertexCount();
+			});
+		printResult(particleCount, "ring buffer", ringResult);
+
+		// The deque drops expired particles one frame later, drawing them fully transparent in the meantime
+		const std::size_t perFrameVertices = 4 * particleCount * static_cast<std::size_t>(FrameTime.asMicroseconds()) / Lifetime.asMicroseconds();
+		Benchmark::check(ringResult.vertexCount <= dequeResult.vertexCount && ringResult.vertexCount + 2 * perFrameVertices >= dequeResult.vertexCount,
+			"both keep the same particles alive with " + std::to_string(particleCount));
+		Benchmark::check(ringResult.allocations == 0, "the ring buffer does not allocate per frame with " + std::to_string(particleCount));
+		Benchmark::check(ringResult.frames.mean() < dequeResult.frames.mean(), "the ring buffer is faster with " + std::to_string(particleCount));
+	}
+}
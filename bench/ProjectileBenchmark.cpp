@@ -0,0 +1,124 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "CommandQueue.h"
+#include "ParticleRegistry.h"
+#include "Projectile.h"
+#include "ProjectileSystem.h"
+#include "ResourceHolder.h"
+#include "ResourceIdentifiers.h"
+
+namespace
+{
+	const std::size_t BulletsPerFrame = 20;
+	const std::size_t FramesAlive = 100;
+	const std::size_t MeasuredFrames = 1000;
+	const sf::Time FrameTime = sf::seconds(1.f / 60.f);
+	const float BulletSpeed = 300.f;
+
+	sf::Vector2f getSpawnPosition(std::size_t index)
+	{
+		return sf::Vector2f(static_cast<float>(index % 640), 0.f);
+	}
+
+	// Bounds left by a bullet after FramesAlive frames of flight
+	sf::FloatRect getFlightBounds()
+	{
+		return sf::FloatRect(-10.f, -10.f, 660.f, BulletSpeed * FrameTime.asSeconds() * FramesAlive);
+	}
+
+	// Time one frame of firing, integration and removal; prints time and allocations per frame
+	template <typename Frame>
+	double printScenario(const std::string& name, Frame frame)
+	{
+		// Reach the steady state bullet count first
+		for (std::size_t i = 0; i < 2 * FramesAlive; ++i)
+		{
+			frame();
+		}
+
+		// Counted over frames that record nothing, the growing samples would allocate as well
+		std::size_t allocations = Benchmark::getAllocationCount();
+		for (std::size_t i = 0; i < MeasuredFrames; ++i)
+		{
+			frame();
+		}
+		double allocationsPerFrame = static_cast<double>(Benchmark::getAllocationCount() - allocations) / MeasuredFrames;
+
+		Benchmark::Samples samples;
+		for (std::size_t i = 0; i < MeasuredFrames; ++i)
+		{
+			samples.add(Benchmark::measure(frame));
+		}
+
+		Benchmark::printRow({ name, Benchmark::format(samples.mean()), Benchmark::format(samples.percentile(0.99)),
+			Benchmark::format(allocationsPerFrame) });
+
+		return allocationsPerFrame;
+	}
+}
+
+void runProjectileBenchmark()
+{
+	Benchmark::printTitle("Bullets, " + std::to_string(BulletsPerFrame * FramesAlive) + " alive (per frame, microseconds)");
+
+	TextureHolder textures;
+	try
+	{
+		textures.load(Textures::Entities, "Media/Textures/Entities.png");
+	}
+	catch (std::runtime_error& e)
+	{
+		std::cout << "Skipped: " << e.what() << std::endl;
+		return;
+	}
+
+	Benchmark::printHeader({ "method", "mean", "p99", "allocs/frame" });
+	CommandQueue commands;
+	ParticleRegistry particles;
+
+	// Previous implementation: one Projectile scene node per bullet
+	SceneNode layer;
+	std::vector<Projectile*> ring(BulletsPerFrame * FramesAlive, nullptr);
+	std::size_t next = 0;
+	printScenario("scene nodes", [&]()
+		{
+			for (std::size_t i = 0; i < BulletsPerFrame; ++i, ++next)
+			{
+				// Bullets leave the screen in firing order, the oldest one is out of view by now
+				Projectile*& slot = ring[next % ring.size()];
+				if (slot != nullptr)
+				{
+					slot->destroy();
+				}
+
+				std::unique_ptr<Projectile> projectile = std::make_unique<Projectile>(Projectile::AlliedBullet, textures, particles);
+				projectile->setPosition(getSpawnPosition(next));
+				projectile->setVelocity(0.f, BulletSpeed);
+				slot = projectile.get();
+				layer.attachChild(std::move(projectile));
+			}
+
+			layer.removeWrecks();
+			layer.update(FrameTime, commands);
+			layer.integrate(FrameTime, commands);
+		});
+
+	ProjectileSystem system(textures);
+	next = 0;
+	double systemAllocations = printScenario("projectile system", [&]()
+		{
+			for (std::size_t i = 0; i < BulletsPerFrame; ++i, ++next)
+			{
+				system.spawn(Projectile::AlliedBullet, getSpawnPosition(next), sf::Vector2f(0.f, BulletSpeed));
+			}
+
+			system.removeOutside(getFlightBounds());
+			system.update(FrameTime, commands);
+			system.integrate(FrameTime, commands);
+		});
+
+	Benchmark::check(systemAllocations == 0.0, "no heap allocation per steady-state frame in ProjectileSystem");
+}
@@ -0,0 +1,108 @@
+#include <iostream>
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/SocketSelector.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "GameServer.h"
+#include "NetworkProtocol.h"
+
+namespace
+{
+	const std::size_t RelayCount = 200;
+	const sf::Time ReceiveTimeout = sf::seconds(1.f);
+	const sf::Time SendInterval = sf::milliseconds(5);
+
+	// Receives packets until one of the given type arrives, false if none came within ReceiveTimeout
+	bool receiveUntil(sf::TcpSocket& socket, sf::SocketSelector& selector, ServerPacketType type)
+	{
+		sf::Packet packet;
+		while (selector.wait(ReceiveTimeout))
+		{
+			if (socket.receive(packet) != sf::Socket::Done)
+			{
+				return false;
+			}
+
+			sf::Int32 packetType;
+			packet >> packetType;
+			if (static_cast<ServerPacketType>(packetType) == type)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool connectClient(sf::TcpSocket& socket, sf::SocketSelector& selector)
+	{
+		if (socket.connect(sf::IpAddress::LocalHost, ServerPort, ReceiveTimeout) != sf::Socket::Done)
+		{
+			return false;
+		}
+
+		// The server has accepted the client once it sent the spawn order
+		selector.add(socket);
+		return receiveUntil(socket, selector, ServerPacketType::SpawnSelf);
+	}
+}
+
+void runRelayBenchmark()
+{
+	Benchmark::printTitle("PlayerRealtimeChange relay over loopback, " + std::to_string(RelayCount) + " packets (microseconds)");
+
+	GameServer server(sf::Vector2f(1024.f, 768.f));
+
+	sf::TcpSocket sender;
+	sf::TcpSocket receiver;
+	sf::SocketSelector senderSelector;
+	sf::SocketSelector receiverSelector;
+	if (!connectClient(sender, senderSelector) || !connectClient(receiver, receiverSelector))
+	{
+		std::cout << "Skipped: could not connect to the local server on port " << ServerPort << std::endl;
+		return;
+	}
+
+	// Time from the sender's send() until the other client has the relayed packet
+	Benchmark::Samples samples;
+	bool isActionEnabled = false;
+	for (std::size_t i = 0; i < RelayCount; ++i)
+	{
+		isActionEnabled = !isActionEnabled;
+
+		sf::Packet packet;
+		packet << static_cast<sf::Int32>(ClientPacketType::PlayerRealtimeChange) << sf::Int32(1) << sf::Int32(0) << isActionEnabled;
+
+		bool isRelayed = false;
+		samples.add(Benchmark::measure([&]()
+			{
+				sender.send(packet);
+				isRelayed = receiveUntil(receiver, receiverSelector, ServerPacketType::PlayerRealtimeChange);
+			}));
+
+		if (!isRelayed)
+		{
+			Benchmark::check(false, "every PlayerRealtimeChange is relayed within " + Benchmark::format(ReceiveTimeout.asSeconds()) + " s");
+			return;
+		}
+
+		sf::sleep(SendInterval);
+	}
+
+	Benchmark::printHeader({ "mean", "p50", "p99", "max" });
+	Benchmark::printRow({ Benchmark::format(samples.mean()), Benchmark::format(samples.percentile(0.5)),
+		Benchmark::format(samples.percentile(0.99)), Benchmark::format(samples.max()) });
+
+	// A server sleeping between polls shows up as tens of milliseconds here
+	Benchmark::check(samples.percentile(0.5) < 5000.0, "median relay latency below 5 ms");
+
+	sf::Packet quit;
+	quit << static_cast<sf::Int32>(ClientPacketType::Quit);
+	sender.send(quit);
+	receiver.send(quit);
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "Bot.h"
+#include "GameServer.h"
+#include "NetworkProtocol.h"
+
+namespace
+{
+	const std::size_t MaxRoomCount = 16;
+	const sf::Time RunDuration = sf::seconds(5.f);
+
+	const sf::Time FrameTime = sf::seconds(1.f / 60.f);
+	const sf::Time TurnInterval = sf::milliseconds(700);
+
+	struct RoomResult
+	{
+		bool isConnected;
+		double meanStep;
+		double meanTickDelay;
+		double maxTickDelay;
+	};
+
+	// Fills roomCount rooms with bots and lets them play, tick delays are averaged over the rooms
+	RoomResult runRooms(std::size_t roomCount)
+	{
+		RoomResult result{ false, 0.0, 0.0, 0.0 };
+		GameServer server(sf::Vector2f(1024.f, 768.f), roomCount);
+
+		std::vector<std::unique_ptr<Bot>> bots;
+		for (std::size_t i = 0; i < roomCount * GameServer::MaxPlayersPerRoom; ++i)
+		{
+			bots.push_back(std::make_unique<Bot>());
+			bots.back()->isMovingLeft = i % 2 == 0;
+			if (!bots.back()->connect())
+			{
+				return result;
+			}
+			bots.back()->start();
+		}
+
+		std::vector<GameRoom::Statistics> before = server.getRoomStatistics();
+
+		sf::Clock runClock;
+		sf::Time lastTurn = sf::Time::Zero;
+		while (runClock.getElapsedTime() < RunDuration)
+		{
+			sf::Time now = runClock.getElapsedTime();
+			bool isTurning = now - lastTurn >= TurnInterval;
+			if (isTurning)
+			{
+				lastTurn = now;
+			}
+
+			for (const auto& bot : bots)
+			{
+				bot->receiveAll(now);
+				if (isTurning)
+				{
+					bot->turn();
+				}
+			}
+
+			sf::sleep(FrameTime);
+		}
+
+		std::vector<GameRoom::Statistics> after = server.getRoomStatistics();
+		for (const auto& bot : bots)
+		{
+			bot->quit();
+		}
+
+		// No bot leaves during the run, so the rooms keep their order
+		if (before.size() != roomCount || after.size() != roomCount)
+		{
+			return result;
+		}
+
+		result.isConnected = true;
+		for (std::size_t i = 0; i < roomCount; ++i)
+		{
+			std::size_t steps = std::max<std::size_t>(1, after[i].steps.count - before[i].steps.count);
+			std::size_t ticks = std::max<std::size_t>(1, after[i].tickDelays.count - before[i].tickDelays.count);
+
+			result.meanStep += (after[i].steps.total - before[i].steps.total).asMicroseconds() / static_cast<double>(steps) / roomCount;
+			result.meanTickDelay += (after[i].tickDelays.total - before[i].tickDelays.total).asMicroseconds() / static_cast<double>(ticks) / roomCount;
+			result.maxTickDelay = std::max(result.maxTickDelay, static_cast<double>(after[i].tickDelays.max.asMicroseconds()));
+		}
+
+		return result;
+	}
+}
+
+void runRoomBenchmark()
+{
+	Benchmark::printTitle("Rooms of " + std::to_string(GameServer::MaxPlayersPerRoom) + " loopback bots, "
+		+ std::to_string(std::max(1u, std::thread::hardware_concurrency())) + " cores (microseconds)");
+
+	Benchmark::printHeader({ "rooms", "step mean", "tick delay mean", "tick delay max" });
+
+	RoomResult largest{ false, 0.0, 0.0, 0.0 };
+	for (std::size_t roomCount = 1; roomCount <= MaxRoomCount; roomCount *= 2)
+	{
+		RoomResult result = runRooms(roomCount);
+		if (!result.isConnected)
+		{
+			std::cout << "Skipped: could not fill " << roomCount << " rooms on port " << ServerPort << std::endl;
+			return;
+		}
+
+		Benchmark::printRow({ std::to_string(roomCount), Benchmark::format(result.meanStep), Benchmark::format(result.meanTickDelay),
+			Benchmark::format(result.maxTickDelay) });
+		largest = result;
+	}
+
+	// Ticks are due every 50 ms; once they are late by a whole interval on average the server cannot keep up
+	Benchmark::check(largest.meanTickDelay < 50000.0, "rooms are ticked within one tick interval at " + std::to_string(MaxRoomCount) + " rooms");
+}
@@ -0,0 +1,257 @@
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "AircraftSlots.h"
+#include "Benchmark.h"
+#include "Benchmarks.h"
+
+namespace
+{
+	const std::size_t TickCount = 200;
+	const std::size_t ActionCount = 5;
+
+	// Every this many ticks one aircraft in a hundred is destroyed and a new one joins
+	const std::size_t ChurnInterval = 10;
+
+	// Previous GameRoom bookkeeping: one map node per aircraft, and a map of action flags per player
+	struct MapAircraft
+	{
+		sf::Vector2f position;
+		sf::Int32 hitpoints;
+		sf::Int32 missileAmmo;
+	};
+
+	struct MapRoom
+	{
+		std::map<sf::Int32, MapAircraft> aircraftInfo;
+		std::map<sf::Int32, std::unique_ptr<std::map<std::size_t, bool>>> players;
+	};
+
+	struct SlotRoom
+	{
+		AircraftSlots aircraft;
+		std::vector<sf::Uint8> realtimeActions;
+	};
+
+	// Stands in for the state the world simulated for an aircraft this tick
+	sf::Vector2f simulatedPosition(sf::Int32 identifier, std::size_t tick)
+	{
+		return sf::Vector2f(static_cast<float>(identifier % 640), static_cast<float>(5000 - static_cast<sf::Int32>(tick) - identifier % 480));
+	}
+
+	bool isOfInterest(sf::Vector2f position, std::size_t tick)
+	{
+		float top = 5000.f - static_cast<float>(tick) - 680.f;
+		return position.y >= top && position.y <= top + 768.f + 400.f;
+	}
+
+	bool isDestroyed(sf::Int32 identifier, std::size_t tick)
+	{
+		return tick % ChurnInterval == 0 && identifier % 100 == static_cast<sf::Int32>(tick / ChurnInterval % 100);
+	}
+
+	void addAircraft(MapRoom& room, sf::Int32 identifier)
+	{
+		room.aircraftInfo[identifier] = MapAircraft{ sf::Vector2f(), 100, 2 };
+		room.players[identifier].reset(new std::map<std::size_t, bool>());
+	}
+
+	void addAircraft(SlotRoom& room, sf::Int32 identifier)
+	{
+		AircraftSlots::Handle handle = room.aircraft.add(identifier);
+		room.aircraft.get(handle).hitpoints = 100;
+		room.aircraft.get(handle).missileAmmo = 2;
+		if (handle >= room.realtimeActions.size())
+		{
+			room.realtimeActions.resize(handle + 1);
+		}
+		room.realtimeActions[handle] = 0;
+	}
+
+	// One tick of GameRoom bookkeeping: relayed input, read back, mission check, removal, state broadcast.
+	// Returns a checksum so nothing is optimized away.
+	std::size_t tick(MapRoom& room, std::size_t tick, sf::Int32& identifierCounter, std::vector<float>& broadcast)
+	{
+		std::size_t checksum = 0;
+
+		// A realtime change arrives for every aircraft
+		for (const auto& pair : room.aircraftInfo)
+		{
+			auto itr = room.players.find(pair.first);
+			if (itr != room.players.end())
+			{
+				(*itr->second)[(tick + pair.first) % ActionCount] = tick % 2 == 0;
+			}
+		}
+
+		for (const auto& pair : room.players)
+		{
+			for (const auto& action : *pair.second)
+			{
+				checksum += action.second ? action.first : 0;
+			}
+		}
+
+		for (auto& pair : room.aircraftInfo)
+		{
+			pair.second.position = simulatedPosition(pair.first, tick);
+			pair.second.hitpoints = isDestroyed(pair.first, tick) ? 0 : 100;
+		}
+
+		bool allAircraftDone = true;
+		for (const auto& pair : room.aircraftInfo)
+		{
+			if (pair.second.position.y > 0.f)
+			{
+				allAircraftDone = false;
+				break;
+			}
+		}
+		checksum += allAircraftDone ? 1 : 0;
+
+		std::size_t removed = 0;
+		for (auto it = room.aircraftInfo.begin(); it != room.aircraftInfo.end();)
+		{
+			if (it->second.hitpoints <= 0)
+			{
+				room.players.erase(it->first);
+				room.aircraftInfo.erase(it++);
+				++removed;
+			}
+			else
+			{
+				++it;
+			}
+		}
+		for (std::size_t i = 0; i < removed; ++i)
+		{
+			addAircraft(room, identifierCounter++);
+		}
+
+		broadcast.clear();
+		for (const auto& pair : room.aircraftInfo)
+		{
+			if (isOfInterest(pair.second.position, tick))
+			{
+				broadcast.push_back(static_cast<float>(pair.first));
+				broadcast.push_back(pair.second.position.x);
+				broadcast.push_back(pair.second.position.y);
+			}
+		}
+
+		return checksum + broadcast.size();
+	}
+
+	std::size_t tick(SlotRoom& room, std::size_t tick, sf::Int32& identifierCounter, std::vector<float>& broadcast)
+	{
+		std::size_t checksum = 0;
+
+		// Incoming packets still name aircraft by network identifier
+		room.aircraft.forEach([&](AircraftSlots::Handle, const AircraftSlots::Aircraft& info)
+		{
+			AircraftSlots::Handle handle = room.aircraft.find(info.identifier);
+			sf::Uint8 bit = static_cast<sf::Uint8>(1 << (tick + info.identifier) % ActionCount);
+			room.realtimeActions[handle] = tick % 2 == 0 ? room.realtimeActions[handle] | bit : room.realtimeActions[handle] & ~bit;
+		});
+
+		room.aircraft.forEach([&](AircraftSlots::Handle handle, const AircraftSlots::Aircraft&)
+		{
+			for (std::size_t action = 0; action < ActionCount; ++action)
+			{
+				checksum += (room.realtimeActions[handle] & (1 << action)) != 0 ? action : 0;
+			}
+		});
+
+		room.aircraft.forEach([&](AircraftSlots::Handle, AircraftSlots::Aircraft& info)
+		{
+			info.position = simulatedPosition(info.identifier, tick);
+			info.hitpoints = isDestroyed(info.identifier, tick) ? 0 : 100;
+		});
+
+		bool allAircraftDone = true;
+		room.aircraft.forEach([&](AircraftSlots::Handle, const AircraftSlots::Aircraft& info)
+		{
+			allAircraftDone = allAircraftDone && info.position.y <= 0.f;
+		});
+		checksum += allAircraftDone ? 1 : 0;
+
+		std::size_t removed = 0;
+		room.aircraft.forEach([&](AircraftSlots::Handle handle, const AircraftSlots::Aircraft& info)
+		{
+			if (info.hitpoints <= 0)
+			{
+				room.aircraft.remove(handle);
+				++removed;
+			}
+		});
+		for (std::size_t i = 0; i < removed; ++i)
+		{
+			addAircraft(room, identifierCounter++);
+		}
+
+		broadcast.clear();
+		room.aircraft.forEach([&](AircraftSlots::Handle, const AircraftSlots::Aircraft& info)
+		{
+			if (isOfInterest(info.position, tick))
+			{
+				broadcast.push_back(static_cast<float>(info.identifier));
+				broadcast.push_back(info.position.x);
+				broadcast.push_back(info.position.y);
+			}
+		});
+
+		return checksum + broadcast.size();
+	}
+
+	struct TickResult
+	{
+		Benchmark::Samples ticks;
+		std::size_t checksum;
+	};
+
+	template <typename Room>
+	TickResult runTicks(Room& room, std::size_t aircraftCount)
+	{
+		TickResult result{ Benchmark::Samples(), 0 };
+		sf::Int32 identifierCounter = 0;
+		std::vector<float> broadcast;
+
+		for (std::size_t i = 0; i < aircraftCount; ++i)
+		{
+			addAircraft(room, identifierCounter++);
+		}
+
+		for (std::size_t i = 1; i <= TickCount; ++i)
+		{
+			result.ticks.add(Benchmark::measure([&] { result.checksum += tick(room, i, identifierCounter, broadcast); }));
+		}
+
+		return result;
+	}
+}
+
+void runServerTickBenchmark()
+{
+	Benchmark::printTitle("GameRoom aircraft bookkeeping per tick (microseconds)");
+	Benchmark::printHeader({ "aircraft", "map mean", "map p99", "slots mean", "slots p99" });
+
+	for (std::size_t aircraftCount : { 10, 100, 1000 })
+	{
+		MapRoom mapRoom;
+		SlotRoom slotRoom;
+		TickResult map = runTicks(mapRoom, aircraftCount);
+		TickResult slots = runTicks(slotRoom, aircraftCount);
+
+		Benchmark::printRow({ std::to_string(aircraftCount), Benchmark::format(map.ticks.mean()), Benchmark::format(map.ticks.percentile(0.99)),
+			Benchmark::format(slots.ticks.mean()), Benchmark::format(slots.ticks.percentile(0.99)) });
+
+		Benchmark::check(map.checksum == slots.checksum, "both layouts do the same work with " + std::to_string(aircraftCount) + " aircraft");
+		Benchmark::check(slotRoom.realtimeActions.size() == aircraftCount, "destroyed slots are reused with " + std::to_string(aircraftCount) + " aircraft");
+
+		if (aircraftCount == 1000)
+		{
+			Benchmark::check(slots.ticks.mean() < map.ticks.mean(), "the slot array ticks faster than the maps with 1000 aircraft");
+		}
+	}
+}
@@ -0,0 +1,131 @@
+#include <cmath>
+#include <deque>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "NetworkProtocol.h"
+#include "Snapshot.h"
+
+namespace
+{
+	const std::size_t PlayerCount = 10;
+	const std::size_t TickCount = 20 * 60;
+	const float TicksPerSecond = 20.f;
+	const float ScrollSpeed = -50.f;
+
+	// Ticks until the server has a snapshot's acknowledgement, about 100 ms round trip
+	const std::size_t AckLatency = 2;
+
+	// sf::TcpSocket prefixes every packet with its Uint32 size
+	const std::size_t PacketSizeHeader = 4;
+
+	// Every aircraft follows the scrolling view, every other one also weaves sideways
+	sf::Vector2f getPosition(std::size_t player, std::size_t tick)
+	{
+		float time = tick / TicksPerSecond;
+		float x = 100.f + 80.f * player;
+		if (player % 2 == 0)
+		{
+			x += 120.f * std::sin(time + player);
+		}
+
+		return sf::Vector2f(x, 4600.f + ScrollSpeed * time);
+	}
+
+	// Every aircraft takes a hit every few seconds, at its own moment
+	int getHitpoints(std::size_t player, std::size_t tick)
+	{
+		return 100 - 10 * static_cast<int>(((tick + player * 7) / 100) % 10);
+	}
+
+	// Same layout as GameServer::updateClientState() for protocol version 0
+	std::size_t getLegacyPacketSize(std::size_t tick)
+	{
+		sf::Packet packet;
+		packet << static_cast<sf::Int32>(ServerPacketType::UpdateClientState);
+		packet << 5000.f + ScrollSpeed * tick / TicksPerSecond;
+		packet << static_cast<sf::Int32>(PlayerCount);
+
+		for (std::size_t player = 0; player < PlayerCount; ++player)
+		{
+			sf::Vector2f position = getPosition(player, tick);
+			packet << static_cast<sf::Int32>(player + 1) << position.x << position.y;
+		}
+
+		return packet.getDataSize() + PacketSizeHeader;
+	}
+}
+
+void runSnapshotBenchmark()
+{
+	Benchmark::printTitle("Client state updates, " + std::to_string(PlayerCount) + " players at 20 Hz (per client)");
+
+	SnapshotHistory serverHistory;
+	SnapshotHistory clientHistory;
+	Snapshot serverSnapshot;
+	Snapshot clientSnapshot;
+	std::deque<sf::Uint16> pendingAcks;
+	bool hasAck = false;
+	sf::Uint16 ackedSequence = 0;
+
+	std::size_t legacyBytes = 0;
+	std::size_t snapshotBytes = 0;
+	bool isDecodedExactly = true;
+
+	for (std::size_t tick = 0; tick < TickCount; ++tick)
+	{
+		legacyBytes += getLegacyPacketSize(tick);
+
+		// Server side, as in GameServer::updateClientState()
+		++serverSnapshot.sequence;
+		serverSnapshot.battleFieldPosition = Snapshot::quantize(5000.f + ScrollSpeed * tick / TicksPerSecond);
+		serverSnapshot.entries.clear();
+		for (std::size_t player = 0; player < PlayerCount; ++player)
+		{
+			serverSnapshot.setAircraft(static_cast<sf::Int32>(player + 1), getPosition(player, tick), getHitpoints(player, tick), 2);
+		}
+		serverHistory.add(serverSnapshot);
+
+		sf::Packet packet;
+		writeServerPacketType(packet, ServerPacketType::Snapshot, ProtocolVersion);
+		serverSnapshot.write(packet, hasAck ? serverHistory.find(ackedSequence) : nullptr);
+		snapshotBytes += packet.getDataSize() + PacketSizeHeader;
+
+		// Client side, as in MultiplayerGameState::handlePacket()
+		readServerPacketType(packet, ProtocolVersion);
+		if (clientSnapshot.read(packet, clientHistory))
+		{
+			clientHistory.add(clientSnapshot);
+			pendingAcks.push_back(clientSnapshot.sequence);
+		}
+
+		isDecodedExactly = isDecodedExactly && clientSnapshot.sequence == serverSnapshot.sequence
+			&& clientSnapshot.battleFieldPosition == serverSnapshot.battleFieldPosition
+			&& clientSnapshot.entries.size() == serverSnapshot.entries.size();
+		for (std::size_t i = 0; isDecodedExactly && i < serverSnapshot.entries.size(); ++i)
+		{
+			const Snapshot::Entry& sent = serverSnapshot.entries[i];
+			const Snapshot::Entry& received = clientSnapshot.entries[i];
+			isDecodedExactly = sent.identifier == received.identifier && sent.x == received.x && sent.y == received.y
+				&& sent.hitpoints == received.hitpoints && sent.missileAmmo == received.missileAmmo;
+		}
+
+		// Acknowledgements reach the server a few ticks later
+		if (pendingAcks.size() > AckLatency)
+		{
+			ackedSequence = pendingAcks.front();
+			hasAck = true;
+			pendingAcks.pop_front();
+		}
+	}
+
+	const float seconds = TickCount / TicksPerSecond;
+	Benchmark::printHeader({ "format", "bytes/packet", "bytes/sec" });
+	Benchmark::printRow({ "full state v0", Benchmark::format(static_cast<double>(legacyBytes) / TickCount),
+		Benchmark::format(legacyBytes / seconds) });
+	Benchmark::printRow({ "snapshot v1", Benchmark::format(static_cast<double>(snapshotBytes) / TickCount),
+		Benchmark::format(snapshotBytes / seconds) });
+
+	Benchmark::check(isDecodedExactly, "client rebuilds every snapshot exactly");
+	Benchmark::check(snapshotBytes < legacyBytes, "delta snapshots are smaller than UpdateClientState");
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "Bot.h"
+#include "GameServer.h"
+#include "NetworkProtocol.h"
+
+namespace
+{
+	const std::size_t BotCount = 10;
+	const sf::Time SoakDuration = sf::seconds(20.f);
+
+	// Bots poll at the client frame rate and turn around now and then
+	const sf::Time FrameTime = sf::seconds(1.f / 60.f);
+	const sf::Time TurnInterval = sf::milliseconds(700);
+
+	double toMicroseconds(sf::Time time)
+	{
+		return static_cast<double>(time.asMicroseconds());
+	}
+
+	double getMean(const GameRoom::Timing& before, const GameRoom::Timing& after)
+	{
+		std::size_t count = after.count - before.count;
+		return count > 0 ? toMicroseconds(after.total - before.total) / count : 0.0;
+	}
+
+	void printTiming(const std::string& name, const GameRoom::Timing& before, const GameRoom::Timing& after)
+	{
+		Benchmark::printRow({ name, std::to_string(after.count - before.count), Benchmark::format(getMean(before, after)),
+			Benchmark::format(toMicroseconds(after.max)) });
+	}
+}
+
+void runSoakBenchmark()
+{
+	Benchmark::printTitle("Server simulation soak, " + std::to_string(BotCount) + " bots for "
+		+ Benchmark::format(SoakDuration.asSeconds(), 0) + " s (microseconds)");
+
+	GameServer server(sf::Vector2f(1024.f, 768.f));
+
+	std::vector<std::unique_ptr<Bot>> bots;
+	for (std::size_t i = 0; i < BotCount; ++i)
+	{
+		bots.push_back(std::make_unique<Bot>());
+		bots.back()->isMovingLeft = i % 2 == 0;
+
+		if (!bots.back()->connect())
+		{
+			std::cout << "Skipped: could not connect bot " << i << " to the local server on port " << ServerPort << std::endl;
+			return;
+		}
+	}
+
+	// Everyone fires all the time, so the server world is full of bullets
+	for (const auto& bot : bots)
+	{
+		bot->start();
+	}
+
+	// All bots share the first room
+	std::vector<GameRoom::Statistics> before = server.getRoomStatistics();
+
+	sf::Clock soakClock;
+	sf::Time lastTurn = sf::Time::Zero;
+	while (soakClock.getElapsedTime() < SoakDuration)
+	{
+		sf::Time now = soakClock.getElapsedTime();
+		bool isTurning = now - lastTurn >= TurnInterval;
+		if (isTurning)
+		{
+			lastTurn = now;
+		}
+
+		for (const auto& bot : bots)
+		{
+			bot->receiveAll(now);
+			if (isTurning)
+			{
+				bot->turn();
+			}
+		}
+
+		sf::sleep(FrameTime);
+	}
+
+	std::vector<GameRoom::Statistics> after = server.getRoomStatistics();
+	if (before.size() != 1 || after.size() != 1)
+	{
+		Benchmark::check(false, "all bots play in one room");
+		return;
+	}
+
+	Benchmark::printHeader({ "server work", "count", "mean", "max" });
+	printTiming("60 Hz step", before[0].steps, after[0].steps);
+	printTiming("20 Hz tick", before[0].ticks, after[0].ticks);
+
+	std::size_t receivedBytes = 0;
+	bool isEveryBotServed = true;
+	for (const auto& bot : bots)
+	{
+		receivedBytes += bot->receivedBytes;
+		isEveryBotServed = isEveryBotServed && soakClock.getElapsedTime() - bot->lastReceiveTime < sf::seconds(1.f);
+	}
+	std::cout << "Received per bot: " << Benchmark::format(receivedBytes / BotCount / SoakDuration.asSeconds()) << " bytes/s" << std::endl;
+
+	// The step is due every 16.7 ms, a server slower than that falls behind the clients
+	std::size_t steps = after[0].steps.count - before[0].steps.count;
+	Benchmark::check(steps > 0 && getMean(before[0].steps, after[0].steps) < 16667.0, "server simulation step fits the 60 Hz budget");
+	Benchmark::check(isEveryBotServed, "every bot still receives server state at the end");
+
+	for (const auto& bot : bots)
+	{
+		bot->quit();
+	}
+}
@@ -0,0 +1,134 @@
+#include <vector>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "SceneNode.h"
+
+namespace
+{
+	const std::size_t GraphDepth = 16;
+	const std::size_t LeafCount = 1000;
+
+	// Typical number of world position lookups per node and frame (bounding rect, distance, guidance...)
+	const std::size_t QueriesPerLeaf = 4;
+
+	struct DeepGraph
+	{
+		SceneNode::Ptr root;
+		std::vector<SceneNode*> chain;
+		std::vector<SceneNode*> leaves;
+	};
+
+	// A chain of GraphDepth nested nodes with all leaves attached to its last node
+	DeepGraph buildGraph()
+	{
+		DeepGraph graph;
+		graph.root.reset(new SceneNode());
+		graph.chain.push_back(graph.root.get());
+
+		for (std::size_t depth = 1; depth < GraphDepth; ++depth)
+		{
+			SceneNode::Ptr node(new SceneNode());
+			node->setPosition(1.f, 2.f);
+			node->setRotation(1.f);
+			graph.chain.push_back(node.get());
+			graph.chain[depth - 1]->attachChild(std::move(node));
+		}
+
+		for (std::size_t i = 0; i < LeafCount; ++i)
+		{
+			SceneNode::Ptr leaf(new SceneNode());
+			leaf->setPosition(static_cast<float>(i), 0.f);
+			graph.leaves.push_back(leaf.get());
+			graph.chain.back()->attachChild(std::move(leaf));
+		}
+
+		return graph;
+	}
+
+	// What getWorldTransform() used to do: multiply the whole parent chain on every call
+	sf::Vector2f uncachedWorldPosition(const std::vector<SceneNode*>& chain, const SceneNode& leaf)
+	{
+		sf::Transform transform = leaf.getTransform();
+		for (auto itr = chain.rbegin(); itr != chain.rend(); ++itr)
+		{
+			transform = (*itr)->getTransform() * transform;
+		}
+
+		return transform * sf::Vector2f();
+	}
+
+	void printResult(const std::string& scenario, const Benchmark::Samples& samples, float checksum)
+	{
+		Benchmark::printRow({ scenario, Benchmark::format(samples.mean()), Benchmark::format(samples.percentile(0.99)),
+			Benchmark::format(samples.max()), Benchmark::format(checksum, 0) });
+	}
+}
+
+void runTransformBenchmark()
+{
+	Benchmark::printTitle("getWorldPosition on a deep graph (per frame, microseconds)");
+	Benchmark::printHeader({ "scenario", "mean", "p99", "max", "checksum" });
+
+	DeepGraph graph = buildGraph();
+	float checksum = 0.f;
+
+	Benchmark::Samples uncached = Benchmark::repeat([&]()
+		{
+			checksum = 0.f;
+			for (std::size_t query = 0; query < QueriesPerLeaf; ++query)
+			{
+				for (SceneNode* leaf : graph.leaves)
+				{
+					checksum += uncachedWorldPosition(graph.chain, *leaf).x;
+				}
+			}
+		});
+	printResult("uncached", uncached, checksum);
+
+	// Leaves move every frame, like entities integrating their velocity
+	Benchmark::Samples leavesMoving = Benchmark::repeat([&]()
+		{
+			checksum = 0.f;
+			for (SceneNode* leaf : graph.leaves)
+			{
+				leaf->move(0.f, 0.f);
+			}
+			for (std::size_t query = 0; query < QueriesPerLeaf; ++query)
+			{
+				for (SceneNode* leaf : graph.leaves)
+				{
+					checksum += leaf->getWorldPosition().x;
+				}
+			}
+		});
+	printResult("leaves moving", leavesMoving, checksum);
+
+	// Worst case: the root moves, every cached transform is invalidated
+	Benchmark::Samples rootMoving = Benchmark::repeat([&]()
+		{
+			checksum = 0.f;
+			graph.root->move(0.f, 0.f);
+			for (std::size_t query = 0; query < QueriesPerLeaf; ++query)
+			{
+				for (SceneNode* leaf : graph.leaves)
+				{
+					checksum += leaf->getWorldPosition().x;
+				}
+			}
+		});
+	printResult("root moving", rootMoving, checksum);
+
+	Benchmark::Samples still = Benchmark::repeat([&]()
+		{
+			checksum = 0.f;
+			for (std::size_t query = 0; query < QueriesPerLeaf; ++query)
+			{
+				for (SceneNode* leaf : graph.leaves)
+				{
+					checksum += leaf->getWorldPosition().x;
+				}
+			}
+		});
+	printResult("nothing moving", still, checksum);
+}
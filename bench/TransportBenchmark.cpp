@@ -0,0 +1,317 @@
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include "Benchmark.h"
+#include "Benchmarks.h"
+#include "GameServer.h"
+#include "NetworkProtocol.h"
+#include "NetworkSimulator.h"
+#include "Snapshot.h"
+
+namespace
+{
+	const sf::Time RunDuration = sf::seconds(10.f);
+	const sf::Time WarmUp = sf::seconds(1.f);
+	const sf::Time ConnectTimeout = sf::seconds(1.f);
+
+	const sf::Time FrameTime = sf::seconds(1.f / 60.f);
+	const sf::Time InputInterval = sf::seconds(1.f / ServerTickRate);
+
+	const sf::Time Latency = sf::milliseconds(50);
+	const sf::Time Jitter = sf::milliseconds(10);
+
+	// Version 1 gets every snapshot over TCP, version 2 over the UDP channel
+	const sf::Uint8 StreamVersion = 1;
+	const sf::Uint8 DatagramVersion = 2;
+
+	// Loopback client that receives snapshots like MultiplayerGameState: everything from the server passes the
+	// simulated link, snapshots are applied in sequence order and acknowledged on the channel they came from
+	class SnapshotClient
+	{
+	public:
+		SnapshotClient(sf::Uint8 protocolVersion, const NetworkSimulator::Settings& settings)
+			: socket_()
+			, udpSocket_()
+			, offeredVersion_(protocolVersion)
+			, protocolVersion_(0)
+			, receivedVersion_(0)
+			, streamLink_(NetworkSimulator::Stream)
+			, datagramLink_(NetworkSimulator::Datagram)
+			, snapshots_()
+			, snapshot_()
+			, receivedSnapshot_()
+			, hasSnapshot_(false)
+			, serverUdpPort_(0)
+			, udpToken_(0)
+			, inputSequence_(0)
+			, lastInputTime_(sf::Time::Zero)
+			, sendTimes_()
+		{
+			streamLink_.setSettings(settings);
+			datagramLink_.setSettings(settings);
+		}
+
+		bool connect()
+		{
+			// The server thread may not be listening yet
+			sf::Clock connectClock;
+			while (socket_.connect(sf::IpAddress::LocalHost, ServerPort, ConnectTimeout) != sf::Socket::Done)
+			{
+				if (connectClock.getElapsedTime() >= ConnectTimeout)
+				{
+					return false;
+				}
+
+				sf::sleep(FrameTime);
+			}
+
+			sf::Packet helloPacket;
+			helloPacket << static_cast<sf::Int32>(ClientPacketType::ProtocolHello) << offeredVersion_;
+			socket_.send(helloPacket);
+			socket_.setBlocking(false);
+			return true;
+		}
+
+		void update(sf::Time now)
+		{
+			sf::Packet packet;
+			while (socket_.receive(packet) == sf::Socket::Done)
+			{
+				recordSendTime(packet, now);
+				streamLink_.push(now, packet);
+			}
+
+			while (streamLink_.pop(now, packet))
+			{
+				handlePacket(packet);
+			}
+
+			if (serverUdpPort_ != 0)
+			{
+				sf::IpAddress sender;
+				unsigned short port;
+				while (udpSocket_.receive(packet, sender, port) == sf::Socket::Done)
+				{
+					if (port == serverUdpPort_)
+					{
+						recordSendTime(packet, now);
+						datagramLink_.push(now, packet);
+					}
+				}
+
+				while (datagramLink_.pop(now, packet))
+				{
+					handleDatagram(packet, now);
+				}
+
+				// The regular input datagram keeps the server on the UDP channel
+				if (now - lastInputTime_ >= InputInterval)
+				{
+					sendInputDatagram(now);
+				}
+			}
+		}
+
+		// How old the applied state is: snapshots leave the loopback server the moment they reach the link
+		bool getStateAge(sf::Time now, sf::Time& age) const
+		{
+			auto sendTime = sendTimes_.find(snapshot_.sequence);
+			if (!hasSnapshot_ || sendTime == sendTimes_.end())
+			{
+				return false;
+			}
+
+			age = now - sendTime->second;
+			return true;
+		}
+
+		void quit()
+		{
+			sf::Packet packet;
+			packet << static_cast<sf::Int32>(ClientPacketType::Quit);
+			socket_.setBlocking(true);
+			socket_.send(packet);
+		}
+
+	private:
+		// Reads the packets as they come off the socket, before the link holds them back. The framing
+		// changes with the ProtocolAccept here already, since TCP keeps the packets in order.
+		void recordSendTime(const sf::Packet& received, sf::Time now)
+		{
+			sf::Packet packet = received;
+			ServerPacketType packetType = readServerPacketType(packet, receivedVersion_);
+			if (packetType == ServerPacketType::ProtocolAccept)
+			{
+				packet >> receivedVersion_;
+			}
+
+			sf::Uint16 sequence;
+			if (packetType == ServerPacketType::Snapshot && Snapshot::peekSequence(packet, sequence))
+			{
+				sendTimes_.emplace(sequence, now);
+			}
+		}
+
+		void handlePacket(sf::Packet& packet)
+		{
+			switch (readServerPacketType(packet, protocolVersion_))
+			{
+			case ServerPacketType::ProtocolAccept:
+				packet >> protocolVersion_;
+				break;
+
+			case ServerPacketType::Snapshot:
+				if (handleSnapshot(packet))
+				{
+					sf::Packet ackPacket;
+					ackPacket << static_cast<sf::Int32>(ClientPacketType::SnapshotAck) << snapshot_.sequence;
+					socket_.send(ackPacket);
+				}
+				break;
+
+			case ServerPacketType::UdpChannel:
+				packet >> serverUdpPort_ >> udpToken_;
+				udpSocket_.setBlocking(false);
+				if (udpSocket_.bind(sf::Socket::AnyPort) != sf::Socket::Done)
+				{
+					serverUdpPort_ = 0;
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		void handleDatagram(sf::Packet& packet, sf::Time now)
+		{
+			if (readServerPacketType(packet, protocolVersion_) == ServerPacketType::Snapshot && handleSnapshot(packet))
+			{
+				sendInputDatagram(now);
+			}
+		}
+
+		bool handleSnapshot(sf::Packet& packet)
+		{
+			sf::Uint16 sequence;
+			if (!Snapshot::peekSequence(packet, sequence)
+				|| (hasSnapshot_ && static_cast<sf::Int16>(sequence - snapshot_.sequence) <= 0)
+				|| !receivedSnapshot_.read(packet, snapshots_))
+			{
+				return false;
+			}
+
+			std::swap(snapshot_, receivedSnapshot_);
+			snapshots_.add(snapshot_);
+			hasSnapshot_ = true;
+			return true;
+		}
+
+		// Without realtime actions: the client only watches and acknowledges
+		void sendInputDatagram(sf::Time now)
+		{
+			sf::Packet datagram;
+			datagram << udpToken_ << ++inputSequence_ << hasSnapshot_ << snapshot_.sequence << static_cast<sf::Uint8>(0);
+			udpSocket_.send(datagram.getData(), datagram.getDataSize(), sf::IpAddress::LocalHost, serverUdpPort_);
+			lastInputTime_ = now;
+		}
+
+	private:
+		sf::TcpSocket socket_;
+		sf::UdpSocket udpSocket_;
+		sf::Uint8 offeredVersion_;
+
+		// Framing of the packets leaving the link, and of the ones just taken off the socket
+		sf::Uint8 protocolVersion_;
+		sf::Uint8 receivedVersion_;
+
+		NetworkSimulator streamLink_;
+		NetworkSimulator datagramLink_;
+
+		SnapshotHistory snapshots_;
+		Snapshot snapshot_;
+		Snapshot receivedSnapshot_;
+		bool hasSnapshot_;
+
+		unsigned short serverUdpPort_;
+		sf::Uint32 udpToken_;
+		sf::Uint16 inputSequence_;
+		sf::Time lastInputTime_;
+
+		std::map<sf::Uint16, sf::Time> sendTimes_;
+	};
+
+	// Age of the applied state sampled every frame, while the client watches a game on a room of the local server
+	bool runLink(sf::Uint8 protocolVersion, float lossRate, Benchmark::Samples& ages)
+	{
+		NetworkSimulator::Settings settings;
+		settings.lossRate = lossRate;
+		settings.latency = Latency;
+		settings.jitter = Jitter;
+
+		GameServer server(sf::Vector2f(1024.f, 768.f));
+		SnapshotClient client(protocolVersion, settings);
+		if (!client.connect())
+		{
+			return false;
+		}
+
+		sf::Clock runClock;
+		while (runClock.getElapsedTime() < RunDuration)
+		{
+			sf::Time now = runClock.getElapsedTime();
+			client.update(now);
+
+			// Skip the first second, until the protocol is negotiated and the link carries its steady load
+			sf::Time age;
+			if (now > WarmUp && client.getStateAge(now, age))
+			{
+				ages.add(static_cast<double>(age.asMicroseconds()) / 1000.0);
+			}
+
+			sf::sleep(FrameTime);
+		}
+
+		client.quit();
+		return ages.size() > 0;
+	}
+}
+
+void runTransportBenchmark()
+{
+	Benchmark::printTitle("Loopback snapshots at " + Benchmark::format(ServerTickRate, 0) + " Hz over " + std::to_string(Latency.asMilliseconds())
+		+ " ms (+" + std::to_string(Jitter.asMilliseconds()) + " ms jitter), age of the applied state per frame (milliseconds)");
+	Benchmark::printHeader({ "transport", "loss", "age mean", "age p99", "age max" });
+
+	double streamP99 = 0.0;
+	double datagramP99 = 0.0;
+	for (float lossRate : { 0.f, 0.01f, 0.05f })
+	{
+		for (sf::Uint8 protocolVersion : { StreamVersion, DatagramVersion })
+		{
+			Benchmark::Samples ages;
+			if (!runLink(protocolVersion, lossRate, ages))
+			{
+				std::cout << "Skipped: no snapshots from the local server on port " << ServerPort << std::endl;
+				return;
+			}
+
+			Benchmark::printRow({ protocolVersion == StreamVersion ? "tcp" : "udp", Benchmark::format(lossRate * 100.f, 0) + "%",
+				Benchmark::format(ages.mean()), Benchmark::format(ages.percentile(0.99)), Benchmark::format(ages.max()) });
+
+			(protocolVersion == StreamVersion ? streamP99 : datagramP99) = ages.percentile(0.99);
+		}
+	}
+
+	// A lost segment holds back every later snapshot on TCP, a lost datagram only costs one tick
+	Benchmark::check(datagramP99 < streamP99, "udp keeps the state fresher than tcp at 5% loss");
+}
@@ -9,6 +9,9 @@
 #include "Projectile.h"
 #include "Animation.h"
 
+class ProjectileSystem;
+class ParticleRegistry;
+
 
 class Aircraft :
     public Entity
@@ -23,7 +26,7 @@ public:
 	};
 
 public:
-	explicit Aircraft(Type type, const TextureHolder& textures, const FontHolder& fonts);
+	explicit Aircraft(Type type, const TextureHolder& textures, const FontHolder& fonts, ParticleRegistry& particles);
 
 	virtual Category getCategory() const;
 	virtual sf::FloatRect getBoundingRect() const;
@@ -46,13 +49,15 @@ public:
 	void setMissileAmmo(int ammo);
 
 private:
-	virtual void drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+	virtual void drawCurrent(SpriteBatch& batch, sf::RenderStates states, float alpha) const;
 	virtual void updateCurrent(sf::Time dt, CommandQueue& commands);
+	virtual void integrateCurrent(sf::Time dt, CommandQueue& commands);
 	void updateMovementPattern(sf::Time dt);
 	void checkPickupDrop(CommandQueue& commands);
 	void checkProjectileLaunch(sf::Time dt, CommandQueue& commands);
 
-	void createBullets(SceneNode& node, const TextureHolder& textures) const;
+	void createBullets(ProjectileSystem& system) const;
+	void CreateBullet(ProjectileSystem& system, Projectile::Type type, float xOffset, float yOffset) const;
 	void CreateProjectile(SceneNode& node, Projectile::Type type, float xOffset, float yOffset, const TextureHolder& textures) const;
 	void CreatePickup(SceneNode& node, const TextureHolder& textures) const;
 
@@ -84,5 +89,6 @@ private:
 	TextNode* missileDisplay_;
 
 	int identifier_;
+	ParticleRegistry& particles_;
 };
 
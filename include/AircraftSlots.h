@@ -0,0 +1,78 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <SFML/Config.hpp>
+#include <SFML/System/Vector2.hpp>
+
+
+// Server side aircraft state in one dense array. Each aircraft is addressed by the compact handle of its slot,
+// slots freed on disconnect or destruction are reused through a free list. Per tick loops walk the array
+// instead of map nodes, the network identifier is only looked up for incoming packets.
+class AircraftSlots
+{
+public:
+	typedef std::size_t Handle;
+
+	static constexpr Handle InvalidHandle = static_cast<Handle>(-1);
+
+	struct Aircraft
+	{
+		sf::Int32 identifier;
+		sf::Vector2f position;
+		sf::Int32 hitpoints;
+		sf::Int32 missileAmmo;
+	};
+
+public:
+	AircraftSlots();
+
+	Handle add(sf::Int32 identifier);
+	void remove(Handle handle);
+	Handle find(sf::Int32 identifier) const;
+
+	Aircraft& get(Handle handle);
+	const Aircraft& get(Handle handle) const;
+
+	bool isUsed(Handle handle) const;
+	std::size_t getSize() const;
+
+	// Calls function(handle, aircraft) for every used slot, in handle order
+	template <typename Function>
+	void forEach(Function&& function);
+
+	template <typename Function>
+	void forEach(Function&& function) const;
+
+private:
+	std::vector<Aircraft> slots_;
+	std::vector<bool> isUsed_;
+	std::vector<Handle> freeHandles_;
+	std::unordered_map<sf::Int32, Handle> handles_;
+};
+
+
+template <typename Function>
+void AircraftSlots::forEach(Function&& function)
+{
+	for (Handle handle = 0; handle < slots_.size(); ++handle)
+	{
+		if (isUsed_[handle])
+		{
+			function(handle, slots_[handle]);
+		}
+	}
+}
+
+template <typename Function>
+void AircraftSlots::forEach(Function&& function) const
+{
+	for (Handle handle = 0; handle < slots_.size(); ++handle)
+	{
+		if (isUsed_[handle])
+		{
+			function(handle, slots_[handle]);
+		}
+	}
+}
@@ -9,6 +9,9 @@
 #include "Player.h"
 #include "SoundPlayer.h"
 #include "MusicPlayer.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include "GraphicsSettings.h"
 
 class Application
 {
@@ -19,9 +22,10 @@ public:
 private:
 	void processInput();
 	void update(sf::Time dt);
-	void render();
+	void render(float alpha);
 
 	void updateStatistics(sf::Time dt);
+	void updateProfilerText();
 	void registerStates();
 
 private:
@@ -35,10 +39,19 @@ private:
 
 	KeyBinding keyBinding1_;
 	KeyBinding keyBinding2_;
+	Profiler profiler_;
+	ThreadPool threadPool_;
+	GraphicsSettings graphicsSettings_;
 	StateStack stateStack_;
 
 	sf::Text statisticsText_;
 	sf::Time statisticsUpdateTime_;
 	std::size_t statisticsNumFrames_;
+	std::size_t statisticsNumDrawCalls_;
+	std::size_t statisticsNumParticleBytes_;
+
+	// F3 toggles the per-phase timings, F4 writes the recent frames as a trace file
+	sf::Text profilerText_;
+	bool isProfilerShown_;
 };
 
@@ -5,9 +5,12 @@
 #include <array>
 
 #include "PostEffect.h"
+#include "GraphicsSettings.h"
 #include "ResourceIdentifiers.h"
 #include "ResourceHolder.h"
 
+class Profiler;
+
 class BloomEffect : public PostEffect
 {
 public:
@@ -15,23 +18,37 @@ public:
 
 	virtual void apply(const sf::RenderTexture& input, sf::RenderTarget& output) override;
 
+	// Off is not drawn by the effect, the world then skips post effects
+	void setQuality(BloomQuality quality);
+	void setHalfRate(bool flag);
+
+	// Times the passes into profiler sections. SFML has no GPU timer queries, so this is the CPU submit time.
+	void setProfiler(Profiler* profiler);
+
 private:
 	typedef std::array<sf::RenderTexture, 2> RenderTextureArray;
 
 private:
 	void prepareTextures(sf::Vector2u size);
 
+	// Renders the blurred bright areas of input, returns the texture holding them
+	const sf::RenderTexture& renderBloom(const sf::RenderTexture& input);
+
 	void filterBright(const sf::RenderTexture& input, sf::RenderTexture& output);
-	void blurMultipass(RenderTextureArray& renderTextures);
-	void blur(const sf::RenderTexture& input, sf::RenderTexture& output, sf::Vector2f offsetFactor);
+	void blur(RenderTextureArray& renderTextures);
+	void blurPass(const sf::RenderTexture& input, sf::RenderTexture& output, sf::Vector2f offsetFactor);
 	void downsample(const sf::RenderTexture& input, sf::RenderTexture& output);
 	void add(const sf::RenderTexture& source, const sf::RenderTexture& bloom, sf::RenderTarget& output);
 
 private:
 	ShaderHolder shaders_;
 
-	sf::RenderTexture brightnessTexture_;
-	RenderTextureArray firstPassTextures_;
-	RenderTextureArray secondPassTextures_;
-};
+	RenderTextureArray firstPassTextures_;		// Half resolution
+	RenderTextureArray secondPassTextures_;		// Quarter resolution
 
+	BloomQuality quality_;
+	bool isHalfRate_;
+	// Holds the last rendered bloom, which a half rate frame may reuse
+	const sf::RenderTexture* bloomTexture_;
+	Profiler* profiler_;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <SFML/Network/Packet.hpp>
+
+#include "NetworkProtocol.h"
+#include "SendBuffer.h"
+
+
+// A server packet serialized once and kept in the wire format of sf::TcpSocket ([Uint32:size] [data]),
+// framed for each protocol version on first use. All recipients of a broadcast share the same bytes.
+class BroadcastPacket
+{
+public:
+	// payload must outlive the broadcast packet
+	BroadcastPacket(ServerPacketType type, const sf::Packet& payload);
+
+	const std::vector<char>& getBytes(sf::Uint8 protocolVersion);
+	void send(SendBuffer& buffer, sf::Uint8 protocolVersion);
+
+private:
+	ServerPacketType type_;
+	const sf::Packet* payload_;
+	std::array<std::vector<char>, ProtocolVersion + 1> bytes_;
+};
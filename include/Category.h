@@ -14,6 +14,7 @@ enum class Category
 	ParticleSystem = 1 << 7,
 	SoundEffect = 1 << 8,
 	Network = 1 << 9,
+	ProjectileSystem = 1 << 10,
 
 	Aircraft = PlayerAircraft | AlliedAircraft | EnemyAircraft,
 	Projectile = AlliedProjectile | EnemyProjectile,
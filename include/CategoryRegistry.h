@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+
+#include "Category.h"
+#include "Command.h"
+
+class SceneNode;
+
+
+// Lists of live scene nodes per category bit, so commands reach their receivers
+// without walking the whole scene graph. Maintained by SceneNode on attach/detach/removeWrecks.
+class CategoryRegistry : private sf::NonCopyable
+{
+public:
+	CategoryRegistry();
+
+	void add(SceneNode& node);
+	void remove(SceneNode& node);
+
+	// Batched removal: nodes are only taken out of the lists on the next compact()
+	void scheduleRemoval(SceneNode& node);
+	void compact();
+
+	void dispatch(const Command& command, sf::Time dt);
+
+	// Nodes tested vs. nodes which executed a command since the last reset
+	std::size_t getVisitedCount() const;
+	std::size_t getMatchedCount() const;
+	void resetCounters();
+
+private:
+	struct Entry
+	{
+		SceneNode* node;
+		unsigned int categoryBits;
+	};
+
+	static const std::size_t CategoryBitCount = 32;
+
+private:
+	std::array<std::vector<Entry>, CategoryBitCount> entries_;
+	std::vector<SceneNode*> pendingRemovals_;
+
+	std::size_t visitedCount_;
+	std::size_t matchedCount_;
+};
+
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include "Category.h"
+#include "SceneNode.h"
+
+
+// Uniform grid broad phase for collision detection. Colliders are inserted once per
+// frame with their world bounding rect, and only colliders sharing a cell whose
+// categories were registered as an interesting pair are tested against each other.
+class CollisionGrid
+{
+public:
+	explicit CollisionGrid(float cellSize = 128.f);
+
+	void addCollisionPair(Category first, Category second);
+	bool isCollidable(Category category) const;
+
+	void clear();
+	void insert(SceneNode& node, const sf::FloatRect& bounds);
+	void computePairs(std::vector<SceneNode::Pair>& collisionPairs);
+
+	// First collider of the given categories intersecting bounds. Uses the cells built by the last computePairs()
+	SceneNode* findFirst(const sf::FloatRect& bounds, Category categories) const;
+
+	std::size_t getColliderCount() const;
+
+private:
+	struct Collider
+	{
+		SceneNode* node;
+		sf::FloatRect bounds;
+		Category category;
+		Category partners;
+	};
+
+	struct CellRange
+	{
+		int left;
+		int top;
+		int right;
+		int bottom;
+	};
+
+private:
+	Category getPartners(Category category) const;
+	CellRange getCellRange(const sf::FloatRect& bounds) const;
+	void buildCells();
+
+private:
+	float cellSize_;
+	std::vector<std::pair<Category, Category>> collisionPairs_;
+
+	std::vector<Collider> colliders_;
+	sf::FloatRect gridBounds_;
+	float cellWidth_;
+	float cellHeight_;
+	int columns_;
+	int rows_;
+
+	// Cell contents stored as one flat array, cellStart_[i] .. cellStart_[i + 1] are the colliders of cell i
+	std::vector<std::size_t> cellStart_;
+	std::vector<std::size_t> cellCursor_;
+	std::vector<std::size_t> cellEntries_;
+};
+
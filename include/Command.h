@@ -1,15 +1,59 @@
 #pragma once
 #include <SFML/System/Time.hpp>
-#include <functional>
 #include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
 
 #include "Category.h"
 
 class SceneNode;
 
+// Type-erased void(SceneNode&, sf::Time) callable, stored inline: constructing, copying and
+// invoking never touch the heap. Captures must fit into BufferSize bytes (checked at compile time).
+class CommandAction
+{
+public:
+	static const std::size_t BufferSize = 32;
+
+public:
+	CommandAction();
+	CommandAction(const CommandAction& other);
+	CommandAction& operator=(const CommandAction& other);
+	~CommandAction();
+
+	template <typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, CommandAction>>>
+	CommandAction(Function fn);
+
+	void operator() (SceneNode& node, sf::Time dt) const;
+	explicit operator bool() const;
+
+private:
+	struct Operations
+	{
+		typedef void (*Invoke)(const void* function, SceneNode& node, sf::Time dt);
+		typedef void (*Copy)(void* destination, const void* source);
+		typedef void (*Destroy)(void* function);
+
+		Invoke invoke;
+		Copy copy;			// nullptr: copy the buffer bytes
+		Destroy destroy;	// nullptr: trivially destructible
+	};
+
+	template <typename Function>
+	static const Operations* getOperations();
+
+	void copyFrom(const CommandAction& other);
+	void reset();
+
+private:
+	alignas(std::max_align_t) unsigned char buffer_[BufferSize];
+	const Operations* operations_;
+};
+
 struct Command
 {
-	typedef std::function<void(SceneNode&, sf::Time)> Action;
+	typedef CommandAction Action;
 
 	Command();
 
@@ -17,6 +61,31 @@ struct Command
 	Category category;
 };
 
+template <typename Function, typename>
+CommandAction::CommandAction(Function fn)
+	: operations_(getOperations<Function>())
+{
+	static_assert(sizeof(Function) <= BufferSize, "CommandAction: captured state too large for the inline buffer");
+	static_assert(alignof(Function) <= alignof(std::max_align_t), "CommandAction: over-aligned captured state");
+
+	new (buffer_) Function(std::move(fn));
+}
+
+template <typename Function>
+const CommandAction::Operations* CommandAction::getOperations()
+{
+	// Trivial captures (pointers, ids, vectors) are copied as raw bytes and need no destructor
+	constexpr bool isTrivial = std::is_trivially_copyable_v<Function> && std::is_trivially_destructible_v<Function>;
+
+	static const Operations operations = {
+		Operations::Invoke([](const void* function, SceneNode& node, sf::Time dt) { (*static_cast<const Function*>(function))(node, dt); }),
+		isTrivial ? nullptr : Operations::Copy([](void* destination, const void* source) { new (destination) Function(*static_cast<const Function*>(source)); }),
+		isTrivial ? nullptr : Operations::Destroy([](void* function) { static_cast<Function*>(function)->~Function(); }),
+	};
+
+	return &operations;
+}
+
 template <typename GameObject, typename Function>
 Command::Action derivedAction(Function fn)
 {
@@ -1,16 +1,26 @@
 #pragma once
 
-#include <queue>
+#include <vector>
 #include "Command.h"
 
+// FIFO of commands in a ring buffer which is reused from frame to frame,
+// it only allocates when a frame queues more commands than ever before
 class CommandQueue
 {
 public:
+	CommandQueue();
+
 	void push(const Command& command);
-	Command pop();
+	bool pop(Command& out);
 	bool isEmpty() const;
+	std::size_t getSize() const;
+
+private:
+	void grow();
 
 private:
-	std::queue<Command> queue_;
+	std::vector<Command> buffer_;
+	std::size_t head_;
+	std::size_t size_;
 };
 
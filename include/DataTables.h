@@ -51,8 +51,20 @@ struct PickupData
 
 struct ParticleData
 {
-	sf::Color color;
 	sf::Time lifetime;
+	// Most particles alive at once, the oldest ones make room beyond that
+	std::size_t capacity;
+	// Particles per second of a continuous emitter, and particles per burst
+	float emissionRate;
+	std::size_t burstCount;
+	// Highest initial speed in pixels per second, and the angle in degrees around the emission direction
+	float speed;
+	float spread;
+	// Size (a scale of the particle texture) and color change linearly from spawn to expiry
+	float startSize;
+	float endSize;
+	sf::Color startColor;
+	sf::Color endColor;
 };
 
 std::vector<AircraftData> initializeAircraftData();
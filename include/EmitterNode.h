@@ -3,21 +3,23 @@
 #include "SceneNode.h"
 #include "Particle.h"
 
-class ParticleNode;
+class ParticleRegistry;
 
+// Emits particles of its type at the rate of the particle table, collected by ParticleRegistry::emit()
 class EmitterNode : public SceneNode
 {
 public:
-	explicit EmitterNode(Particle::Type type);
+	// direction: where the particles fly in local coordinates, it turns with the node
+	EmitterNode(Particle::Type type, ParticleRegistry& particles, sf::Vector2f direction);
+	~EmitterNode();
 
-private:
-	virtual void updateCurrent(sf::Time dt, CommandQueue& commands) override;
-
-	void emitParticles(sf::Time dt);
+	// Number of particles due after dt, to be emitted at the world position
+	std::size_t takeDueParticles(sf::Time dt);
+	sf::Vector2f getEmissionDirection() const;
 
 private:
 	sf::Time accumulatedTime_;
 	Particle::Type type_;
-	ParticleNode* particleSystem_;
+	ParticleRegistry& particles_;
+	sf::Vector2f direction_;
 };
-
@@ -24,7 +24,7 @@ public:
 
 
 protected:
-	virtual void updateCurrent(sf::Time dt, CommandQueue& commands) override;
+	virtual void integrateCurrent(sf::Time dt, CommandQueue& commands) override;
 
 private:
 	sf::Vector2f velocity_;
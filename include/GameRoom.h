@@ -0,0 +1,163 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+#include <SFML/Network/SocketSelector.hpp>
+
+#include "NetworkProtocol.h"
+#include "Snapshot.h"
+#include "World.h"
+#include "Player.h"
+#include "ResourceHolder.h"
+#include "ResourceIdentifiers.h"
+#include "SendBuffer.h"
+#include "AircraftSlots.h"
+
+#include <vector>
+#include <memory>
+
+
+// One match on the GameServer: its peers, aircraft and headless world. The server's lobby assigns
+// accepted peers to rooms, update() is called on a worker thread and only touches the room itself.
+class GameRoom : private sf::NonCopyable
+{
+public:
+	// A RemotePeer refers to one instance of the game, may it be local or from another computer
+	struct RemotePeer
+	{
+		RemotePeer();
+
+		sf::TcpSocket socket;
+		SendBuffer sendBuffer;
+		sf::Time lastPacketTime;
+		std::vector<sf::Int32> aircraftIdentifiers;
+		bool ready;
+		bool timeOut;
+
+		// Negotiated with ProtocolHello, 0 for clients which never sent one
+		sf::Uint8 protocolVersion;
+		bool hasSnapshotAck;
+		sf::Uint16 ackedSnapshot;
+
+		// UDP channel offered to version 2 peers, in use while datagrams keep arriving from udpPort
+		sf::Uint32 udpToken;
+		unsigned short udpPort;
+		sf::Time lastDatagramTime;
+		sf::Uint16 inputSequence;
+	};
+
+	typedef std::unique_ptr<RemotePeer> PeerPtr;
+
+	// Accumulated duration of repeated work in the room
+	struct Timing
+	{
+		Timing();
+		void add(sf::Time duration);
+
+		std::size_t count;
+		sf::Time total;
+		sf::Time max;
+	};
+
+	struct Statistics
+	{
+		std::size_t peerCount;
+		Timing steps;
+		Timing ticks;
+
+		// How long after its due time each tick ran, grows once the workers cannot keep up
+		Timing tickDelays;
+
+		// Messages to the peers against the send calls they were coalesced into
+		SendBuffer::Counters sends;
+	};
+
+public:
+	GameRoom(sf::Vector2f battlefieldSize, std::size_t maxConnectedPlayers);
+
+	// Takes over a freshly accepted peer and spawns its aircraft
+	void addPeer(PeerPtr peer);
+
+	// Handles the packets of the peers flagged ready in selector, then runs the steps and ticks due after dt
+	void update(sf::Time dt, const sf::SocketSelector& selector);
+	sf::Time getTimeUntilUpdate() const;
+
+	void addSocketsTo(sf::SocketSelector& selector);
+	bool isFull() const;
+	bool isEmpty() const;
+	const Statistics& getStatistics() const;
+
+private:
+	typedef std::unique_ptr<Player> PlayerPtr;
+
+private:
+	void step(sf::Time dt);
+	void tick();
+	sf::Time now() const;
+
+	AircraftSlots::Handle addAircraft(sf::Int32 aircraftIdentifier, RemotePeer& peer);
+	void removeAircraft(AircraftSlots::Handle handle);
+	void handleGameActions();
+
+	void handleIncomingPackets(const sf::SocketSelector& selector);
+	void handleIncomingPacket(sf::Packet& packet, RemotePeer& receivingPeer, bool& detectedTimeout);
+	void handleDisconnections();
+
+	void offerUdpChannel(RemotePeer& peer);
+	void handleIncomingDatagrams();
+	void handleIncomingDatagram(sf::Packet& packet, const sf::IpAddress& sender, unsigned short port);
+	void applyRealtimeActions(const RemotePeer& origin, sf::Int32 aircraftIdentifier, sf::Uint8 actions);
+	bool isUsingUdp(const RemotePeer& peer) const;
+
+	void notifyPlayerSpawn(AircraftSlots::Handle handle);
+	void notifyPlayerRealtimeChange(const RemotePeer& origin, sf::Int32 aircraftIdentifier, sf::Int32 action, bool actionEnabled);
+	void notifyPlayerEvent(sf::Int32 aircraftIdentifier, sf::Int32 action);
+
+	void informWorldState(RemotePeer& peer);
+	void broadcastMessage(const std::string& message);
+
+	// Prefix the payload with the packet type in the framing of the peer's protocol version
+	void sendToPeer(RemotePeer& peer, ServerPacketType type, const sf::Packet& payload);
+	void sendToAll(ServerPacketType type, const sf::Packet& payload);
+	void updateClientState();
+
+	// Interest management: state updates only carry aircraft in or near the shared battlefield view
+	bool isOfInterest(sf::Vector2f position) const;
+
+private:
+	sf::Clock clock_;
+	sf::Time clientTimeoutTime_;
+	std::size_t maxConnectedPlayers_;
+
+	sf::Time stepTime_;
+	sf::Time tickTime_;
+
+	float worldHeight_;
+	sf::FloatRect battleFieldRect_;
+	float battleFieldScrollSpeed_;
+
+	// Current aircraft state as simulated by the room's world, players_ is indexed by the same handles
+	AircraftSlots aircraft_;
+
+	// Authoritative simulation, driven by the realtime actions the clients relay through their players
+	FontHolder fonts_;
+	World world_;
+	std::vector<PlayerPtr> players_;
+
+	std::vector<PeerPtr> peers_;
+	sf::Int32 aircraftIdentifierCounter_;
+
+	// Snapshots and realtime input of all UDP peers of the room, not bound if no port was available
+	sf::UdpSocket udpSocket_;
+
+	sf::Time lastSpawnTime_;
+	sf::Time timeForNextSpawn_;
+
+	SnapshotHistory snapshots_;
+	Snapshot snapshot_;
+
+	Statistics statistics_;
+};
@@ -4,90 +4,57 @@
 #include <SFML/System/Thread.hpp>
 #include <SFML/System/Clock.hpp>
 #include <SFML/System/Sleep.hpp>
-#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Mutex.hpp>
 #include <SFML/Network/TcpListener.hpp>
-#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/Network/SocketSelector.hpp>
+
+#include "GameRoom.h"
+#include "ThreadPool.h"
 
 #include <vector>
 #include <memory>
-#include <map>
 
 
+// Lobby of the game: one listener on ServerPort assigns accepted peers to rooms, each an independent
+// match. Rooms are filled in order and updated in parallel on a thread pool with one thread per core.
 class GameServer
 {
 public:
-	explicit GameServer(sf::Vector2f battlefieldSize);
+	static constexpr std::size_t MaxPlayersPerRoom = 10;
+
+public:
+	explicit GameServer(sf::Vector2f battlefieldSize, std::size_t maxRooms = 16);
 	~GameServer();
 
-	void notifyPlayerSpawn(sf::Int32 aircraftIdentifier);
-	void notifyPlayerRealtimeChange(sf::Int32 aircraftIdentifier, sf::Int32 action, bool actionEnabled);
-	void notifyPlayerEvent(sf::Int32 aircraftIdentifier, sf::Int32 action);
+	// Latest statistics of every room, safe to call from other threads
+	std::vector<GameRoom::Statistics> getRoomStatistics() const;
 
 private:
-	// A GameServer RemotePeer refers to one instance of the game, may it be local or from another computer
-	struct RemotePeer
-	{
-		RemotePeer();
-
-		sf::TcpSocket socket;
-		sf::Time lastPacketTime;
-		std::vector<sf::Int32> aircraftIdentifiers;
-		bool ready;
-		bool timeOut;
-	};
-
-	// Structure to store information about current aircraft state
-	struct AircraftInfo
-	{
-		sf::Vector2f position;
-		sf::Int32 hitpoints;
-		sf::Int32 missileAmmo;
-		std::map<sf::Int32, bool> realtimeActions;
-	};
-
-	// Unique pointer to the remote peers
-	typedef std::unique_ptr<RemotePeer> PeerPtr;
-
+	typedef std::unique_ptr<GameRoom> RoomPtr;
 
 private:
 	void setListening(bool enable);
 	void executionThread();
-	void tick();
-	sf::Time now() const;
-
-	void handleIncomingPackets();
-	void handleIncomingPacket(sf::Packet& packet, RemotePeer& receivingPeer, bool& detectedTimeout);
+	void waitForActivity(sf::Time timeout);
 
 	void handleIncomingConnections();
-	void handleDisconnections();
-
-	void informWorldState(sf::TcpSocket& socket);
-	void broadcastMessage(const std::string& message);
-	void sendToAll(sf::Packet& packet);
-	void updateClientState();
+	GameRoom* findOpenRoom();
+	bool hasOpenSlot() const;
+	void updateRooms(sf::Time dt);
 
 private:
 	sf::Thread thread_;
-	sf::Clock clock_;
 	sf::TcpListener listenerSocket_;
 	bool listeningState_;
-	sf::Time clientTimeoutTime_;
-
-	std::size_t maxConnectedPlayers_;
-	std::size_t connectedPlayers_;
+	// Holds the listener while listening and the sockets of all peers, rebuilt after every update
+	sf::SocketSelector selector_;
 
-	float worldHeight_;
-	sf::FloatRect battleFieldRect_;
-	float battleFieldScrollSpeed_;
-
-	std::size_t aircraftCount_;
-	std::map<sf::Int32, AircraftInfo> aircraftInfo_;
-
-	std::vector<PeerPtr> peers_;
-	sf::Int32 aircraftIdentifierCounter_;
+	sf::Vector2f battlefieldSize_;
+	std::size_t maxRooms_;
+	std::vector<RoomPtr> rooms_;
+	ThreadPool threadPool_;
 	bool waitingThreadEnd_;
 
-	sf::Time lastSpawnTime_;
-	sf::Time timeForNextSpawn_;
+	mutable sf::Mutex statisticsMutex_;
+	std::vector<GameRoom::Statistics> roomStatistics_;
 };
-
@@ -0,0 +1,16 @@
+#pragma once
+
+enum class BloomQuality
+{
+	Off,
+	Low,	// One blur level at quarter resolution
+	High,	// Blur levels at half and quarter resolution
+};
+
+// Render options of the settings menu, shared through the state context
+struct GraphicsSettings
+{
+	BloomQuality bloomQuality;
+	// Renders the bloom every second frame and reuses it in between
+	bool isBloomHalfRate;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+
+#include <SFML/Config.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/System/Vector2.hpp>
+
+
+// Timestamped server positions of one remote aircraft in a ring buffer. The client renders the
+// aircraft a little behind the newest state, between two known positions, instead of snapping
+// to whatever arrived last.
+class InterpolationBuffer
+{
+public:
+	// At 20 ticks per second this covers 800 ms, far more than any sensible interpolation delay
+	static constexpr std::size_t Capacity = 16;
+
+public:
+	InterpolationBuffer();
+
+	// States must arrive in time order; older ones are dropped, one with the newest time replaces it
+	void push(sf::Time time, sf::Vector2f position);
+
+	// Interpolates the position at time. Past the newest state, the last velocity is extrapolated
+	// for at most maxExtrapolation; before the oldest, the oldest position is returned.
+	sf::Vector2f sample(sf::Time time, sf::Time maxExtrapolation) const;
+
+	bool isEmpty() const;
+
+private:
+	struct Entry
+	{
+		sf::Time time;
+		sf::Vector2f position;
+	};
+
+	// Index 0 is the oldest entry
+	const Entry& getEntry(std::size_t index) const;
+
+private:
+	std::array<Entry, Capacity> entries_;
+	std::size_t head_;
+	std::size_t size_;
+};
+
+
+// Client estimate of the server clock from the sequence numbers of received snapshots
+class ServerClock
+{
+public:
+	ServerClock();
+
+	// Returns the server time of the snapshot and adjusts the estimate to its arrival at localTime
+	sf::Time synchronize(sf::Uint16 sequence, sf::Time localTime);
+	sf::Time getTime(sf::Time localTime) const;
+
+	bool isSynchronized() const;
+
+private:
+	bool isSynchronized_;
+	sf::Uint16 lastSequence_;
+	sf::Int64 tick_;
+	sf::Time offset_;
+};
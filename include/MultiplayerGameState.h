@@ -3,13 +3,21 @@
 #include <SFML/System/Clock.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/Network/TcpSocket.hpp>
+#include <SFML/Network/UdpSocket.hpp>
 #include <SFML/Network/Packet.hpp>
 
+#include <deque>
+
 #include "State.h"
 #include "World.h"
 #include "Player.h"
 #include "GameServer.h"
 #include "NetworkProtocol.h"
+#include "Snapshot.h"
+#include "PacketQueue.h"
+#include "SendBuffer.h"
+#include "InterpolationBuffer.h"
+#include "NetworkSimulator.h"
 
 
 class MultiplayerGameState : public State
@@ -25,9 +33,27 @@ public:
 
 	void disableAllRealtimeActions();
 
+	// How far behind the server clock remote aircraft are drawn, should cover a tick plus the arrival jitter
+	void setInterpolationDelay(sf::Time delay);
+
+	// Emulates loss and latency on everything received from the server, to try the transports on loopback
+	void setNetworkSimulation(const NetworkSimulator::Settings& settings);
+
 private:
+	void loseConnection();
 	void updateBroadcastMessage(sf::Time elapsedTime);
-	void handlePacket(sf::Int32 packetType, sf::Packet& packet);
+	std::size_t receiveIncomingPackets();
+	std::size_t receiveIncomingDatagrams();
+	void handlePacket(ServerPacketType packetType, sf::Packet& packet);
+	void handleDatagram(sf::Packet& packet);
+	bool handleSnapshot(sf::Packet& packet);
+	bool haveRealtimeActionsChanged() const;
+	void sendInputDatagram();
+	void updateScrollCompensation(float currentWorldPosition);
+	void updateAircraft(sf::Int32 aircraftIdentifier, sf::Vector2f aircraftPosition, sf::Time serverTime);
+	void reconcileLocalAircraft(Aircraft& aircraft, sf::Vector2f serverPosition);
+	void recordPredictedPositions();
+	void interpolateRemoteAircraft();
 
 private:
 	typedef std::unique_ptr<Player> PlayerPtr;
@@ -40,6 +66,8 @@ private:
 	std::map<int, PlayerPtr> players_;
 	std::vector<sf::Int32> localPlayerIdentifiers_;
 	sf::TcpSocket socket_;
+	SendBuffer sendBuffer_;
+	PacketQueue incomingPackets_;
 	bool isConnected_;
 	std::unique_ptr<GameServer> gameServer_;
 	sf::Clock tickClock_;
@@ -60,5 +88,33 @@ private:
 	bool isGameStarted_;
 	sf::Time clientTimeout_;
 	sf::Time timeSinceLastPacket_;
+
+	// Version agreed with the server, received snapshots are the bases of the next deltas.
+	// snapshot_ is the last one applied, receivedSnapshot_ the one being read.
+	sf::Uint8 protocolVersion_;
+	SnapshotHistory snapshots_;
+	Snapshot snapshot_;
+	Snapshot receivedSnapshot_;
+
+	// Received remote aircraft states by server time, networkTime_ is the client clock they are sampled with
+	std::map<sf::Int32, InterpolationBuffer> remoteAircraftStates_;
+	ServerClock serverClock_;
+	sf::Time networkTime_;
+	sf::Time interpolationDelay_;
+
+	// Positions the local aircraft were predicted at over the last steps, the newest last.
+	// The server's state confirms them about a round trip later.
+	std::map<sf::Int32, std::deque<sf::Vector2f>> predictedPositions_;
+
+	// UDP channel offered by the server: snapshots and realtime input bypass the TCP stream once it is open
+	sf::UdpSocket udpSocket_;
+	unsigned short serverUdpPort_;
+	sf::Uint32 udpToken_;
+	sf::Uint16 inputSequence_;
+	bool hasSnapshot_;
+	std::map<sf::Int32, sf::Uint8> sentRealtimeActions_;
+
+	NetworkSimulator streamSimulator_;
+	NetworkSimulator datagramSimulator_;
 };
 
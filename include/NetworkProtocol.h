@@ -2,9 +2,18 @@
 
 #include <SFML/Config.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <SFML/Network/Packet.hpp>
 
 const unsigned short ServerPort = 5000;
 
+// Server state updates per second. Snapshot sequence numbers count these ticks, so they double as the server clock.
+const float ServerTickRate = 20.f;
+
+// Newest protocol version of this build. Version 0 is the original format: Int32 packet types
+// and UpdateClientState. Version 1 adds Uint8 server packet types and delta Snapshot packets.
+// Version 2 offers a UDP channel for snapshots and realtime input next to the TCP connection.
+const sf::Uint8 ProtocolVersion = 2;
+
 // Packets originated in the server
 enum class ServerPacketType
 {
@@ -19,7 +28,10 @@ enum class ServerPacketType
 	SpawnEnemy,
 	SpawnPickup,
 	UpdateClientState,
-	MissionSuccess
+	MissionSuccess,
+	ProtocolAccept,		// format: [Int32:packetType] [Uint8:version], later packets use the accepted version
+	Snapshot,			// format: [Uint8:packetType] [Snapshot], replaces UpdateClientState from version 1
+	UdpChannel,			// format: [Uint8:packetType] [Uint16:port] [Uint32:token], from version 2
 };
 
 // Packets originated in the client
@@ -30,9 +42,44 @@ enum class ClientPacketType
 	RequestCoopPartner,
 	PositionUpdate,
 	GameEvent,
-	Quit
+	Quit,
+	ProtocolHello,		// format: [Int32:packetType] [Uint8:newest version of the client]
+	SnapshotAck,		// format: [Int32:packetType] [Uint16:sequence]
 };
 
+// Datagrams on the UDP channel. Each one carries the full realtime state, so a lost datagram is repaired by the next.
+// Client: [Uint32:token] [Uint16:inputSequence] [bool:hasSnapshotAck] [Uint16:ackedSnapshot]
+//         [Uint8:count] count * ([Int32:aircraftIdentifier] [Uint8:realtimeActions])
+// Server: [Uint8:packetType = Snapshot] [Snapshot] [Uint8:count] count * ([Int32:aircraftIdentifier] [Uint8:realtimeActions])
+// realtimeActions has bit (1 << action) set for every enabled realtime PlayerAction.
+
+// Server packet type header in the framing of the negotiated protocol version
+inline void writeServerPacketType(sf::Packet& packet, ServerPacketType type, sf::Uint8 version)
+{
+	if (version >= 1)
+	{
+		packet << static_cast<sf::Uint8>(type);
+	}
+	else
+	{
+		packet << static_cast<sf::Int32>(type);
+	}
+}
+
+inline ServerPacketType readServerPacketType(sf::Packet& packet, sf::Uint8 version)
+{
+	if (version >= 1)
+	{
+		sf::Uint8 type = 0;
+		packet >> type;
+		return static_cast<ServerPacketType>(type);
+	}
+
+	sf::Int32 type = 0;
+	packet >> type;
+	return static_cast<ServerPacketType>(type);
+}
+
 namespace GameActions
 {
 	enum Type
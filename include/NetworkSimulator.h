@@ -0,0 +1,55 @@
+#pragma once
+
+#include <deque>
+
+#include <SFML/System/Time.hpp>
+#include <SFML/Network/Packet.hpp>
+
+
+// Delay line for received packets that emulates a lossy link, so the transports can be compared on loopback.
+// Datagram mode drops lost packets and lets jitter reorder the rest. Stream mode behaves like TCP: a lost
+// packet arrives after one or more retransmission timeouts and holds back every packet behind it.
+class NetworkSimulator
+{
+public:
+	enum Mode
+	{
+		Datagram,
+		Stream,
+	};
+
+	struct Settings
+	{
+		Settings();
+
+		float lossRate;
+		sf::Time latency;
+		sf::Time jitter;
+	};
+
+public:
+	explicit NetworkSimulator(Mode mode);
+
+	void setSettings(const Settings& settings);
+
+	// A link without loss and latency is not simulated, callers hand their packets on directly
+	bool isActive() const;
+
+	void push(sf::Time now, const sf::Packet& packet);
+	bool pop(sf::Time now, sf::Packet& packet);
+
+private:
+	struct DelayedPacket
+	{
+		sf::Time deliveryTime;
+		sf::Packet packet;
+	};
+
+private:
+	Mode mode_;
+	Settings settings_;
+
+	// Sorted by delivery time
+	std::deque<DelayedPacket> packets_;
+	sf::Time lastDeliveryTime_;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+
+
+// FIFO of received packets in a ring buffer, so a client can read everything its socket has
+// buffered at once and handle it over one or more frames. The packets are reused.
+class PacketQueue
+{
+public:
+	// Upper bound for one receive(), keeps a flooding peer from stalling the frame
+	static constexpr std::size_t MaxPacketsPerReceive = 1024;
+
+public:
+	PacketQueue();
+
+	// Appends every packet ready on the (non-blocking) socket, returns how many were received
+	std::size_t receive(sf::TcpSocket& socket);
+
+	// Appends a packet received elsewhere, e.g. delivered by a NetworkSimulator
+	void push(const sf::Packet& packet);
+
+	sf::Packet& front();
+	void pop();
+
+	bool isEmpty() const;
+	std::size_t getSize() const;
+
+private:
+	void grow();
+
+private:
+	std::vector<sf::Packet> buffer_;
+	std::size_t head_;
+	std::size_t size_;
+};
@@ -1,20 +1,16 @@
 #pragma once
 
-#include <SFML/System/Vector2.hpp>
-#include <SFML/System/Time.hpp>
-#include <SFML/Graphics/Color.hpp>
-
+// Particles themselves are stored by ParticleBuffer, per type
 struct Particle
 {
 	enum Type
 	{
 		Propellant,
 		Smoke,
+		Debris,
+		Spark,
+		EngineTrail,
 		ParticleCount,
 	};
-
-	sf::Vector2f position;
-	sf::Color color;
-	sf::Time lifetime;
 };
 
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/System/Vector2.hpp>
+
+
+// Size in pixels and color of the particles of one type, both change linearly from spawn to expiry
+struct ParticleStyle
+{
+	sf::Vector2f textureSize;
+	sf::Vector2f startSize;
+	sf::Vector2f endSize;
+	sf::Color startColor;
+	sf::Color endColor;
+};
+
+
+// Particles of one type in a fixed capacity ring, kept as structure of arrays. All particles live equally long and
+// are added in time order, so the expired ones are always at the head. A full buffer replaces its oldest particle.
+// Particles keep their spawn position, velocity and time, so aging only advances the clock and a slot does not
+// change after it was written. The current position follows from the age.
+class ParticleBuffer
+{
+public:
+	ParticleBuffer(std::size_t capacity, float lifetime);
+
+	void add(sf::Vector2f position, sf::Vector2f velocity);
+
+	// Advances the clock and drops the particles that expired
+	void age(float seconds);
+
+	std::size_t getSize() const;
+	std::size_t getCapacity() const;
+	float getTime() const;
+	float getLifetime() const;
+
+	// Writes getSize() quads, oldest particle first
+	void writeVertices(sf::Vertex* vertices, const ParticleStyle& style) const;
+
+	// The particles occupy getSize() slots from getHead() on, wrapping at the capacity
+	std::size_t getHead() const;
+
+	// Particles added since construction, the newest ones are the last slots in use
+	std::size_t getAddedCount() const;
+
+	sf::Vector2f getPosition(std::size_t slot) const;
+	sf::Vector2f getVelocity(std::size_t slot) const;
+	float getSpawnTime(std::size_t slot) const;
+
+private:
+	// Calls function(begin, end) for the one or two contiguous index ranges holding the particles, oldest first
+	template <typename Function>
+	void forEachRange(Function&& function) const;
+
+private:
+	std::vector<float> positionsX_;
+	std::vector<float> positionsY_;
+	std::vector<float> velocitiesX_;
+	std::vector<float> velocitiesY_;
+	std::vector<float> spawnTimes_;
+
+	// Scratch space of writeVertices(), one age per slot
+	mutable std::vector<float> ages_;
+
+	std::size_t head_;
+	std::size_t size_;
+	std::size_t addedCount_;
+	float time_;
+	float lifetime_;
+};
+
+
+template <typename Function>
+void ParticleBuffer::forEachRange(Function&& function) const
+{
+	const std::size_t capacity = spawnTimes_.size();
+	const std::size_t end = head_ + size_;
+
+	if (end <= capacity)
+	{
+		function(head_, end);
+	}
+	else
+	{
+		function(head_, capacity);
+		function(std::size_t(0), end - capacity);
+	}
+}
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <memory>
+
 #include <SFML/Graphics/VertexArray.hpp>
-#include <deque>
 
 #include "SceneNode.h"
 #include "Particle.h"
+#include "ParticleBuffer.h"
+#include "ParticleRenderer.h"
 #include "ResourceIdentifiers.h"
 
 
@@ -13,23 +16,34 @@ class ParticleNode : public SceneNode
 public:
 	ParticleNode(Particle::Type type, const TextureHolder& textures);
 	
-	void addParticle(sf::Vector2f position);
+	void addParticle(sf::Vector2f position, sf::Vector2f velocity);
 	Particle::Type getParticleType() const;
+	std::size_t getParticleCount() const;
 	virtual Category getCategory() const override;
 
+	// Particle vertex bytes sent to the graphics card by all nodes since the last reset
+	static std::size_t getUploadedByteCount();
+	static void resetUploadedByteCount();
+
 private:
-	virtual void updateCurrent(sf::Time dt, CommandQueue& commands) override;
-	virtual void drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const override;
+	virtual void integrateCurrent(sf::Time dt, CommandQueue& commands) override;
+	virtual void drawCurrent(SpriteBatch& batch, sf::RenderStates states, float alpha) const override;
 
-	void addVertex(float worldX, float worldY, float texCoordX, float texCoordY, sf::Color color) const;
 	void computeVertices() const;
 
 private:
-	std::deque<Particle> particles_;
-	const sf::Texture& texture_;
+	ParticleBuffer particles_;
+	const sf::Texture* texture_;		// nullptr in a headless world
 	Particle::Type type_;
+	ParticleStyle style_;
 
+	// Vertex buffer path, nullptr where it is not supported or in a headless world
+	std::unique_ptr<ParticleRenderer> renderer_;
+
+	// Vertex array path, rebuilt for the sprite batch every frame
 	mutable sf::VertexArray vertexArray_;
 	mutable bool isNeedsVertexUpdate_;
+
+	static std::size_t uploadedByteCount_;
 };
 
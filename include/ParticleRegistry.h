@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "Particle.h"
+
+class ParticleNode;
+class EmitterNode;
+
+
+// The particle system of each type and the emitters feeding it. Emitters register themselves when they are
+// created instead of searching their system with a command, and emit() lets all emitters and bursts append
+// to their systems in a single pass. Must outlive the scene nodes registered in it.
+//
+// The particles added per step are limited by a budget. Over budget, every emitter and burst gives up the
+// same share of its particles, so effects thin out evenly instead of the frame time spiking.
+class ParticleRegistry : private sf::NonCopyable
+{
+public:
+	static constexpr std::size_t DefaultBudget = 2000;
+
+public:
+	ParticleRegistry();
+
+	void addSystem(ParticleNode& system);
+	ParticleNode* findSystem(Particle::Type type) const;
+
+	void addEmitter(EmitterNode& emitter, Particle::Type type);
+	void removeEmitter(EmitterNode& emitter, Particle::Type type);
+	std::size_t getEmitterCount(Particle::Type type) const;
+
+	// Queues the burst of the particle table for the next emit(), ignored without a system of that type.
+	// A zero direction spreads around the x axis.
+	void burst(Particle::Type type, sf::Vector2f position, sf::Vector2f direction);
+
+	// Emits the particles due after dt for all emitters and queued bursts whose type has a system
+	void emit(sf::Time dt);
+
+	void setBudget(std::size_t particlesPerStep);
+
+	// Particles added and particles left out for the budget in the last emit()
+	std::size_t getEmittedCount() const;
+	std::size_t getSkippedCount() const;
+
+private:
+	struct Entry
+	{
+		ParticleNode* system;
+		std::vector<EmitterNode*> emitters;
+	};
+
+	struct Request
+	{
+		Particle::Type type;
+		sf::Vector2f position;
+		sf::Vector2f direction;
+		std::size_t count;
+	};
+
+private:
+	sf::Vector2f randomVelocity(Particle::Type type, sf::Vector2f direction);
+
+private:
+	std::array<Entry, Particle::ParticleCount> entries_;
+	std::vector<Request> bursts_;
+	std::vector<Request> requests_;
+
+	// Own engine, so effects do not change the game's random sequence
+	std::minstd_rand randomEngine_;
+
+	std::size_t budget_;
+	std::size_t emittedCount_;
+	std::size_t skippedCount_;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+
+namespace sf
+{
+	class Texture;
+}
+
+class ParticleBuffer;
+struct ParticleStyle;
+
+
+// Mirrors a ParticleBuffer in a streamed vertex buffer, slot for slot. A slot does not change after it was
+// written, so each frame only the particles added since the last update are uploaded. A shader moves, sizes and
+// colors each particle by its age. SFML vertices have no custom attributes: the position is the spawn position,
+// the texture coordinates carry the quad corner and spawn time, and the color bytes carry the velocity.
+class ParticleRenderer : public sf::Drawable, private sf::NonCopyable
+{
+public:
+	ParticleRenderer(const ParticleBuffer& particles, const sf::Texture& texture, const ParticleStyle& style);
+
+	// False when the shader or the vertex buffer could not be created, the CPU path has to be used then
+	bool isLoaded() const;
+
+	// Uploads the new particles and returns the number of bytes written to the vertex buffer
+	std::size_t update();
+
+	static bool isSupported();
+
+private:
+	virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+	void upload(std::size_t begin, std::size_t count);
+
+private:
+	const ParticleBuffer& particles_;
+	const sf::Texture& texture_;
+	sf::Shader shader_;
+	sf::VertexBuffer vertexBuffer_;
+	std::vector<sf::Vertex> staging_;
+	std::size_t uploadedCount_;
+	bool isLoaded_;
+};
@@ -28,7 +28,7 @@ public:
 	void apply(Aircraft& player) const;
 
 protected:
-	virtual void drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const override;
+	virtual void drawCurrent(SpriteBatch& batch, sf::RenderStates states, float alpha) const override;
 
 
 private:
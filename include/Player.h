@@ -4,11 +4,10 @@
 
 #include <SFML/Window/Event.hpp>
 #include <SFML/System/NonCopyable.hpp>
-#include <SFML/Network/TcpSocket.hpp>
-
 #include "Command.h"
 #include "KeyBinding.h"
 #include "NetworkProtocol.h"
+#include "SendBuffer.h"
 
 class CommandQueue;
 
@@ -26,7 +25,7 @@ public:
 
 
 public:
-	Player(sf::TcpSocket* socket, sf::Int32 identifier, const KeyBinding* binding);
+	Player(SendBuffer* sendBuffer, sf::Int32 identifier, const KeyBinding* binding);
 
 	void handleEvent(const sf::Event& event, CommandQueue& commands);
 	void handleRealtimeInput(CommandQueue& commands);
@@ -36,6 +35,10 @@ public:
 	void handleNetworkEvent(Action action, CommandQueue& commands);
 	void handleNetworkRealtimeChange(Action action, bool actionEnable);
 
+	// All realtime actions as one bit per action (1 << action), the format of the UDP channel
+	sf::Uint8 getRealtimeActions() const;
+	void handleNetworkRealtimeActions(sf::Uint8 actions);
+
 	void setMissionStatus(MissionStatus status);
 	MissionStatus getMissionStatus() const;
 
@@ -48,9 +51,11 @@ private:
 private:
 	const KeyBinding* keyBinding_;
 	std::map<Action, Command> actionBinding_;
-	std::map<Action, bool> actionProxies_;
+
+	// Realtime actions enabled over the network, one bit per action (1 << action)
+	sf::Uint8 realtimeActions_;
 	MissionStatus currentMissionStatus_;
 	int identifier_;
-	sf::TcpSocket* socket_;
+	SendBuffer* sendBuffer_;
 };
 
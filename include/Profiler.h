@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <SFML/System/NonCopyable.hpp>
+
+
+// Named, nestable timing sections and per-frame counters. Sections are identified by their
+// name literal and keep the order in which they were first recorded. Every frame their times go into a short
+// history for rolling statistics, and each section run into a trace ring buffer which
+// can be written as a Chrome trace-event file (chrome://tracing, Perfetto).
+class Profiler : private sf::NonCopyable
+{
+public:
+	// Frames covered by the rolling statistics
+	static constexpr std::size_t HistorySize = 120;
+	// Section runs kept for the trace, older ones are overwritten
+	static constexpr std::size_t TraceCapacity = 8192;
+
+	struct Section
+	{
+		const char* name;
+		std::size_t depth;
+		bool isCounter;
+		// Microseconds for timed sections, the sum of addCount() for counters
+		double value;
+		std::array<double, HistorySize> history;
+	};
+
+	struct Statistics
+	{
+		double min;
+		double average;
+		double max;
+	};
+
+public:
+	Profiler();
+
+	// Moves the times of the current frame into the history and starts a new frame
+	void beginFrame();
+
+	void beginSection(const char* name);
+	void endSection();
+
+	// Counters are shown with the timings but do not appear in the trace
+	void addCount(const char* name, double count);
+
+	const std::vector<Section>& getSections() const;
+
+	// Min/avg/max of the values over the last HistorySize frames
+	Statistics getStatistics(const Section& section) const;
+
+	bool writeTrace(const std::string& filename) const;
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct OpenSection
+	{
+		std::size_t index;
+		Clock::time_point start;
+	};
+
+	struct TraceEvent
+	{
+		const char* name;
+		double start;
+		double duration;
+	};
+
+private:
+	std::size_t findSection(const char* name, bool isCounter);
+
+private:
+	std::vector<Section> sections_;
+	std::vector<OpenSection> openSections_;
+	std::size_t historyIndex_;
+	std::size_t historyCount_;
+
+	Clock::time_point epoch_;
+	std::vector<TraceEvent> trace_;
+	std::size_t traceNext_;
+};
+
+
+// Times its own lifetime as a profiler section, does nothing without profiler
+class ProfileScope : private sf::NonCopyable
+{
+public:
+	ProfileScope(Profiler* profiler, const char* name);
+	~ProfileScope();
+
+private:
+	Profiler* profiler_;
+};
@@ -6,6 +6,8 @@
 #include "ResourceIdentifiers.h"
 #include "CommandQueue.h"
 
+class ParticleRegistry;
+
 class Projectile
 	: public Entity
 {
@@ -20,7 +22,7 @@ public:
 	
 
 public:
-	Projectile(Type type, const TextureHolder& textures);
+	Projectile(Type type, const TextureHolder& textures, ParticleRegistry& particles);
 
 	void guideTowards(sf::Vector2f position);
 	bool isGuided() const;
@@ -31,8 +33,8 @@ public:
 	int getDamage() const;
 
 private:
-	virtual void updateCurrent(sf::Time dt, CommandQueue& commands);
-	virtual void drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+	virtual void integrateCurrent(sf::Time dt, CommandQueue& commands);
+	virtual void drawCurrent(SpriteBatch& batch, sf::RenderStates states, float alpha) const;
 
 private:
 	Type type_;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <SFML/Config.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include "SceneNode.h"
+#include "Projectile.h"
+#include "ResourceIdentifiers.h"
+
+class CollisionGrid;
+
+
+// Simulates and draws all unguided bullets in one node. Bullets are kept in contiguous
+// arrays (structure of arrays) whose storage is reused, so firing does not allocate once
+// the arrays reached the peak bullet count. Guided missiles remain Projectile scene nodes.
+class ProjectileSystem : public SceneNode
+{
+public:
+	struct Hit
+	{
+		SceneNode* target;
+		int damage;
+		sf::Vector2f position;
+		sf::Vector2f velocity;
+	};
+
+public:
+	explicit ProjectileSystem(const TextureHolder& textures);
+
+	void spawn(Projectile::Type type, sf::Vector2f position, sf::Vector2f velocity);
+	float getMaxSpeed(Projectile::Type type) const;
+	std::size_t getBulletCount() const;
+
+	void removeOutside(const sf::FloatRect& bounds);
+	void checkCollisions(const CollisionGrid& grid, std::vector<Hit>& hits);
+
+	virtual Category getCategory() const override;
+
+private:
+	virtual void integrateCurrent(sf::Time dt, CommandQueue& commands) override;
+	virtual void drawCurrent(SpriteBatch& batch, sf::RenderStates states, float alpha) const override;
+
+	sf::FloatRect getBounds(std::size_t index) const;
+	void kill(std::size_t index);
+	void removeDead();
+	void computeVertices(float alpha) const;
+
+private:
+	const sf::Texture* texture_;
+
+	// One entry per live bullet, index i of every array belongs to the same bullet
+	std::vector<sf::Vector2f> positions_;
+	std::vector<sf::Vector2f> velocities_;
+	std::vector<Projectile::Type> types_;
+	std::vector<int> damages_;
+	std::vector<sf::Uint8> alive_;
+	std::size_t deadCount_;
+
+	// Length of the last step, bullets are drawn moved back by the part of it the interpolation has not reached
+	float stepSeconds_;
+
+	std::array<sf::IntRect, Projectile::TypeCount> textureRects_;
+	mutable sf::VertexArray vertexArray_;
+};
+
@@ -34,6 +34,10 @@ public:
 	Resource& get(Identifier id);
 	const Resource& get(Identifier id) const;
 
+	// Like get(), but returns nullptr for IDs that were never loaded (e.g. textures in a headless world)
+	Resource* find(Identifier id);
+	const Resource* find(Identifier id) const;
+
 private:
 	bool insertResource(Identifier id, std::unique_ptr<Resource> resource);
 
@@ -43,6 +43,20 @@ const Resource& ResourceHolder<Resource, Identifier>::get(Identifier id) const
 	return *found->second;
 }
 
+template <LoadableResource Resource, MapKey Identifier>
+Resource* ResourceHolder<Resource, Identifier>::find(Identifier id)
+{
+	auto found = resourceMap_.find(id);
+	return found != resourceMap_.end() ? found->second.get() : nullptr;
+}
+
+template <LoadableResource Resource, MapKey Identifier>
+const Resource* ResourceHolder<Resource, Identifier>::find(Identifier id) const
+{
+	auto found = resourceMap_.find(id);
+	return found != resourceMap_.end() ? found->second.get() : nullptr;
+}
+
 template <LoadableResource Resource, MapKey Identifier>
 bool ResourceHolder<Resource, Identifier>::insertResource(Identifier id, std::unique_ptr<Resource> resource)
 {
@@ -13,6 +13,9 @@
 #include "Category.h"
 #include "CommandQueue.h"
 
+class CollisionGrid;
+class CategoryRegistry;
+class SpriteBatch;
 
 class SceneNode : public sf::Transformable, public sf::Drawable, private sf::NonCopyable
 {
@@ -28,14 +31,41 @@ public:
 
 	void update(sf::Time dt, CommandQueue& commands);
 
+	// Second phase of a step, after update(): advances the node's own motion and timers. World runs it concurrently
+	// for the subtrees below the scene layers, so it may only change this subtree and push commands.
+	void integrate(sf::Time dt, CommandQueue& commands);
+
+	// Draws the transforms interpolated between the previous and the current simulation step, alpha in [0, 1]
+	void draw(SpriteBatch& batch, sf::RenderStates states, float alpha) const;
+
+	// Called at the start of every simulation step of a rendered scene, saves the state drawing interpolates from
+	void storePreviousState();
+
 	sf::Vector2f getWorldPosition() const;
 	sf::Transform getWorldTransform() const;
 
+	// Hide the sf::Transformable modifiers, so that any change invalidates the cached world transform
+	void setPosition(float x, float y);
+	void setPosition(const sf::Vector2f& position);
+	void setRotation(float angle);
+	void setScale(float factorX, float factorY);
+	void setScale(const sf::Vector2f& factors);
+	void setOrigin(float x, float y);
+	void setOrigin(const sf::Vector2f& origin);
+	void move(float offsetX, float offsetY);
+	void move(const sf::Vector2f& offset);
+	void rotate(float angle);
+	void scale(float factorX, float factorY);
+	void scale(const sf::Vector2f& factor);
+
 	void onCommand(const Command& command, sf::Time dt);
 	virtual Category getCategory() const;
+	void setCategoryRegistry(CategoryRegistry* registry);
+	void collectChildren(std::vector<SceneNode*>& nodes) const;
 
 	void checkSceneCollision(SceneNode& sceneGraph, std::set<Pair>& collisionPairs);
 	void checkNodeCollision(SceneNode& node, std::set<Pair>& collisionPairs);
+	void insertColliders(CollisionGrid& grid);
 	void removeWrecks();
 	virtual sf::FloatRect getBoundingRect() const;
 	virtual bool isMarkedForRemoval() const;
@@ -45,17 +75,32 @@ public:
 private:
 	virtual void updateCurrent(sf::Time dt, CommandQueue& commands);
 	void updateChildren(sf::Time dt, CommandQueue& commands);
+	virtual void integrateCurrent(sf::Time dt, CommandQueue& commands);
 
 	virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
-	virtual void drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
-	void drawChildren(sf::RenderTarget& target, sf::RenderStates states) const;
+	virtual void drawCurrent(SpriteBatch& batch, sf::RenderStates states, float alpha) const;
+	void drawChildren(SpriteBatch& batch, sf::RenderStates states, float alpha) const;
+	sf::Transform getInterpolatedTransform(float alpha) const;
 	void drawBoundingRect(sf::RenderTarget& target, sf::RenderStates states) const;
 
+	void markWorldTransformDirty();
+	void scheduleCategoryRemoval();
+
 
 private:
 	std::vector<Ptr> children_;
 	SceneNode* parent_;
 	Category defaultCategory_;
+	CategoryRegistry* categoryRegistry_;
+
+	// Combined transform of this node and all ancestors, recomputed lazily when dirty
+	mutable sf::Transform worldTransform_;
+	mutable bool isWorldTransformDirty_;
+
+	// Position and rotation at the start of the current simulation step, unset until the node's first step
+	sf::Vector2f previousPosition_;
+	float previousRotation_;
+	bool hasPreviousState_;
 };
 
 bool collision(const SceneNode& lhs, const SceneNode& rhs);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+
+
+// Outgoing bytes of one TCP connection. Messages are framed like sf::TcpSocket::send(sf::Packet&) and collected
+// until flush(), so everything produced during a tick or frame goes out in a single send call. A receiver still
+// gets them as separate packets. What a non-blocking socket does not take is kept for the next flush.
+class SendBuffer
+{
+public:
+	// Collected bytes beyond this are flushed right away instead of waiting for the end of the tick
+	static constexpr std::size_t FlushSize = 16 * 1024;
+
+	// A receiver that stops reading must not make the buffer grow without limit, beyond this many unsent bytes
+	// the connection counts as stalled
+	static constexpr std::size_t MaxPendingSize = 1024 * 1024;
+
+	struct Counters
+	{
+		Counters();
+		void add(const Counters& counters);
+
+		std::size_t messages;
+		std::size_t sendCalls;
+		std::size_t bytes;
+	};
+
+public:
+	explicit SendBuffer(sf::TcpSocket& socket);
+
+	void append(const sf::Packet& packet);
+
+	// Bytes already in the framed wire format, e.g. from a BroadcastPacket
+	void appendFramed(const void* data, std::size_t size);
+
+	void flush();
+	bool isEmpty() const;
+
+	// The pending bytes were dropped and further messages are ignored, since the stream's framing is lost.
+	// The owner has to close the connection.
+	bool isStalled() const;
+
+	// Returns the counters since the last call
+	Counters takeCounters();
+
+private:
+	sf::TcpSocket& socket_;
+	std::vector<char> buffer_;
+	Counters counters_;
+	bool isStalled_;
+};
@@ -24,6 +24,7 @@ public:
 private:
 	void updateLabels();
 	void addButtonLabel(std::size_t index, std::size_t x, std::size_t y, const std::string& text, Context context);
+	void addGraphicsButtons(Context context);
 
 private:
 	sf::Sprite backgroundSprite_;
@@ -32,5 +33,7 @@ private:
 private:
 	std::array<GUI::Button::Ptr, 2 * magic_enum::enum_count<PlayerAction>()> bindingButtons_;
 	std::array<GUI::Label::Ptr, 2 * magic_enum::enum_count<PlayerAction>()> bindingLabels_;
+	GUI::Label::Ptr bloomQualityLabel_;
+	GUI::Label::Ptr bloomRateLabel_;
 };
 
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <SFML/Config.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Network/Packet.hpp>
+
+
+class SnapshotHistory;
+
+// Aircraft positions and status of one server tick, quantized for the compact snapshot protocol.
+// write() only sends what changed against a base snapshot the client has acknowledged,
+// read() rebuilds the full snapshot from the base the client kept in its history.
+//
+// Format: [Uint16:sequence] [Uint16:baseSequence] [Int16:battleFieldPosition]
+//         [Uint8:removedCount] removedCount * [Uint16:identifier]
+//         [Uint8:changedCount] changedCount * ([Uint16:identifier|DeltaFlag|StatusFlag] ([Int8:dx] [Int8:dy] | [Int16:x] [Int16:y])
+//                                              ([Uint16:hitpoints] [Uint8:missileAmmo] if StatusFlag))
+// baseSequence == sequence marks a full snapshot. An aircraft new to the base always comes with its status.
+struct Snapshot
+{
+	struct Entry
+	{
+		sf::Uint16 identifier;
+		sf::Int16 x;
+		sf::Int16 y;
+		sf::Uint16 hitpoints;
+		sf::Uint8 missileAmmo;
+	};
+
+	Snapshot();
+
+	static sf::Int16 quantize(float value);
+	static float dequantize(sf::Int16 value);
+
+	// Entries are kept sorted by identifier
+	void setAircraft(sf::Int32 identifier, sf::Vector2f position, int hitpoints, int missileAmmo);
+	sf::Vector2f getPosition(const Entry& entry) const;
+
+	void write(sf::Packet& packet, const Snapshot* base) const;
+	bool read(sf::Packet& packet, const SnapshotHistory& history);
+
+	// Sequence of the snapshot at the packet's read position, without reading it
+	static bool peekSequence(const sf::Packet& packet, sf::Uint16& sequence);
+
+	sf::Uint16 sequence;
+	sf::Int16 battleFieldPosition;
+	std::vector<Entry> entries;
+};
+
+
+// The last few snapshots by sequence number: sent ones on the server, received ones on the client
+class SnapshotHistory
+{
+public:
+	// At 20 ticks per second, acknowledgements older than this are not worth a delta anymore
+	static constexpr std::size_t Size = 32;
+
+public:
+	SnapshotHistory();
+
+	void add(const Snapshot& snapshot);
+	const Snapshot* find(sf::Uint16 sequence) const;
+
+private:
+	std::array<Snapshot, Size> snapshots_;
+	std::array<bool, Size> isUsed_;
+};
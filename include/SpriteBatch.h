@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+namespace sf
+{
+	class RenderTarget;
+}
+
+
+// Collects what the scene graph draws and submits it on flush(). Consecutive sprites and quads
+// with the same texture, blend mode and shader are merged into one vertex array draw call.
+// Other drawables are deferred in order and must stay alive until the flush.
+class SpriteBatch : private sf::NonCopyable
+{
+public:
+	SpriteBatch();
+
+	void draw(const sf::Sprite& sprite, sf::RenderStates states);
+	void draw(const sf::VertexArray& vertices, const sf::RenderStates& states);
+	void draw(const sf::Drawable& drawable, const sf::RenderStates& states);
+
+	// Drawn after everything else of this flush (e.g. text above the sprites), so it does not split batches
+	void drawOverlay(const sf::Drawable& drawable, const sf::RenderStates& states);
+
+	void flush(sf::RenderTarget& target);
+
+	// Draw calls submitted by all batches since the last reset
+	static std::size_t getDrawCallCount();
+	static void resetDrawCallCount();
+
+private:
+	struct Item
+	{
+		const sf::Drawable* drawable;	// nullptr: vertex range of the batch
+		sf::RenderStates states;
+		std::size_t vertexBegin;
+		std::size_t vertexEnd;
+	};
+
+private:
+	Item& getBatch(const sf::RenderStates& states);
+	void submit(sf::RenderTarget& target, const Item& item);
+
+private:
+	std::vector<sf::Vertex> vertices_;
+	std::vector<Item> items_;
+	std::vector<Item> overlayItems_;
+
+	static std::size_t drawCallCount_;
+};
+
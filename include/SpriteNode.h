@@ -11,7 +11,7 @@ public:
 	SpriteNode(const sf::Texture& texture, const sf::IntRect& textureRect);
 
 private:
-	virtual void drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+	virtual void drawCurrent(SpriteBatch& batch, sf::RenderStates states, float alpha) const;
 
 private:
 	sf::Sprite sprite_;
@@ -10,6 +10,8 @@
 #include "MusicPlayer.h"
 #include "SoundPlayer.h"
 #include "KeyBinding.h"
+#include "Profiler.h"
+#include "GraphicsSettings.h"
 
 
 namespace sf
@@ -19,6 +21,7 @@ namespace sf
 
 class StateStack;
 class Player;
+class ThreadPool;
 
 class State
 {
@@ -28,7 +31,8 @@ public:
 	struct Context
 	{
 		Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts,
-			MusicPlayer& music, SoundPlayer& sounds, KeyBinding& keys1, KeyBinding& keys2);
+			MusicPlayer& music, SoundPlayer& sounds, KeyBinding& keys1, KeyBinding& keys2, Profiler& profiler,
+			ThreadPool& threadPool, GraphicsSettings& graphics);
 
 		sf::RenderWindow* window;
 		TextureHolder* textures;
@@ -37,6 +41,9 @@ public:
 		SoundPlayer* sounds;
 		KeyBinding* keys1;
 		KeyBinding* keys2;
+		Profiler* profiler;
+		ThreadPool* threadPool;
+		GraphicsSettings* graphics;
 	};
 
 public:
@@ -57,6 +64,9 @@ protected:
 
 	Context getContext() const;
 
+	// How far drawing is between the previous and the current update, in [0, 1]
+	float getRenderAlpha() const;
+
 private:
 	StateStack* stack_;
 	Context context_;
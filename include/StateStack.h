@@ -40,9 +40,12 @@ public:
 	void registerState(States stateID, Param1 param1);
 
 	void update(sf::Time dt);
-	void draw();
+	void draw(float alpha);
 	void handleEvent(const sf::Event& event);
 
+	// Interpolation alpha for the state currently drawing
+	float getRenderAlpha() const;
+
 	void pushState(States stateID);
 	void popState();
 	void clearStates();
@@ -69,6 +72,10 @@ private:
 
 	State::Context context_;
 	std::map<States, std::function<State::Ptr()>> factories_;
+
+	// Top states that were updated in the last step, the ones below stand still and are drawn without interpolation
+	std::size_t updatedStateCount_;
+	float renderAlpha_;
 };
 
 template <typename T>
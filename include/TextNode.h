@@ -15,7 +15,7 @@ public:
 	void setString(const std::string& text);
 
 private:
-	virtual void drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const override;
+	virtual void drawCurrent(SpriteBatch& batch, sf::RenderStates states, float alpha) const override;
 
 private:
 	sf::Text text_;
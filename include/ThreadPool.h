@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <SFML/System/NonCopyable.hpp>
+
+
+// Fixed set of worker threads for data parallel work. The calling thread takes part in every
+// parallelFor(), so a pool of n threads starts n - 1 workers.
+class ThreadPool : private sf::NonCopyable
+{
+public:
+	typedef std::function<void(std::size_t)> Task;
+
+public:
+	// threadCount 0 uses one thread per core
+	explicit ThreadPool(std::size_t threadCount = 0);
+	~ThreadPool();
+
+	// Calls task(i) for every i in [0, count), spread over the threads, returns once all calls are done
+	void parallelFor(std::size_t count, const Task& task);
+
+	std::size_t getThreadCount() const;
+
+private:
+	void workerLoop();
+	void runTasks(const Task* task, std::size_t count);
+
+private:
+	std::vector<std::thread> workers_;
+	std::mutex mutex_;
+	std::condition_variable workAvailable_;
+	std::condition_variable workersIdle_;
+
+	// Current batch, only replaced while no worker is busy
+	const Task* task_;
+	std::size_t taskCount_;
+	std::atomic<std::size_t> nextIndex_;
+	std::size_t generation_;
+	std::size_t busyWorkers_;
+	bool isStopping_;
+};
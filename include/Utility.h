@@ -26,8 +26,9 @@ void			centerOrigin(Animation& animation);
 float			toDegree(float radian);
 float			toRadian(float degree);
 
-// Random number generation
+// Random number generation per thread, reseeding makes a run on the calling thread reproducible
 int				randomInt(int exclusiveMax);
+void			seedRandomEngine(unsigned int seed);
 
 // Vector operations
 float			length(sf::Vector2f vector);
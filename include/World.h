@@ -24,6 +24,12 @@
 #include "NetworkProtocol.h"
 #include "NetworkNode.h"
 #include "SpriteNode.h"
+#include "CollisionGrid.h"
+#include "CategoryRegistry.h"
+#include "ParticleRegistry.h"
+#include "ProjectileSystem.h"
+#include "SpriteBatch.h"
+#include "Profiler.h"
 
 // Forward declaration
 namespace sf
@@ -31,15 +37,40 @@ namespace sf
 	class RenderTarget;
 }
 
+class ThreadPool;
+
 class World : private sf::NonCopyable
 {
 public:
 	World(sf::RenderTarget& outputTarget, FontHolder& fonts, SoundPlayer& sounds, bool isNetworked = false);
+
+	// Headless world: simulation only, without render target, textures, sounds or post effects.
+	// fonts may be empty, draw() must not be called.
+	explicit World(FontHolder& fonts, bool isNetworked = false);
+
 	void update(sf::Time dt);
-	void draw();
+
+	// Draws the scene alpha of the way from the previous to the current step, alpha in [0, 1]
+	void draw(float alpha);
+
+	bool isHeadless() const;
+
+	// Times the update phases into profiler sections, nullptr disables profiling
+	void setProfiler(Profiler* profiler);
+
+	// Runs the integration phase of large scenes on the pool, nullptr (the default) keeps it on the calling thread
+	void setThreadPool(ThreadPool* threadPool);
+
+	// Read on every draw, so menu changes apply at once. nullptr (the default) draws high quality bloom.
+	void setGraphicsSettings(const GraphicsSettings* graphics);
+
+	// Off in the clients of an authoritative server: collisions do not damage player aircraft, their hitpoints
+	// are set from the server's state and they are only destroyed by removeAircraft()
+	void setPlayerDamageEnabled(bool enabled);
 
 	sf::FloatRect getViewBounds() const;
 	CommandQueue& getCommandQueue();
+	const CategoryRegistry& getCategoryRegistry() const;
 
 	Aircraft* addAircraft(int identifier);
 	void removeAircraft(int identifier);
@@ -61,10 +92,15 @@ public:
 	bool pollGameAction(GameActions::Action& out);
 
 private:
+	World(sf::RenderTarget* outputTarget, FontHolder& fonts, SoundPlayer* sounds, bool isNetworked);
+
 	void loadTextures();
 	void adaptPlayerPosition();
 	void adaptPlayerVelocity();
 	void handleCollisions();
+	void applyDamage(Aircraft& aircraft, int points);
+	void integrateScene(sf::Time dt);
+	void drawScene(sf::RenderTarget& target, float alpha);
 	void updateSounds();
 	
 	void buildScene();
@@ -98,18 +134,31 @@ private:
 
 
 private:
-	sf::RenderTarget& target_;
-	sf::RenderTexture sceneTexture_;
+	// Both nullptr in a headless world
+	sf::RenderTarget* target_;
+	std::unique_ptr<sf::RenderTexture> sceneTexture_;
 
 	sf::View worldView_;
+	sf::Vector2f previousViewCenter_;
 	TextureHolder textures_;
 	FontHolder& fonts_;
-	SoundPlayer& sounds_;
+	SoundPlayer* sounds_;
 
+	// Declared before the scene graph, so they outlive the nodes registered in them
+	CategoryRegistry categoryRegistry_;
+	ParticleRegistry particleRegistry_;
 	SceneNode sceneGraph_;
 	std::array<SceneNode*, LayerCount> sceneLayers_;
+	SpriteBatch spriteBatch_;
 	CommandQueue commandQueue_;
 
+	// Integration work of one step: the subtrees below the layers, and the commands each chunk of them pushed
+	std::vector<SceneNode*> integrationNodes_;
+	std::vector<CommandQueue> integrationCommands_;
+	CollisionGrid collisionGrid_;
+	std::vector<SceneNode::Pair> collisionPairs_;
+	std::vector<ProjectileSystem::Hit> bulletHits_;
+
 	sf::FloatRect worldBounds_;
 	sf::Vector2f spawnPosition_;
 	float scrollSpeed_;
@@ -119,10 +168,15 @@ private:
 	std::vector<SpawnPoint> enemySpawnPoints_;
 	std::vector<Aircraft*> activeEnemies_;
 
-	BloomEffect bloomEffect_;
+	std::unique_ptr<BloomEffect> bloomEffect_;
+	Profiler* profiler_;
+	ThreadPool* threadPool_;
+	const GraphicsSettings* graphics_;
 
 	bool isNetworkedWorld_;
+	bool isPlayerDamageEnabled_;
 	NetworkNode* networkNode_;
+	ProjectileSystem* projectileSystem_;
 	SpriteNode* finishSprite_;
 };
 
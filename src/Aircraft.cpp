@@ -1,8 +1,7 @@
 #include <cmath>
 
-#include <SFML/Graphics/RenderTarget.hpp>
-
 #include "Aircraft.h"
+#include "SpriteBatch.h"
 #include "ResourceHolder.h"
 #include "ResourceIdentifiers.h"
 #include "Utility.h"
@@ -10,6 +9,9 @@
 #include "Pickup.h"
 #include "SoundNode.h"
 #include "NetworkNode.h"
+#include "ProjectileSystem.h"
+#include "EmitterNode.h"
+#include "ParticleRegistry.h"
 
 
 namespace
@@ -17,11 +19,11 @@ namespace
 	const std::vector<AircraftData> Table = initializeAircraftData();
 }
 
-Aircraft::Aircraft(Type type, const TextureHolder& textures, const FontHolder& fonts)
+Aircraft::Aircraft(Type type, const TextureHolder& textures, const FontHolder& fonts, ParticleRegistry& particles)
 	: Entity(Table[type].hitpoints)
 	, type_(type)
-	, sprite_(textures.get(Table[type].texture), Table[type].textureRect)
-	, explosion_(textures.get(Textures::Explosion))
+	, sprite_()
+	, explosion_()
 	, fireCommand_()
 	, missileCommand_()
 	, fireCountdown_(sf::Time::Zero)
@@ -39,7 +41,19 @@ Aircraft::Aircraft(Type type, const TextureHolder& textures, const FontHolder& f
 	, directionIndex_(0)
 	, missileDisplay_(nullptr)
 	, identifier_(0)
+	, particles_(particles)
 {
+	// Textures are missing in a headless world, the texture rect alone still gives the sprite its bounds
+	sprite_.setTextureRect(Table[type].textureRect);
+	if (const sf::Texture* texture = textures.find(Table[type].texture))
+	{
+		sprite_.setTexture(*texture);
+	}
+	if (const sf::Texture* texture = textures.find(Textures::Explosion))
+	{
+		explosion_.setTexture(*texture);
+	}
+
 	explosion_.setFrameSize(sf::Vector2i(256, 256));
 	explosion_.setNumFrames(16);
 	explosion_.setDuration(sf::seconds(1.f));
@@ -47,10 +61,10 @@ Aircraft::Aircraft(Type type, const TextureHolder& textures, const FontHolder& f
 	centerOrigin(sprite_);
 	centerOrigin(explosion_);
 
-	fireCommand_.category = Category::SceneAirLayer;
-	fireCommand_.action = [this, &textures](SceneNode& node, sf::Time) {
-		createBullets(node, textures);
-		};
+	fireCommand_.category = Category::ProjectileSystem;
+	fireCommand_.action = derivedAction<ProjectileSystem>([this](ProjectileSystem& system, sf::Time) {
+		createBullets(system);
+		});
 
 	missileCommand_.category = Category::SceneAirLayer;
 	missileCommand_.action = [this, &textures](SceneNode& node, sf::Time) {
@@ -75,6 +89,14 @@ Aircraft::Aircraft(Type type, const TextureHolder& textures, const FontHolder& f
 		attachChild(std::move(missileDisplay));
 	}
 
+	// Engine trail behind the aircraft, only where it is drawn
+	if (sprite_.getTexture() != nullptr)
+	{
+		std::unique_ptr<EmitterNode> engineTrail = std::make_unique<EmitterNode>(Particle::EngineTrail, particles, sf::Vector2f(0.f, 1.f));
+		engineTrail->setPosition(0.f, getBoundingRect().height / 2.f);
+		attachChild(std::move(engineTrail));
+	}
+
 	updateTexts();
 }
 
@@ -89,15 +111,15 @@ void Aircraft::setMissileAmmo(int ammo)
 }
 
 
-void Aircraft::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+void Aircraft::drawCurrent(SpriteBatch& batch, sf::RenderStates states, float) const
 {
 	if (isDestroyed() && isShowExplosion_)
 	{
-		target.draw(explosion_, states);
+		batch.draw(explosion_, states);
 	}
 	else
 	{
-		target.draw(sprite_, states);
+		batch.draw(sprite_, states);
 	}
 }
 
@@ -123,6 +145,7 @@ void Aircraft::updateCurrent(sf::Time dt, CommandQueue& commands)
 		{
 			SoundEffect soundEffect = (randomInt(2) == 0) ? SoundEffect::Explosion1 : SoundEffect::Explosion2;
 			playLocalSound(commands, soundEffect);
+			particles_.burst(Particle::Debris, getWorldPosition(), sf::Vector2f());
 
 			// Emit network game action for enemy explosions
 			if (!isAllied())
@@ -141,6 +164,14 @@ void Aircraft::updateCurrent(sf::Time dt, CommandQueue& commands)
 
 			isExplosionBegin_ = true;
 		}
+	}
+}
+
+void Aircraft::integrateCurrent(sf::Time dt, CommandQueue& commands)
+{
+	// The wreck stays where it exploded
+	if (isDestroyed())
+	{
 		return;
 	}
 
@@ -149,7 +180,7 @@ void Aircraft::updateCurrent(sf::Time dt, CommandQueue& commands)
 
 	// Update enemy movement pattern; apply velocity
 	updateMovementPattern(dt);
-	Entity::updateCurrent(dt, commands);
+	Entity::integrateCurrent(dt, commands);
 }
 
 Category Aircraft::getCategory() const
@@ -322,25 +353,25 @@ void Aircraft::checkProjectileLaunch(sf::Time dt, CommandQueue& commands)
 	}
 }
 
-void Aircraft::createBullets(SceneNode& node, const TextureHolder& textures) const
+void Aircraft::createBullets(ProjectileSystem& system) const
 {
 	Projectile::Type type = isAllied() ? Projectile::AlliedBullet : Projectile::EnemyBullet;
 
 	switch (spreadLevel_)
 	{
 	case 1:
-		CreateProjectile(node, type, 0.f, 0.5f, textures);
+		CreateBullet(system, type, 0.f, 0.5f);
 		break;
 
 	case 2:
-		CreateProjectile(node, type, -0.33f, 0.33f, textures);
-		CreateProjectile(node, type, 0.33f, 0.33f, textures);
+		CreateBullet(system, type, -0.33f, 0.33f);
+		CreateBullet(system, type, 0.33f, 0.33f);
 		break;
 
 	case 3:
-		CreateProjectile(node, type, -0.5f, 0.33f, textures);
-		CreateProjectile(node, type, 0.f, 0.5f, textures);
-		CreateProjectile(node, type, 0.5f, 0.33f, textures);
+		CreateBullet(system, type, -0.5f, 0.33f);
+		CreateBullet(system, type, 0.f, 0.5f);
+		CreateBullet(system, type, 0.5f, 0.33f);
 		break;
 
 	default:
@@ -348,9 +379,18 @@ void Aircraft::createBullets(SceneNode& node, const TextureHolder& textures) con
 	}
 }
 
+void Aircraft::CreateBullet(ProjectileSystem& system, Projectile::Type type, float xOffset, float yOffset) const
+{
+	sf::Vector2f offset(xOffset * sprite_.getGlobalBounds().width, yOffset * sprite_.getGlobalBounds().height);
+	sf::Vector2f velocity(0, system.getMaxSpeed(type));
+
+	float sign = (isAllied() ? -1.f : 1.f);
+	system.spawn(type, getWorldPosition() + offset * sign, velocity * sign);
+}
+
 void Aircraft::CreateProjectile(SceneNode& node, Projectile::Type type, float xOffset, float yOffset, const TextureHolder& textures) const
 {
-	std::unique_ptr<Projectile> projectile = std::make_unique<Projectile>(type, textures);
+	std::unique_ptr<Projectile> projectile = std::make_unique<Projectile>(type, textures, particles_);
 
 	sf::Vector2f offset(xOffset * sprite_.getGlobalBounds().width, yOffset * sprite_.getGlobalBounds().height);
 	sf::Vector2f velocity(0, projectile->getMaxSpeed());
@@ -0,0 +1,80 @@
+#include <cassert>
+
+#include "AircraftSlots.h"
+
+AircraftSlots::AircraftSlots()
+	: slots_()
+	, isUsed_()
+	, freeHandles_()
+	, handles_()
+{
+}
+
+AircraftSlots::Handle AircraftSlots::add(sf::Int32 identifier)
+{
+	assert(handles_.find(identifier) == handles_.end() && "AircraftSlots::add - Identifier already in use");
+
+	// Lowest freed slot first keeps the used slots packed at the front
+	Handle handle;
+	if (!freeHandles_.empty())
+	{
+		handle = freeHandles_.back();
+		freeHandles_.pop_back();
+	}
+	else
+	{
+		handle = slots_.size();
+		slots_.emplace_back();
+		isUsed_.push_back(false);
+	}
+
+	slots_[handle] = Aircraft{ identifier, sf::Vector2f(), 0, 0 };
+	isUsed_[handle] = true;
+	handles_[identifier] = handle;
+
+	return handle;
+}
+
+void AircraftSlots::remove(Handle handle)
+{
+	assert(isUsed(handle) && "AircraftSlots::remove - Slot is not in use");
+
+	handles_.erase(slots_[handle].identifier);
+	isUsed_[handle] = false;
+
+	// Free list sorted descending, so back() is the lowest free handle
+	auto position = freeHandles_.begin();
+	while (position != freeHandles_.end() && *position > handle)
+	{
+		++position;
+	}
+	freeHandles_.insert(position, handle);
+}
+
+AircraftSlots::Handle AircraftSlots::find(sf::Int32 identifier) const
+{
+	auto found = handles_.find(identifier);
+	return found != handles_.end() ? found->second : InvalidHandle;
+}
+
+AircraftSlots::Aircraft& AircraftSlots::get(Handle handle)
+{
+	assert(isUsed(handle) && "AircraftSlots::get - Slot is not in use");
+	return slots_[handle];
+}
+
+const AircraftSlots::Aircraft& AircraftSlots::get(Handle handle) const
+{
+	assert(isUsed(handle) && "AircraftSlots::get - Slot is not in use");
+	return slots_[handle];
+}
+
+bool AircraftSlots::isUsed(Handle handle) const
+{
+	return handle < slots_.size() && isUsed_[handle];
+}
+
+std::size_t AircraftSlots::getSize() const
+{
+	return handles_.size();
+}
@@ -100,7 +100,9 @@ void Animation::update(sf::Time dt)
 	sf::Time timePerFrame = duration_ / static_cast<float>(numFrames_);
 	elapsedTime_ += dt;
 
-	sf::Vector2i textureBounds(sprite_.getTexture()->getSize());
+	// Without a texture (headless world) the frames only advance in time, one frame per row
+	const sf::Texture* texture = sprite_.getTexture();
+	sf::Vector2i textureBounds = texture ? sf::Vector2i(texture->getSize()) : frameSize_;
 	sf::IntRect textureRect = sprite_.getTextureRect();
 
 	if (currentFrame_ == 0)
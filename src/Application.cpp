@@ -1,3 +1,7 @@
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
 #include "Application.h"
 #include "TitleState.h"
 #include "MenuState.h"
@@ -9,9 +13,19 @@
 #include "SettingsState.h"
 #include "GameOverState.h"
 #include "MultiplayerGameState.h"
+#include "SpriteBatch.h"
+#include "ParticleNode.h"
 
 const sf::Time Application::TimePerFrame = sf::seconds(1.f / 60.f);
 
+namespace
+{
+	const std::string TraceFilename = "profile-trace.json";
+
+	// Updates run per rendered frame at most, when the simulation falls further behind the rest is dropped
+	const std::size_t MaxUpdatesPerFrame = 5;
+}
+
 Application::Application()
 	: window_(sf::VideoMode(1024, 768), "Plane Game", sf::Style::Close)
 	, textures_()
@@ -20,10 +34,18 @@ Application::Application()
 	, sounds_()
 	, keyBinding1_(1)
 	, keyBinding2_(2)
-	, stateStack_(State::Context(window_, textures_, fonts_, music_, sounds_, keyBinding1_, keyBinding2_))
+	, profiler_()
+	, threadPool_()
+	, graphicsSettings_{ BloomQuality::High, false }
+	, stateStack_(State::Context(window_, textures_, fonts_, music_, sounds_, keyBinding1_, keyBinding2_, profiler_, threadPool_,
+		graphicsSettings_))
 	, statisticsText_()
 	, statisticsUpdateTime_()
 	, statisticsNumFrames_(0)
+	, statisticsNumDrawCalls_(0)
+	, statisticsNumParticleBytes_(0)
+	, profilerText_()
+	, isProfilerShown_(false)
 {
 	window_.setKeyRepeatEnabled(false);
 	window_.setVerticalSyncEnabled(true);
@@ -37,6 +59,10 @@ Application::Application()
 	statisticsText_.setPosition(5.f, 5.f);
 	statisticsText_.setCharacterSize(10u);
 
+	profilerText_.setFont(fonts_.get(Fonts::Main));
+	profilerText_.setPosition(5.f, 50.f);
+	profilerText_.setCharacterSize(10u);
+
 	registerStates();
 	stateStack_.pushState(States::Title);
 
@@ -50,11 +76,17 @@ void Application::run()
 
 	while (window_.isOpen())
 	{
+		// A profiler frame spans one rendered frame, with as many fixed updates as were due
+		profiler_.beginFrame();
+
 		sf::Time dt = clock.restart();
 		timeSinceLastUpdate += dt;
-		while (timeSinceLastUpdate > TimePerFrame)
+
+		std::size_t updates = 0;
+		while (timeSinceLastUpdate >= TimePerFrame && updates < MaxUpdatesPerFrame)
 		{
 			timeSinceLastUpdate -= TimePerFrame;
+			++updates;
 
 			processInput();
 			update(TimePerFrame);
@@ -66,8 +98,15 @@ void Application::run()
 			}
 		}
 
+		// Slow down instead of spiralling into ever more updates per frame
+		if (timeSinceLastUpdate >= TimePerFrame)
+		{
+			timeSinceLastUpdate %= TimePerFrame;
+		}
+
+		// Frames between two updates show the scene part of the way to the latest one
 		updateStatistics(dt);
-		render();
+		render(timeSinceLastUpdate / TimePerFrame);
 	}
 }
 
@@ -82,6 +121,22 @@ void Application::processInput()
 		{
 			window_.close();
 		}
+		else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3)
+		{
+			isProfilerShown_ = !isProfilerShown_;
+			updateProfilerText();
+		}
+		else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F4)
+		{
+			if (profiler_.writeTrace(TraceFilename))
+			{
+				std::cout << "Profiler trace written to " << TraceFilename << std::endl;
+			}
+			else
+			{
+				std::cout << "Could not write profiler trace to " << TraceFilename << std::endl;
+			}
+		}
 	}
 }
 
@@ -90,15 +145,20 @@ void Application::update(sf::Time dt)
 	stateStack_.update(dt);
 }
 
-void Application::render()
+void Application::render(float alpha)
 {
 	window_.clear();
 
-	stateStack_.draw();
+	stateStack_.draw(alpha);
 
 	window_.setView(window_.getDefaultView());
 	window_.draw(statisticsText_);
 
+	if (isProfilerShown_)
+	{
+		window_.draw(profilerText_);
+	}
+
 	window_.display();
 }
 
@@ -106,15 +166,49 @@ void Application::updateStatistics(sf::Time dt)
 {
 	statisticsUpdateTime_ += dt;
 	statisticsNumFrames_ += 1;
+
+	// Draw calls of the scene sprite batches during the previous frame
+	statisticsNumDrawCalls_ += SpriteBatch::getDrawCallCount();
+	SpriteBatch::resetDrawCallCount();
+	statisticsNumParticleBytes_ += ParticleNode::getUploadedByteCount();
+	ParticleNode::resetUploadedByteCount();
+
 	if (statisticsUpdateTime_ >= sf::seconds(1.0f))
 	{
-		statisticsText_.setString("FPS: " + toString(statisticsNumFrames_));
+		statisticsText_.setString("FPS: " + toString(statisticsNumFrames_) + "\n"
+			+ "Draw calls: " + toString(statisticsNumDrawCalls_ / statisticsNumFrames_) + "\n"
+			+ "Particle upload: " + toString(statisticsNumParticleBytes_ / statisticsNumFrames_) + " bytes/frame");
 
 		statisticsUpdateTime_ -= sf::seconds(1.0f);
 		statisticsNumFrames_ = 0;
+		statisticsNumDrawCalls_ = 0;
+		statisticsNumParticleBytes_ = 0;
+
+		if (isProfilerShown_)
+		{
+			updateProfilerText();
+		}
 	}
 }
 
+void Application::updateProfilerText()
+{
+	std::ostringstream text;
+	text << std::fixed << std::setprecision(2) << "Phase: min / avg / max ms (" << Profiler::HistorySize << " frames)\n";
+
+	for (const Profiler::Section& section : profiler_.getSections())
+	{
+		// Timings are shown in milliseconds, counters as they are
+		Profiler::Statistics statistics = profiler_.getStatistics(section);
+		double scale = section.isCounter ? 1.0 : 0.001;
+
+		text << std::string(2 * section.depth, ' ') << section.name << ": "
+			<< statistics.min * scale << " / " << statistics.average * scale << " / " << statistics.max * scale << "\n";
+	}
+
+	profilerText_.setString(text.str());
+}
+
 void Application::registerStates()
 {
 	stateStack_.registerState<TitleState>(States::Title);
@@ -1,10 +1,14 @@
 #include "BloomEffect.h"
+#include "Profiler.h"
 
 BloomEffect::BloomEffect()
 	: shaders_()
-	, brightnessTexture_()
 	, firstPassTextures_()
 	, secondPassTextures_()
+	, quality_(BloomQuality::High)
+	, isHalfRate_(false)
+	, bloomTexture_(nullptr)
+	, profiler_(nullptr)
 {
 	shaders_.load(Shaders::BrightnessPass, "Media/Shaders/Fullpass.vert", "Media/Shaders/Brightness.frag");
 	shaders_.load(Shaders::DownSamplePass, "Media/Shaders/Fullpass.vert", "Media/Shaders/DownSample.frag");
@@ -17,33 +21,46 @@ void BloomEffect::apply(const sf::RenderTexture& input, sf::RenderTarget& output
 	// Prepare the textures for the bloom effect
 	prepareTextures(input.getSize());
 
-	// Filter the bright areas of the scene
-	filterBright(input, brightnessTexture_);
+	// At half rate every second frame reuses the bloom of the previous one
+	if (isHalfRate_ && bloomTexture_ != nullptr)
+	{
+		const sf::RenderTexture& bloom = *bloomTexture_;
+		bloomTexture_ = nullptr;
 
-	// Downsample the bright areas
-	downsample(brightnessTexture_, firstPassTextures_[0]);
-	// Apply a Gaussian blur to the downsampled texture
-	blurMultipass(firstPassTextures_);
+		add(input, bloom, output);
+		return;
+	}
 
-	// Downsample the blurred texture
-	downsample(firstPassTextures_[0], secondPassTextures_[0]);
-	// Apply a Gaussian blur to the downsampled texture
-	blurMultipass(secondPassTextures_);
-
-	add(firstPassTextures_[0], secondPassTextures_[0], firstPassTextures_[1]);
-	firstPassTextures_[1].display();
+	const sf::RenderTexture& bloom = renderBloom(input);
+	bloomTexture_ = isHalfRate_ ? &bloom : nullptr;
 
 	// Add the blurred bloom effect to the original scene
-	add(input, firstPassTextures_[1], output);
+	add(input, bloom, output);
 }
 
-void BloomEffect::prepareTextures(sf::Vector2u size)
+void BloomEffect::setQuality(BloomQuality quality)
 {
-	if (brightnessTexture_.getSize() != size)
+	if (quality_ != quality)
 	{
-		brightnessTexture_.create(size.x, size.y);
-		brightnessTexture_.setSmooth(true);
+		quality_ = quality;
+		bloomTexture_ = nullptr;
+	}
+}
 
+void BloomEffect::setHalfRate(bool flag)
+{
+	isHalfRate_ = flag;
+}
+
+void BloomEffect::setProfiler(Profiler* profiler)
+{
+	profiler_ = profiler;
+}
+
+void BloomEffect::prepareTextures(sf::Vector2u size)
+{
+	if (firstPassTextures_[0].getSize() != size / 2u)
+	{
 		firstPassTextures_[0].create(size.x / 2, size.y / 2);
 		firstPassTextures_[0].setSmooth(true);
 		firstPassTextures_[1].create(size.x / 2, size.y / 2);
@@ -53,31 +70,62 @@ void BloomEffect::prepareTextures(sf::Vector2u size)
 		secondPassTextures_[0].setSmooth(true);
 		secondPassTextures_[1].create(size.x / 4, size.y / 4);
 		secondPassTextures_[1].setSmooth(true);
+
+		bloomTexture_ = nullptr;
 	}
 }
 
+const sf::RenderTexture& BloomEffect::renderBloom(const sf::RenderTexture& input)
+{
+	if (quality_ == BloomQuality::Low)
+	{
+		// Filter the bright areas of the scene straight into quarter resolution and blur them
+		filterBright(input, secondPassTextures_[0]);
+		blur(secondPassTextures_);
+
+		return secondPassTextures_[0];
+	}
+
+	// Filter the bright areas of the scene into half resolution, and blur them
+	filterBright(input, firstPassTextures_[0]);
+	blur(firstPassTextures_);
+
+	// Downsample the blurred texture, and blur it again
+	downsample(firstPassTextures_[0], secondPassTextures_[0]);
+	blur(secondPassTextures_);
+
+	add(firstPassTextures_[0], secondPassTextures_[0], firstPassTextures_[1]);
+	firstPassTextures_[1].display();
+
+	return firstPassTextures_[1];
+}
+
 void BloomEffect::filterBright(const sf::RenderTexture& input, sf::RenderTexture& output)
 {
+	ProfileScope scope(profiler_, "bright pass");
 	sf::Shader& brightness = shaders_.get(Shaders::BrightnessPass);
 
+	// Each of the four bilinear samples averages 2x2 texels, together they cover the input texels of an output pixel
+	sf::Vector2f ratio(static_cast<float>(input.getSize().x) / output.getSize().x, static_cast<float>(input.getSize().y) / output.getSize().y);
+	sf::Vector2f offset(ratio.x / 4.f / input.getSize().x, ratio.y / 4.f / input.getSize().y);
+
 	brightness.setUniform("source", input.getTexture());
+	brightness.setUniform("offsetFactor", offset);
 	applyShader(brightness, output);
 	output.display();
 }
 
-void BloomEffect::blurMultipass(RenderTextureArray& renderTextures)
+void BloomEffect::blur(RenderTextureArray& renderTextures)
 {
+	ProfileScope scope(profiler_, "blur passes");
 	sf::Vector2u textureSize = renderTextures[0].getSize();
 
-	for (std::size_t count = 0; count != 2; ++count)
-	{
-		// Apply the Gaussian blur to the first pass
-		blur(renderTextures[0], renderTextures[1], sf::Vector2f(0.f, 1.f / textureSize.y));
-		blur(renderTextures[1], renderTextures[0], sf::Vector2f(1.f / textureSize.x, 0.f));
-	}
+	// The shader's kernel is as wide as two of the old 9 tap rounds, its sample offsets need exactly one texel steps
+	blurPass(renderTextures[0], renderTextures[1], sf::Vector2f(0.f, 1.f / textureSize.y));
+	blurPass(renderTextures[1], renderTextures[0], sf::Vector2f(1.f / textureSize.x, 0.f));
 }
 
-void BloomEffect::blur(const sf::RenderTexture& input, sf::RenderTexture& output, sf::Vector2f offsetFactor)
+void BloomEffect::blurPass(const sf::RenderTexture& input, sf::RenderTexture& output, sf::Vector2f offsetFactor)
 {
 	sf::Shader& gaussianBlur = shaders_.get(Shaders::GaussianBlurPass);
 
@@ -89,16 +137,19 @@ void BloomEffect::blur(const sf::RenderTexture& input, sf::RenderTexture& output
 
 void BloomEffect::downsample(const sf::RenderTexture& input, sf::RenderTexture& output)
 {
+	ProfileScope scope(profiler_, "downsample pass");
 	sf::Shader& downSample = shaders_.get(Shaders::DownSamplePass);
 
+	// Half resolution: the four bilinear samples hit the centers of the 2x2 input texels
 	downSample.setUniform("source", input.getTexture());
-	downSample.setUniform("sourceSize", sf::Vector2f(input.getSize()));
+	downSample.setUniform("offsetFactor", sf::Vector2f(0.5f / input.getSize().x, 0.5f / input.getSize().y));
 	applyShader(downSample, output);
 	output.display();
 }
 
 void BloomEffect::add(const sf::RenderTexture& source, const sf::RenderTexture& bloom, sf::RenderTarget& output)
 {
+	ProfileScope scope(profiler_, "add passes");
 	sf::Shader& add = shaders_.get(Shaders::AddPass);
 
 	add.setUniform("source", source.getTexture());
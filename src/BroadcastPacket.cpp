@@ -0,0 +1,45 @@
+#include <cassert>
+#include <cstring>
+
+#include "BroadcastPacket.h"
+
+BroadcastPacket::BroadcastPacket(ServerPacketType type, const sf::Packet& payload)
+	: type_(type)
+	, payload_(&payload)
+	, bytes_()
+{
+}
+
+const std::vector<char>& BroadcastPacket::getBytes(sf::Uint8 protocolVersion)
+{
+	assert(protocolVersion <= ProtocolVersion && "BroadcastPacket::getBytes - Unknown protocol version");
+
+	std::vector<char>& bytes = bytes_[protocolVersion];
+	if (bytes.empty())
+	{
+		sf::Packet header;
+		writeServerPacketType(header, type_, protocolVersion);
+
+		// Same size prefix as sf::TcpSocket::send(sf::Packet&): big endian, counting the data only
+		const std::size_t size = header.getDataSize() + payload_->getDataSize();
+		bytes.resize(sizeof(sf::Uint32) + size);
+		bytes[0] = static_cast<char>(size >> 24);
+		bytes[1] = static_cast<char>(size >> 16);
+		bytes[2] = static_cast<char>(size >> 8);
+		bytes[3] = static_cast<char>(size);
+
+		std::memcpy(bytes.data() + sizeof(sf::Uint32), header.getData(), header.getDataSize());
+		if (payload_->getDataSize() > 0)
+		{
+			std::memcpy(bytes.data() + sizeof(sf::Uint32) + header.getDataSize(), payload_->getData(), payload_->getDataSize());
+		}
+	}
+
+	return bytes;
+}
+
+void BroadcastPacket::send(SendBuffer& buffer, sf::Uint8 protocolVersion)
+{
+	const std::vector<char>& bytes = getBytes(protocolVersion);
+	buffer.appendFramed(bytes.data(), bytes.size());
+}
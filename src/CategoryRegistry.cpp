@@ -0,0 +1,122 @@
+#include <algorithm>
+
+#include "CategoryRegistry.h"
+#include "SceneNode.h"
+
+namespace
+{
+	const std::size_t InitialRemovalCapacity = 64;
+}
+
+
+CategoryRegistry::CategoryRegistry()
+	: entries_()
+	, pendingRemovals_()
+	, visitedCount_(0)
+	, matchedCount_(0)
+{
+	// Reused from frame to frame, it only grows when a frame removes more nodes than ever before
+	pendingRemovals_.reserve(InitialRemovalCapacity);
+}
+
+void CategoryRegistry::add(SceneNode& node)
+{
+	const unsigned int categoryBits = static_cast<unsigned int>(node.getCategory());
+
+	for (std::size_t bit = 0; bit < CategoryBitCount; ++bit)
+	{
+		if ((categoryBits & (1u << bit)) != 0)
+		{
+			entries_[bit].push_back(Entry{ &node, categoryBits });
+		}
+	}
+}
+
+void CategoryRegistry::remove(SceneNode& node)
+{
+	for (auto& entries : entries_)
+	{
+		auto found = std::find_if(entries.begin(), entries.end(),
+			[&](const Entry& entry) { return entry.node == &node; });
+
+		if (found != entries.end())
+		{
+			entries.erase(found);
+		}
+	}
+}
+
+void CategoryRegistry::scheduleRemoval(SceneNode& node)
+{
+	pendingRemovals_.push_back(&node);
+}
+
+void CategoryRegistry::compact()
+{
+	if (pendingRemovals_.empty())
+	{
+		return;
+	}
+
+	// One pass per list for all removals of this frame, instead of one search per removed node
+	std::sort(pendingRemovals_.begin(), pendingRemovals_.end());
+
+	for (auto& entries : entries_)
+	{
+		auto removedBegin = std::remove_if(entries.begin(), entries.end(), [this](const Entry& entry)
+			{
+				return std::binary_search(pendingRemovals_.begin(), pendingRemovals_.end(), entry.node);
+			});
+		entries.erase(removedBegin, entries.end());
+	}
+
+	pendingRemovals_.clear();
+}
+
+void CategoryRegistry::dispatch(const Command& command, sf::Time dt)
+{
+	const unsigned int commandBits = static_cast<unsigned int>(command.category);
+
+	for (std::size_t bit = 0; bit < CategoryBitCount; ++bit)
+	{
+		const unsigned int categoryBit = 1u << bit;
+		if ((commandBits & categoryBit) == 0)
+		{
+			continue;
+		}
+
+		// Actions may attach new nodes (and grow the list), those are only commanded from the next dispatch on
+		const std::size_t count = entries_[bit].size();
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const Entry entry = entries_[bit][i];
+			++visitedCount_;
+
+			// A node listed under several bits receives the command only once, through its lowest matching bit
+			const unsigned int matchingBits = commandBits & entry.categoryBits;
+			if ((matchingBits & (~matchingBits + 1)) != categoryBit)
+			{
+				continue;
+			}
+
+			++matchedCount_;
+			command.action(*entry.node, dt);
+		}
+	}
+}
+
+std::size_t CategoryRegistry::getVisitedCount() const
+{
+	return visitedCount_;
+}
+
+std::size_t CategoryRegistry::getMatchedCount() const
+{
+	return matchedCount_;
+}
+
+void CategoryRegistry::resetCounters()
+{
+	visitedCount_ = 0;
+	matchedCount_ = 0;
+}
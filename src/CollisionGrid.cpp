@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <cmath>
+
+#include "CollisionGrid.h"
+
+namespace
+{
+	// Upper bound for the grid resolution, keeps the cell arrays small if a collider strays far away
+	const int MaxCellsPerAxis = 64;
+}
+
+CollisionGrid::CollisionGrid(float cellSize)
+	: cellSize_(cellSize)
+	, collisionPairs_()
+	, colliders_()
+	, gridBounds_()
+	, cellWidth_(cellSize)
+	, cellHeight_(cellSize)
+	, columns_(0)
+	, rows_(0)
+	, cellStart_()
+	, cellCursor_()
+	, cellEntries_()
+{
+	// The cell count follows the colliders' extent, so the cell arrays are sized for the largest grid once
+	const std::size_t maxCellCount = static_cast<std::size_t>(MaxCellsPerAxis * MaxCellsPerAxis);
+	cellStart_.reserve(maxCellCount + 1);
+	cellCursor_.reserve(maxCellCount);
+}
+
+void CollisionGrid::addCollisionPair(Category first, Category second)
+{
+	collisionPairs_.push_back(std::make_pair(first, second));
+}
+
+bool CollisionGrid::isCollidable(Category category) const
+{
+	return getPartners(category) != Category::None;
+}
+
+void CollisionGrid::clear()
+{
+	colliders_.clear();
+}
+
+void CollisionGrid::insert(SceneNode& node, const sf::FloatRect& bounds)
+{
+	Category category = node.getCategory();
+	Category partners = getPartners(category);
+
+	// Nodes that cannot collide with anything are not worth storing
+	if (partners == Category::None)
+	{
+		return;
+	}
+
+	colliders_.push_back(Collider{ &node, bounds, category, partners });
+}
+
+void CollisionGrid::computePairs(std::vector<SceneNode::Pair>& collisionPairs)
+{
+	collisionPairs.clear();
+	if (colliders_.empty())
+	{
+		return;
+	}
+
+	buildCells();
+
+	const int cellCount = columns_ * rows_;
+	for (int cell = 0; cell != cellCount; ++cell)
+	{
+		const std::size_t begin = cellStart_[cell];
+		const std::size_t end = cellStart_[cell + 1];
+
+		for (std::size_t i = begin; i != end; ++i)
+		{
+			const Collider& first = colliders_[cellEntries_[i]];
+
+			for (std::size_t j = i + 1; j != end; ++j)
+			{
+				const Collider& second = colliders_[cellEntries_[j]];
+
+				// Skip category pairs nobody reacts to
+				if ((first.partners & second.category) == Category::None)
+				{
+					continue;
+				}
+
+				sf::FloatRect overlap;
+				if (!first.bounds.intersects(second.bounds, overlap))
+				{
+					continue;
+				}
+
+				// Colliders spanning several cells meet in each of them: only report the pair
+				// in the cell which contains the top-left corner of their overlap
+				CellRange owner = getCellRange(sf::FloatRect(overlap.left, overlap.top, 0.f, 0.f));
+				if (owner.top * columns_ + owner.left != cell)
+				{
+					continue;
+				}
+
+				collisionPairs.push_back(std::minmax(first.node, second.node));
+			}
+		}
+	}
+}
+
+SceneNode* CollisionGrid::findFirst(const sf::FloatRect& bounds, Category categories) const
+{
+	if (colliders_.empty())
+	{
+		return nullptr;
+	}
+
+	CellRange range = getCellRange(bounds);
+	for (int row = range.top; row <= range.bottom; ++row)
+	{
+		for (int column = range.left; column <= range.right; ++column)
+		{
+			const int cell = row * columns_ + column;
+			for (std::size_t i = cellStart_[cell]; i != cellStart_[cell + 1]; ++i)
+			{
+				const Collider& collider = colliders_[cellEntries_[i]];
+				if ((collider.category & categories) != Category::None && collider.bounds.intersects(bounds))
+				{
+					return collider.node;
+				}
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+std::size_t CollisionGrid::getColliderCount() const
+{
+	return colliders_.size();
+}
+
+Category CollisionGrid::getPartners(Category category) const
+{
+	Category partners = Category::None;
+
+	for (const auto& pair : collisionPairs_)
+	{
+		if ((category & pair.first) != Category::None)
+		{
+			partners = partners | pair.second;
+		}
+		if ((category & pair.second) != Category::None)
+		{
+			partners = partners | pair.first;
+		}
+	}
+
+	return partners;
+}
+
+CollisionGrid::CellRange CollisionGrid::getCellRange(const sf::FloatRect& bounds) const
+{
+	auto toColumn = [this](float x)
+		{
+			return std::clamp(static_cast<int>((x - gridBounds_.left) / cellWidth_), 0, columns_ - 1);
+		};
+
+	auto toRow = [this](float y)
+		{
+			return std::clamp(static_cast<int>((y - gridBounds_.top) / cellHeight_), 0, rows_ - 1);
+		};
+
+	return CellRange{ toColumn(bounds.left), toRow(bounds.top), toColumn(bounds.left + bounds.width), toRow(bounds.top + bounds.height) };
+}
+
+void CollisionGrid::buildCells()
+{
+	// Fit the grid to the area actually covered by colliders this frame
+	float left = colliders_.front().bounds.left;
+	float top = colliders_.front().bounds.top;
+	float right = left;
+	float bottom = top;
+
+	for (const Collider& collider : colliders_)
+	{
+		left = std::min(left, collider.bounds.left);
+		top = std::min(top, collider.bounds.top);
+		right = std::max(right, collider.bounds.left + collider.bounds.width);
+		bottom = std::max(bottom, collider.bounds.top + collider.bounds.height);
+	}
+
+	gridBounds_ = sf::FloatRect(left, top, right - left, bottom - top);
+	cellWidth_ = std::max(cellSize_, gridBounds_.width / MaxCellsPerAxis);
+	cellHeight_ = std::max(cellSize_, gridBounds_.height / MaxCellsPerAxis);
+	columns_ = std::max(1, static_cast<int>(std::ceil(gridBounds_.width / cellWidth_)));
+	rows_ = std::max(1, static_cast<int>(std::ceil(gridBounds_.height / cellHeight_)));
+
+	// Counting sort of the colliders into their cells: count, prefix sum, then scatter
+	const std::size_t cellCount = static_cast<std::size_t>(columns_ * rows_);
+	cellStart_.assign(cellCount + 1, 0);
+
+	for (const Collider& collider : colliders_)
+	{
+		CellRange range = getCellRange(collider.bounds);
+		for (int row = range.top; row <= range.bottom; ++row)
+		{
+			for (int column = range.left; column <= range.right; ++column)
+			{
+				++cellStart_[row * columns_ + column + 1];
+			}
+		}
+	}
+
+	for (std::size_t cell = 1; cell <= cellCount; ++cell)
+	{
+		cellStart_[cell] += cellStart_[cell - 1];
+	}
+
+	cellEntries_.resize(cellStart_[cellCount]);
+	cellCursor_.assign(cellStart_.begin(), cellStart_.end() - 1);
+
+	for (std::size_t index = 0; index != colliders_.size(); ++index)
+	{
+		CellRange range = getCellRange(colliders_[index].bounds);
+		for (int row = range.top; row <= range.bottom; ++row)
+		{
+			for (int column = range.left; column <= range.right; ++column)
+			{
+				cellEntries_[cellCursor_[row * columns_ + column]++] = index;
+			}
+		}
+	}
+}
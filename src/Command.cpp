@@ -1,7 +1,75 @@
+#include <cstring>
+
 #include "Command.h"
 
+CommandAction::CommandAction()
+	: buffer_{}
+	, operations_(nullptr)
+{
+}
+
+CommandAction::CommandAction(const CommandAction& other)
+	: buffer_{}
+	, operations_(other.operations_)
+{
+	copyFrom(other);
+}
+
+CommandAction& CommandAction::operator=(const CommandAction& other)
+{
+	if (this != &other)
+	{
+		reset();
+		operations_ = other.operations_;
+		copyFrom(other);
+	}
+	return *this;
+}
+
+CommandAction::~CommandAction()
+{
+	reset();
+}
+
+void CommandAction::operator() (SceneNode& node, sf::Time dt) const
+{
+	assert(operations_ != nullptr && "CommandAction - Invoking empty action");
+	operations_->invoke(buffer_, node, dt);
+}
+
+CommandAction::operator bool() const
+{
+	return operations_ != nullptr;
+}
+
+void CommandAction::copyFrom(const CommandAction& other)
+{
+	if (operations_ == nullptr)
+	{
+		return;
+	}
+
+	if (operations_->copy != nullptr)
+	{
+		operations_->copy(buffer_, other.buffer_);
+	}
+	else
+	{
+		std::memcpy(buffer_, other.buffer_, BufferSize);
+	}
+}
+
+void CommandAction::reset()
+{
+	if (operations_ != nullptr && operations_->destroy != nullptr)
+	{
+		operations_->destroy(buffer_);
+	}
+	operations_ = nullptr;
+}
+
 Command::Command()
-: action{}
-, category{ Category::None }
+	: action{}
+	, category{ Category::None }
 {
 }
@@ -1,18 +1,60 @@
 #include "CommandQueue.h"
 
+namespace
+{
+	const std::size_t InitialCapacity = 64;
+}
+
+CommandQueue::CommandQueue()
+	: buffer_(InitialCapacity)
+	, head_(0)
+	, size_(0)
+{
+}
+
 void CommandQueue::push(const Command& command)
 {
-	queue_.push(command);
+	if (size_ == buffer_.size())
+	{
+		grow();
+	}
+
+	buffer_[(head_ + size_) % buffer_.size()] = command;
+	++size_;
 }
 
-Command CommandQueue::pop()
+bool CommandQueue::pop(Command& out)
 {
-	Command command = queue_.front();
-	queue_.pop();
-	return command;
+	if (size_ == 0)
+	{
+		return false;
+	}
+
+	out = buffer_[head_];
+	head_ = (head_ + 1) % buffer_.size();
+	--size_;
+	return true;
 }
 
 bool CommandQueue::isEmpty() const
 {
-	return queue_.empty();
+	return size_ == 0;
+}
+
+std::size_t CommandQueue::getSize() const
+{
+	return size_;
+}
+
+void CommandQueue::grow()
+{
+	// Unroll the ring into a buffer of twice the size, oldest command first
+	std::vector<Command> buffer(buffer_.size() * 2);
+	for (std::size_t i = 0; i < size_; ++i)
+	{
+		buffer[i] = buffer_[(head_ + i) % buffer_.size()];
+	}
+
+	buffer_.swap(buffer);
+	head_ = 0;
 }
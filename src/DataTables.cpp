@@ -92,11 +92,60 @@ std::vector<ParticleData> initializeParticleData()
 {
 	std::vector<ParticleData> data(Particle::ParticleCount);
 
-	data[Particle::Propellant].color = sf::Color(255, 255, 50);
 	data[Particle::Propellant].lifetime = sf::seconds(0.6f);
+	data[Particle::Propellant].capacity = 1024;
+	data[Particle::Propellant].emissionRate = 30.f;
+	data[Particle::Propellant].burstCount = 0;
+	data[Particle::Propellant].speed = 0.f;
+	data[Particle::Propellant].spread = 0.f;
+	data[Particle::Propellant].startSize = 1.f;
+	data[Particle::Propellant].endSize = 1.f;
+	data[Particle::Propellant].startColor = sf::Color(255, 255, 50, 255);
+	data[Particle::Propellant].endColor = sf::Color(255, 255, 50, 0);
 
-	data[Particle::Smoke].color = sf::Color(50, 50, 50);
 	data[Particle::Smoke].lifetime = sf::seconds(4.f);
+	data[Particle::Smoke].capacity = 4096;
+	data[Particle::Smoke].emissionRate = 30.f;
+	data[Particle::Smoke].burstCount = 0;
+	data[Particle::Smoke].speed = 0.f;
+	data[Particle::Smoke].spread = 0.f;
+	data[Particle::Smoke].startSize = 1.f;
+	data[Particle::Smoke].endSize = 1.f;
+	data[Particle::Smoke].startColor = sf::Color(50, 50, 50, 255);
+	data[Particle::Smoke].endColor = sf::Color(50, 50, 50, 0);
+
+	data[Particle::Debris].lifetime = sf::seconds(1.2f);
+	data[Particle::Debris].capacity = 4096;
+	data[Particle::Debris].emissionRate = 0.f;
+	data[Particle::Debris].burstCount = 48;
+	data[Particle::Debris].speed = 180.f;
+	data[Particle::Debris].spread = 360.f;
+	data[Particle::Debris].startSize = 0.6f;
+	data[Particle::Debris].endSize = 0.2f;
+	data[Particle::Debris].startColor = sf::Color(255, 170, 60, 255);
+	data[Particle::Debris].endColor = sf::Color(60, 60, 60, 0);
+
+	data[Particle::Spark].lifetime = sf::seconds(0.3f);
+	data[Particle::Spark].capacity = 2048;
+	data[Particle::Spark].emissionRate = 0.f;
+	data[Particle::Spark].burstCount = 6;
+	data[Particle::Spark].speed = 240.f;
+	data[Particle::Spark].spread = 70.f;
+	data[Particle::Spark].startSize = 0.35f;
+	data[Particle::Spark].endSize = 0.1f;
+	data[Particle::Spark].startColor = sf::Color(255, 245, 180, 255);
+	data[Particle::Spark].endColor = sf::Color(255, 110, 0, 0);
+
+	data[Particle::EngineTrail].lifetime = sf::seconds(0.5f);
+	data[Particle::EngineTrail].capacity = 4096;
+	data[Particle::EngineTrail].emissionRate = 24.f;
+	data[Particle::EngineTrail].burstCount = 0;
+	data[Particle::EngineTrail].speed = 40.f;
+	data[Particle::EngineTrail].spread = 20.f;
+	data[Particle::EngineTrail].startSize = 0.5f;
+	data[Particle::EngineTrail].endSize = 0.9f;
+	data[Particle::EngineTrail].startColor = sf::Color(210, 225, 255, 160);
+	data[Particle::EngineTrail].endColor = sf::Color(120, 120, 150, 0);
 
 	return data;
 }
@@ -1,52 +1,51 @@
 #include "EmitterNode.h"
-#include "ParticleNode.h"
-#include "Command.h"
-#include "CommandQueue.h"
+#include "ParticleRegistry.h"
+#include "DataTables.h"
 
+namespace
+{
+	const std::vector<ParticleData> Table = initializeParticleData();
+}
 
-EmitterNode::EmitterNode(Particle::Type type)
+EmitterNode::EmitterNode(Particle::Type type, ParticleRegistry& particles, sf::Vector2f direction)
 	: SceneNode()
 	, accumulatedTime_(sf::Time::Zero)
 	, type_(type)
-	, particleSystem_(nullptr)
+	, particles_(particles)
+	, direction_(direction)
 {
+	particles_.addEmitter(*this, type_);
 }
 
-void EmitterNode::updateCurrent(sf::Time dt, CommandQueue& commands)
+EmitterNode::~EmitterNode()
 {
-	if (particleSystem_)
-	{
-		emitParticles(dt);
-	}
-	else
-	{
-		// Find particle node with the same type as emitter node
-		auto finder = [this](ParticleNode& container, sf::Time)
-			{
-				if (container.getParticleType() == type_)
-				{
-					particleSystem_ = &container;
-				}
-			};
-
-		Command command;
-		command.category = Category::ParticleSystem;
-		command.action = derivedAction<ParticleNode>(finder);
-
-		commands.push(command);
-	}
+	particles_.removeEmitter(*this, type_);
 }
 
-void EmitterNode::emitParticles(sf::Time dt)
+std::size_t EmitterNode::takeDueParticles(sf::Time dt)
 {
-	const float emissionRate = 30.f;
-	const sf::Time interval = sf::seconds(1.f) / emissionRate;
+	// Burst only types have no continuous emission
+	if (Table[type_].emissionRate <= 0.f)
+	{
+		return 0;
+	}
+
+	const sf::Time interval = sf::seconds(1.f / Table[type_].emissionRate);
+	std::size_t count = 0;
 
 	accumulatedTime_ += dt;
 
 	while (accumulatedTime_ > interval)
 	{
 		accumulatedTime_ -= interval;
-		particleSystem_->addParticle(getWorldPosition());
+		++count;
 	}
+
+	return count;
+}
+
+sf::Vector2f EmitterNode::getEmissionDirection() const
+{
+	sf::Transform transform = getWorldTransform();
+	return transform.transformPoint(direction_) - transform.transformPoint(sf::Vector2f());
 }
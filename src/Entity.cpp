@@ -75,7 +75,7 @@ bool Entity::isDestroyed() const
 	return hitpoints_ <= 0;
 }
 
-void Entity::updateCurrent(sf::Time dt, CommandQueue&)
+void Entity::integrateCurrent(sf::Time dt, CommandQueue&)
 {
 	move(velocity_ * dt.asSeconds());
 }
@@ -0,0 +1,857 @@
+#include <algorithm>
+#include <map>
+
+#include <SFML/Network/Packet.hpp>
+
+#include "GameRoom.h"
+#include "BroadcastPacket.h"
+#include "NetworkProtocol.h"
+#include "Utility.h"
+#include "Pickup.h"
+#include "Aircraft.h"
+
+namespace
+{
+	// Fixed simulation step and state broadcast interval of every room
+	const sf::Time StepInterval = sf::seconds(1.f / 60.f);
+	const sf::Time TickInterval = sf::seconds(1.f / ServerTickRate);
+
+	// All peers of a room look at the same scrolling battlefield, aircraft this far outside it are of no interest
+	const float InterestMargin = 200.f;
+
+	// A peer falls back to TCP for snapshots and input when no datagram arrived for this long
+	const sf::Time UdpTimeout = sf::seconds(1.f);
+}
+
+GameRoom::RemotePeer::RemotePeer()
+	: sendBuffer(socket)
+	, ready(false)
+	, timeOut(false)
+	, protocolVersion(0)
+	, hasSnapshotAck(false)
+	, ackedSnapshot(0)
+	, udpToken(0)
+	, udpPort(0)
+	, lastDatagramTime(sf::Time::Zero)
+	, inputSequence(0)
+{
+	socket.setBlocking(false);
+}
+
+
+GameRoom::Timing::Timing()
+	: count(0)
+	, total(sf::Time::Zero)
+	, max(sf::Time::Zero)
+{
+}
+
+void GameRoom::Timing::add(sf::Time duration)
+{
+	++count;
+	total += duration;
+	max = std::max(max, duration);
+}
+
+
+GameRoom::GameRoom(sf::Vector2f battlefieldSize, std::size_t maxConnectedPlayers)
+	: clock_()
+	, clientTimeoutTime_(sf::seconds(3.f))
+	, maxConnectedPlayers_(maxConnectedPlayers)
+	, stepTime_(sf::Time::Zero)
+	, tickTime_(sf::Time::Zero)
+	, worldHeight_(5000.f)
+	, battleFieldRect_(0.f, worldHeight_ - battlefieldSize.y, battlefieldSize.x, battlefieldSize.y)
+	, battleFieldScrollSpeed_(-50.f)
+	, aircraft_()
+	, fonts_()
+	, world_(fonts_, true)
+	, players_()
+	, peers_()
+	, aircraftIdentifierCounter_(1)
+	, udpSocket_()
+	, lastSpawnTime_(sf::Time::Zero)
+	, timeForNextSpawn_(sf::seconds(5.f))
+	, snapshots_()
+	, snapshot_()
+	, statistics_()
+{
+	// Same setup as a client receiving InitialState
+	world_.setWorldHeight(worldHeight_);
+	world_.setCurrentBattleFieldPosition(battleFieldRect_.top + battleFieldRect_.height);
+
+	// Peers learn the port with UdpChannel, without one they all stay on TCP
+	udpSocket_.setBlocking(false);
+	udpSocket_.bind(sf::Socket::AnyPort);
+}
+
+void GameRoom::addPeer(PeerPtr peer)
+{
+	// Order the new client to spawn its own plane ( player 1)
+	AircraftSlots::Handle handle = addAircraft(aircraftIdentifierCounter_++, *peer);
+
+	sf::Packet packet;
+	packet << aircraft_.get(handle).identifier;
+	packet << aircraft_.get(handle).position.x;
+	packet << aircraft_.get(handle).position.y;
+
+	broadcastMessage("New player!");
+	informWorldState(*peer);
+	notifyPlayerSpawn(handle);
+
+	sendToPeer(*peer, ServerPacketType::SpawnSelf, packet);
+	peer->ready = true;
+	peer->lastPacketTime = now(); // prevent initial timeouts
+
+	peers_.push_back(std::move(peer));
+}
+
+void GameRoom::update(sf::Time dt, const sf::SocketSelector& selector)
+{
+	handleIncomingPackets(selector);
+
+	stepTime_ += dt;
+	tickTime_ += dt;
+
+	// Fixed update step
+	while (stepTime_ > StepInterval)
+	{
+		step(StepInterval);
+		stepTime_ -= StepInterval;
+	}
+
+	// Fixed tick step
+	while (tickTime_ >= TickInterval)
+	{
+		statistics_.tickDelays.add(tickTime_ - TickInterval);
+		tick();
+		tickTime_ -= TickInterval;
+	}
+
+	// Everything the room produced during this update goes out with one send per peer
+	bool detectedStall = false;
+	for (const auto& peer : peers_)
+	{
+		peer->sendBuffer.flush();
+		statistics_.sends.add(peer->sendBuffer.takeCounters());
+
+		// A peer that keeps sending but stopped reading is dropped like one that timed out
+		if (peer->sendBuffer.isStalled())
+		{
+			peer->timeOut = true;
+			detectedStall = true;
+		}
+	}
+
+	if (detectedStall)
+	{
+		handleDisconnections();
+	}
+
+	statistics_.peerCount = peers_.size();
+}
+
+sf::Time GameRoom::getTimeUntilUpdate() const
+{
+	return std::min(StepInterval - stepTime_, TickInterval - tickTime_);
+}
+
+void GameRoom::addSocketsTo(sf::SocketSelector& selector)
+{
+	for (const auto& peer : peers_)
+	{
+		selector.add(peer->socket);
+	}
+
+	if (udpSocket_.getLocalPort() != 0)
+	{
+		selector.add(udpSocket_);
+	}
+}
+
+bool GameRoom::isFull() const
+{
+	return peers_.size() >= maxConnectedPlayers_;
+}
+
+bool GameRoom::isEmpty() const
+{
+	return peers_.empty();
+}
+
+const GameRoom::Statistics& GameRoom::getStatistics() const
+{
+	return statistics_;
+}
+
+void GameRoom::notifyPlayerRealtimeChange(const RemotePeer& origin, sf::Int32 aircraftIdentifier, sf::Int32 action, bool actionEnabled)
+{
+	sf::Packet packet;
+	packet << aircraftIdentifier << action << actionEnabled;
+
+	// The origin already applies its own realtime input locally, UDP peers get the actions with every snapshot
+	BroadcastPacket broadcast(ServerPacketType::PlayerRealtimeChange, packet);
+	for (const auto& peer : peers_)
+	{
+		if (peer->ready && peer.get() != &origin && !isUsingUdp(*peer))
+		{
+			broadcast.send(peer->sendBuffer, peer->protocolVersion);
+		}
+	}
+}
+
+void GameRoom::notifyPlayerEvent(sf::Int32 aircraftIdentifier, sf::Int32 action)
+{
+	sf::Packet packet;
+	packet << aircraftIdentifier << action;
+
+	sendToAll(ServerPacketType::PlayerEvent, packet);
+}
+
+void GameRoom::notifyPlayerSpawn(AircraftSlots::Handle handle)
+{
+	const AircraftSlots::Aircraft& info = aircraft_.get(handle);
+
+	sf::Packet packet;
+	packet << info.identifier;
+	packet << info.position.x << info.position.y;
+
+	sendToAll(ServerPacketType::PlayerConnect, packet);
+}
+
+void GameRoom::step(sf::Time dt)
+{
+	sf::Clock stepClock;
+
+	battleFieldRect_.top += battleFieldScrollSpeed_ * dt.asSeconds();
+
+	// Relayed realtime actions move and fire the aircraft, exactly as on the clients
+	CommandQueue& commands = world_.getCommandQueue();
+	for (const auto& player : players_)
+	{
+		if (player)
+		{
+			player->handleRealtimeNetworkInput(commands);
+		}
+	}
+
+	world_.update(dt);
+	handleGameActions();
+
+	// Read back the authoritative state, aircraft destroyed in the world are removed in the next tick
+	aircraft_.forEach([&](AircraftSlots::Handle, AircraftSlots::Aircraft& info)
+	{
+		if (Aircraft* aircraft = world_.getAircraft(info.identifier))
+		{
+			info.position = aircraft->getPosition();
+			info.hitpoints = aircraft->getHitpoints();
+			info.missileAmmo = aircraft->getMissileAmmo();
+		}
+		else
+		{
+			info.hitpoints = 0;
+		}
+	});
+
+	statistics_.steps.add(stepClock.getElapsedTime());
+}
+
+void GameRoom::tick()
+{
+	sf::Clock tickClock;
+
+	updateClientState();
+
+	// Check for mission success = all planes with position.y < offset
+	bool allAircraftDone = true;
+	aircraft_.forEach([&](AircraftSlots::Handle, const AircraftSlots::Aircraft& info)
+	{
+		allAircraftDone = allAircraftDone && info.position.y <= 0.f;
+	});
+
+	if (allAircraftDone)
+	{
+		sendToAll(ServerPacketType::MissionSuccess, sf::Packet());
+	}
+
+	// Remove IDs of aircraft that have been destroyed (relevant if a client has two, and loses one).
+	// The server world decides, so every client is told: the owner loses its aircraft, the others their copy.
+	aircraft_.forEach([&](AircraftSlots::Handle handle, const AircraftSlots::Aircraft& info)
+	{
+		if (info.hitpoints <= 0)
+		{
+			sf::Packet packet;
+			packet << info.identifier;
+			sendToAll(ServerPacketType::PlayerDisconnect, packet);
+
+			for (const auto& peer : peers_)
+			{
+				std::vector<sf::Int32>& identifiers = peer->aircraftIdentifiers;
+				identifiers.erase(std::remove(identifiers.begin(), identifiers.end(), info.identifier), identifiers.end());
+			}
+
+			removeAircraft(handle);
+		}
+	});
+
+	// Check if its time to attempt to spawn enemies
+	if (now() >= timeForNextSpawn_ + lastSpawnTime_)
+	{
+		// No more enemies are spawned near the end
+		if (battleFieldRect_.top > 600.f)
+		{
+			std::size_t enemyCount = 1u + randomInt(2);
+			float spawnCenter = static_cast<float>(randomInt(500) - 250);
+
+			// In case only one enemy is spawned, it appears directly at the spawnCenter
+			float planeDistance = 0.f;
+			float nextSpawnPosition = spawnCenter;
+
+			// In case there are two enemies being spawned together, each is spawned at each side of the spawnCenter, with a minimum distance
+			if (enemyCount == 2)
+			{
+				planeDistance = static_cast<float>(randomInt(250) + 150);
+				nextSpawnPosition = spawnCenter - planeDistance / 2.f;
+			}
+
+			// Send the spawn orders to all clients
+			for (std::size_t i = 0; i != enemyCount; ++i)
+			{
+				sf::Int32 enemyType = 1 + randomInt(Aircraft::TypeCount - 1);
+				float spawnHeight = worldHeight_ - battleFieldRect_.top + 500;
+
+				sf::Packet packet;
+				packet << enemyType << spawnHeight << nextSpawnPosition;
+
+				world_.addEnemy(static_cast<Aircraft::Type>(enemyType), nextSpawnPosition, spawnHeight);
+				nextSpawnPosition += planeDistance / 2.f;
+
+				sendToAll(ServerPacketType::SpawnEnemy, packet);
+			}
+			world_.sortEnemies();
+
+			lastSpawnTime_ = now();
+			timeForNextSpawn_ = sf::milliseconds(2000 + randomInt(6000));
+		}
+	}
+
+	statistics_.ticks.add(tickClock.getElapsedTime());
+}
+
+AircraftSlots::Handle GameRoom::addAircraft(sf::Int32 aircraftIdentifier, RemotePeer& peer)
+{
+	AircraftSlots::Handle handle = aircraft_.add(aircraftIdentifier);
+	AircraftSlots::Aircraft& info = aircraft_.get(handle);
+	info.position = sf::Vector2f(battleFieldRect_.width / 2, battleFieldRect_.top + battleFieldRect_.height / 2);
+	info.hitpoints = 100;
+	info.missileAmmo = 2;
+
+	world_.addAircraft(aircraftIdentifier)->setPosition(info.position);
+
+	// Without a key binding the player only replays the actions relayed from its peer
+	if (handle >= players_.size())
+	{
+		players_.resize(handle + 1);
+	}
+	players_[handle].reset(new Player(&peer.sendBuffer, aircraftIdentifier, nullptr));
+	peer.aircraftIdentifiers.push_back(aircraftIdentifier);
+
+	return handle;
+}
+
+void GameRoom::removeAircraft(AircraftSlots::Handle handle)
+{
+	world_.removeAircraft(aircraft_.get(handle).identifier);
+	players_[handle].reset();
+	aircraft_.remove(handle);
+}
+
+void GameRoom::handleGameActions()
+{
+	// Enemies explode in the server world, so every client gets the same pickups
+	GameActions::Action gameAction;
+	while (world_.pollGameAction(gameAction))
+	{
+		if (gameAction.type == GameActions::EnemyExplode && randomInt(3) == 0)
+		{
+			sf::Int32 type = randomInt(Pickup::TypeCount);
+			world_.createPickup(gameAction.position, static_cast<Pickup::Type>(type));
+
+			sf::Packet packet;
+			packet << type << gameAction.position.x << gameAction.position.y;
+			sendToAll(ServerPacketType::SpawnPickup, packet);
+		}
+	}
+}
+
+sf::Time GameRoom::now() const
+{
+	return clock_.getElapsedTime();
+}
+
+void GameRoom::handleIncomingPackets(const sf::SocketSelector& selector)
+{
+	bool detectedTimeout = false;
+
+	// Datagrams first, they keep their peers from timing out as well
+	if (udpSocket_.getLocalPort() != 0 && selector.isReady(udpSocket_))
+	{
+		handleIncomingDatagrams();
+	}
+
+	for (const auto& peer : peers_)
+	{
+		if (peer->ready)
+		{
+			// Only sockets flagged by the last selector wait have data, the others just need the timeout check
+			if (selector.isReady(peer->socket))
+			{
+				sf::Packet packet;
+				while (peer->socket.receive(packet) == sf::Socket::Done)
+				{
+					// Interpret packet and react to it
+					handleIncomingPacket(packet, *peer, detectedTimeout);
+
+					// Packet was indeed received, update the ping timer
+					peer->lastPacketTime = now();
+					packet.clear();
+				}
+			}
+
+			if (now() >= peer->lastPacketTime + clientTimeoutTime_)
+			{
+				peer->timeOut = true;
+				detectedTimeout = true;
+			}
+		}
+	}
+
+	if (detectedTimeout)
+	{
+		handleDisconnections();
+	}
+}
+
+void GameRoom::handleIncomingPacket(sf::Packet& packet, RemotePeer& receivingPeer, bool& detectedTimeout)
+{
+	sf::Int32 packetType;
+	packet >> packetType;
+
+	switch (static_cast<ClientPacketType>(packetType))
+	{
+	case ClientPacketType::Quit:
+	{
+		receivingPeer.timeOut = true;
+		detectedTimeout = true;
+	}
+	break;
+
+	case ClientPacketType::PlayerEvent:
+	{
+		sf::Int32 aircraftIdentifier;
+		sf::Int32 action;
+		packet >> aircraftIdentifier >> action;
+
+		AircraftSlots::Handle handle = aircraft_.find(aircraftIdentifier);
+		if (handle != AircraftSlots::InvalidHandle)
+		{
+			players_[handle]->handleNetworkEvent(static_cast<Player::Action>(action), world_.getCommandQueue());
+		}
+		notifyPlayerEvent(aircraftIdentifier, action);
+	}
+	break;
+
+	case ClientPacketType::PlayerRealtimeChange:
+	{
+		sf::Int32 aircraftIdentifier;
+		sf::Int32 action;
+		bool actionEnabled;
+		packet >> aircraftIdentifier >> action >> actionEnabled;
+
+		// The datagrams carry the full input state, a change still in the TCP stream may already be outdated
+		if (isUsingUdp(receivingPeer))
+		{
+			break;
+		}
+
+		AircraftSlots::Handle handle = aircraft_.find(aircraftIdentifier);
+		if (handle != AircraftSlots::InvalidHandle)
+		{
+			players_[handle]->handleNetworkRealtimeChange(static_cast<Player::Action>(action), actionEnabled);
+		}
+		notifyPlayerRealtimeChange(receivingPeer, aircraftIdentifier, action, actionEnabled);
+	}
+	break;
+
+	case ClientPacketType::RequestCoopPartner:
+	{
+		const AircraftSlots::Aircraft& info = aircraft_.get(addAircraft(aircraftIdentifierCounter_++, receivingPeer));
+
+		sf::Packet requestPacket;
+		requestPacket << info.identifier
+			<< info.position.x
+			<< info.position.y;
+
+		sendToPeer(receivingPeer, ServerPacketType::AcceptCoopPartner, requestPacket);
+
+		for (const auto& peer : peers_)
+		{
+			if (peer.get() != &receivingPeer && peer->ready)
+			{
+				sf::Packet notifyPacket;
+				notifyPacket << info.identifier
+					<< info.position.x
+					<< info.position.y;
+				sendToPeer(*peer, ServerPacketType::PlayerConnect, notifyPacket);
+			}
+		}
+	}
+	break;
+
+	// The server world is authoritative: client positions, hitpoints and explosions are no longer taken over.
+	// Only clients of the original protocol still send them.
+	case ClientPacketType::PositionUpdate:
+	case ClientPacketType::GameEvent:
+	break;
+
+	case ClientPacketType::ProtocolHello:
+	{
+		sf::Uint8 clientVersion;
+		packet >> clientVersion;
+
+		// The accept still goes out in the old framing, everything after it uses the agreed version
+		sf::Packet acceptPacket;
+		acceptPacket << std::min(clientVersion, ProtocolVersion);
+		sendToPeer(receivingPeer, ServerPacketType::ProtocolAccept, acceptPacket);
+
+		receivingPeer.protocolVersion = std::min(clientVersion, ProtocolVersion);
+		if (receivingPeer.protocolVersion >= 2)
+		{
+			offerUdpChannel(receivingPeer);
+		}
+	}
+	break;
+
+	case ClientPacketType::SnapshotAck:
+	{
+		packet >> receivingPeer.ackedSnapshot;
+		receivingPeer.hasSnapshotAck = true;
+	}
+	break;
+	}
+}
+
+void GameRoom::updateClientState()
+{
+	// Version 0 peers: full state with Int32 identifiers and float positions
+	sf::Packet updateClientStatePacket;
+	updateClientStatePacket << static_cast<float>(battleFieldRect_.top + battleFieldRect_.height);
+
+	sf::Int32 interestingCount = 0;
+	aircraft_.forEach([&](AircraftSlots::Handle, const AircraftSlots::Aircraft& info)
+	{
+		interestingCount += isOfInterest(info.position) ? 1 : 0;
+	});
+	updateClientStatePacket << interestingCount;
+
+	aircraft_.forEach([&](AircraftSlots::Handle, const AircraftSlots::Aircraft& info)
+	{
+		if (isOfInterest(info.position))
+		{
+			updateClientStatePacket << info.identifier
+				<< info.position.x
+				<< info.position.y;
+		}
+	});
+
+	// Version 1 peers: quantized snapshot with the hitpoints and ammo of the server world, delta encoded
+	// against the last one each peer acknowledged
+	++snapshot_.sequence;
+	snapshot_.battleFieldPosition = Snapshot::quantize(battleFieldRect_.top + battleFieldRect_.height);
+	snapshot_.entries.clear();
+	aircraft_.forEach([&](AircraftSlots::Handle, const AircraftSlots::Aircraft& info)
+	{
+		if (isOfInterest(info.position))
+		{
+			snapshot_.setAircraft(info.identifier, info.position, info.hitpoints, info.missileAmmo);
+		}
+	});
+	snapshots_.add(snapshot_);
+
+	// Realtime actions of every aircraft ride along with the snapshot datagrams
+	sf::Packet realtimeActions;
+	realtimeActions << static_cast<sf::Uint8>(aircraft_.getSize());
+	aircraft_.forEach([&](AircraftSlots::Handle handle, const AircraftSlots::Aircraft& info)
+	{
+		realtimeActions << info.identifier << players_[handle]->getRealtimeActions();
+	});
+
+	// Most peers acknowledged the same snapshot, so each base is written and framed once per tick
+	BroadcastPacket updateClientState(ServerPacketType::UpdateClientState, updateClientStatePacket);
+	std::map<sf::Uint16, sf::Packet> snapshotPayloads;
+	std::map<sf::Uint16, BroadcastPacket> snapshotPackets;
+	std::map<sf::Uint16, sf::Packet> snapshotDatagrams;
+
+	for (const auto& peer : peers_)
+	{
+		if (!peer->ready)
+		{
+			continue;
+		}
+
+		if (peer->protocolVersion >= 1)
+		{
+			const Snapshot* base = peer->hasSnapshotAck ? snapshots_.find(peer->ackedSnapshot) : nullptr;
+
+			// A full snapshot names itself as its base
+			sf::Uint16 baseSequence = base ? base->sequence : snapshot_.sequence;
+			auto payload = snapshotPayloads.find(baseSequence);
+			if (payload == snapshotPayloads.end())
+			{
+				payload = snapshotPayloads.emplace(baseSequence, sf::Packet()).first;
+				snapshot_.write(payload->second, base);
+			}
+
+			if (isUsingUdp(*peer))
+			{
+				// A lost datagram is not resent, the next snapshot replaces it without waiting
+				sf::Packet& datagram = snapshotDatagrams[baseSequence];
+				if (datagram.getDataSize() == 0)
+				{
+					writeServerPacketType(datagram, ServerPacketType::Snapshot, peer->protocolVersion);
+					datagram.append(payload->second.getData(), payload->second.getDataSize());
+					datagram.append(realtimeActions.getData(), realtimeActions.getDataSize());
+				}
+
+				udpSocket_.send(datagram.getData(), datagram.getDataSize(), peer->socket.getRemoteAddress(), peer->udpPort);
+			}
+			else
+			{
+				auto packet = snapshotPackets.find(baseSequence);
+				if (packet == snapshotPackets.end())
+				{
+					packet = snapshotPackets.emplace(baseSequence, BroadcastPacket(ServerPacketType::Snapshot, payload->second)).first;
+				}
+
+				packet->second.send(peer->sendBuffer, peer->protocolVersion);
+			}
+		}
+		else
+		{
+			updateClientState.send(peer->sendBuffer, peer->protocolVersion);
+		}
+	}
+}
+
+void GameRoom::handleDisconnections()
+{
+	for (auto itr = peers_.begin(); itr != peers_.end();)
+	{
+		if ((*itr)->timeOut)
+		{
+			// Infore everyone of the disconnection, erase
+			for (const auto& identifier : (*itr)->aircraftIdentifiers)
+			{
+				sf::Packet packet;
+				packet << identifier;
+				sendToAll(ServerPacketType::PlayerDisconnect, packet);
+
+				// Destroyed aircraft are already gone
+				AircraftSlots::Handle handle = aircraft_.find(identifier);
+				if (handle != AircraftSlots::InvalidHandle)
+				{
+					removeAircraft(handle);
+				}
+			}
+
+			statistics_.sends.add((*itr)->sendBuffer.takeCounters());
+			itr = peers_.erase(itr);
+
+			// The lobby sees the free slot and listens again if needed
+			broadcastMessage("An ally has disconnected.");
+		}
+		else
+		{
+			++itr;
+		}
+	}
+}
+
+void GameRoom::offerUdpChannel(RemotePeer& peer)
+{
+	if (udpSocket_.getLocalPort() == 0)
+	{
+		return;
+	}
+
+	// Datagrams are matched to the peer by this token and the address of its TCP connection
+	do
+	{
+		peer.udpToken = static_cast<sf::Uint32>(randomInt(0x10000)) << 16 | static_cast<sf::Uint32>(randomInt(0x10000));
+	} while (peer.udpToken == 0);
+
+	sf::Packet packet;
+	packet << udpSocket_.getLocalPort() << peer.udpToken;
+	sendToPeer(peer, ServerPacketType::UdpChannel, packet);
+}
+
+void GameRoom::handleIncomingDatagrams()
+{
+	sf::Packet packet;
+	sf::IpAddress sender;
+	unsigned short port;
+	while (udpSocket_.receive(packet, sender, port) == sf::Socket::Done)
+	{
+		handleIncomingDatagram(packet, sender, port);
+	}
+}
+
+void GameRoom::handleIncomingDatagram(sf::Packet& packet, const sf::IpAddress& sender, unsigned short port)
+{
+	sf::Uint32 token;
+	sf::Uint16 inputSequence;
+	bool hasSnapshotAck;
+	sf::Uint16 ackedSnapshot;
+	sf::Uint8 aircraftCount;
+	if (!(packet >> token >> inputSequence >> hasSnapshotAck >> ackedSnapshot >> aircraftCount))
+	{
+		return;
+	}
+
+	auto found = std::find_if(peers_.begin(), peers_.end(), [&](const PeerPtr& peer)
+	{
+		return peer->ready && peer->udpToken != 0 && peer->udpToken == token && peer->socket.getRemoteAddress() == sender;
+	});
+	if (found == peers_.end())
+	{
+		return;
+	}
+
+	RemotePeer& peer = **found;
+	bool isFirstDatagram = peer.udpPort == 0;
+	peer.udpPort = port;
+	peer.lastDatagramTime = now();
+	peer.lastPacketTime = now();
+
+	// Every datagram has the full input state, one overtaken by a newer one is outdated
+	if (!isFirstDatagram && static_cast<sf::Int16>(inputSequence - peer.inputSequence) <= 0)
+	{
+		return;
+	}
+	peer.inputSequence = inputSequence;
+
+	if (hasSnapshotAck)
+	{
+		peer.hasSnapshotAck = true;
+		peer.ackedSnapshot = ackedSnapshot;
+	}
+
+	for (sf::Uint8 i = 0; i < aircraftCount; ++i)
+	{
+		sf::Int32 aircraftIdentifier;
+		sf::Uint8 actions;
+		if (!(packet >> aircraftIdentifier >> actions))
+		{
+			break;
+		}
+
+		if (std::find(peer.aircraftIdentifiers.begin(), peer.aircraftIdentifiers.end(), aircraftIdentifier) != peer.aircraftIdentifiers.end())
+		{
+			applyRealtimeActions(peer, aircraftIdentifier, actions);
+		}
+	}
+}
+
+void GameRoom::applyRealtimeActions(const RemotePeer& origin, sf::Int32 aircraftIdentifier, sf::Uint8 actions)
+{
+	AircraftSlots::Handle handle = aircraft_.find(aircraftIdentifier);
+	if (handle == AircraftSlots::InvalidHandle)
+	{
+		return;
+	}
+
+	sf::Uint8 changedActions = players_[handle]->getRealtimeActions() ^ actions;
+	players_[handle]->handleNetworkRealtimeActions(actions);
+
+	// Peers without a UDP channel still get the changes one by one
+	for (sf::Int32 action = 0; action < 8; ++action)
+	{
+		if (changedActions & (1 << action))
+		{
+			notifyPlayerRealtimeChange(origin, aircraftIdentifier, action, (actions & (1 << action)) != 0);
+		}
+	}
+}
+
+bool GameRoom::isUsingUdp(const RemotePeer& peer) const
+{
+	return peer.udpPort != 0 && now() < peer.lastDatagramTime + UdpTimeout;
+}
+
+// Tell the newly connected peer about how the world is currently
+void GameRoom::informWorldState(RemotePeer& peer)
+{
+	sf::Packet packet;
+	packet << worldHeight_ << battleFieldRect_.top + battleFieldRect_.height;
+
+	// Every aircraft except the peer's own, which it spawns with SpawnSelf
+	auto isOwnAircraft = [&](const AircraftSlots::Aircraft& info)
+	{
+		return std::find(peer.aircraftIdentifiers.begin(), peer.aircraftIdentifiers.end(), info.identifier) != peer.aircraftIdentifiers.end();
+	};
+
+	sf::Int32 aircraftCount = 0;
+	aircraft_.forEach([&](AircraftSlots::Handle, const AircraftSlots::Aircraft& info)
+	{
+		aircraftCount += isOwnAircraft(info) ? 0 : 1;
+	});
+	packet << aircraftCount;
+
+	aircraft_.forEach([&](AircraftSlots::Handle, const AircraftSlots::Aircraft& info)
+	{
+		if (!isOwnAircraft(info))
+		{
+			packet << info.identifier
+				<< info.position.x
+				<< info.position.y
+				<< info.hitpoints
+				<< info.missileAmmo;
+		}
+	});
+
+	sendToPeer(peer, ServerPacketType::InitialState, packet);
+}
+
+void GameRoom::broadcastMessage(const std::string& message)
+{
+	sf::Packet packet;
+	packet << message;
+
+	sendToAll(ServerPacketType::BroadcastMessage, packet);
+}
+
+void GameRoom::sendToPeer(RemotePeer& peer, ServerPacketType type, const sf::Packet& payload)
+{
+	BroadcastPacket(type, payload).send(peer.sendBuffer, peer.protocolVersion);
+}
+
+void GameRoom::sendToAll(ServerPacketType type, const sf::Packet& payload)
+{
+	// Framed once per protocol version, not once per peer
+	BroadcastPacket packet(type, payload);
+	for (const auto& peer : peers_)
+	{
+		if (peer->ready)
+		{
+			packet.send(peer->sendBuffer, peer->protocolVersion);
+		}
+	}
+}
+
+bool GameRoom::isOfInterest(sf::Vector2f position) const
+{
+	sf::FloatRect interestRect(battleFieldRect_.left - InterestMargin, battleFieldRect_.top - InterestMargin,
+		battleFieldRect_.width + 2.f * InterestMargin, battleFieldRect_.height + 2.f * InterestMargin);
+
+	return interestRect.contains(position);
+}
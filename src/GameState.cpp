@@ -7,6 +7,9 @@ GameState::GameState(StateStack& stack, Context context)
 	, world_(*context.window, *context.fonts, *context.sounds, false)
 	, player_(nullptr, 1, context.keys1)
 {
+	world_.setProfiler(context.profiler);
+	world_.setThreadPool(context.threadPool);
+	world_.setGraphicsSettings(context.graphics);
 	world_.addAircraft(1);
 	player_.setMissionStatus(Player::MissionRunning);
 
@@ -16,7 +19,7 @@ GameState::GameState(StateStack& stack, Context context)
 
 void GameState::draw()
 {
-	world_.draw();
+	world_.draw(getRenderAlpha());
 }
 
 bool GameState::update(sf::Time dt)
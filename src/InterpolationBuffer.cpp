@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+#include "InterpolationBuffer.h"
+#include "NetworkProtocol.h"
+
+namespace
+{
+	// Estimates further off than this are not drift but a stalled connection or a restarted server
+	const sf::Time ResynchronizeThreshold = sf::milliseconds(250);
+
+	// Share of the error corrected per snapshot that arrived later than expected
+	const float ClockCorrection = 0.01f;
+}
+
+InterpolationBuffer::InterpolationBuffer()
+	: entries_()
+	, head_(0)
+	, size_(0)
+{
+}
+
+void InterpolationBuffer::push(sf::Time time, sf::Vector2f position)
+{
+	if (size_ > 0)
+	{
+		const Entry& newest = getEntry(size_ - 1);
+		if (time < newest.time)
+		{
+			return;
+		}
+
+		if (time == newest.time)
+		{
+			entries_[(head_ + Capacity - 1) % Capacity].position = position;
+			return;
+		}
+	}
+
+	entries_[head_] = Entry{ time, position };
+	head_ = (head_ + 1) % Capacity;
+	size_ = std::min(size_ + 1, Capacity);
+}
+
+sf::Vector2f InterpolationBuffer::sample(sf::Time time, sf::Time maxExtrapolation) const
+{
+	assert(size_ > 0 && "InterpolationBuffer::sample - Buffer is empty");
+
+	const Entry& newest = getEntry(size_ - 1);
+	if (time >= newest.time)
+	{
+		if (size_ < 2)
+		{
+			return newest.position;
+		}
+
+		const Entry& previous = getEntry(size_ - 2);
+		sf::Vector2f velocity = (newest.position - previous.position) / (newest.time - previous.time).asSeconds();
+		return newest.position + velocity * std::min(time - newest.time, maxExtrapolation).asSeconds();
+	}
+
+	if (time <= getEntry(0).time)
+	{
+		return getEntry(0).position;
+	}
+
+	// The render time trails the newest state by a few ticks, so search from the back
+	std::size_t index = size_ - 1;
+	while (getEntry(index - 1).time > time)
+	{
+		--index;
+	}
+
+	const Entry& from = getEntry(index - 1);
+	const Entry& to = getEntry(index);
+	float ratio = (time - from.time).asSeconds() / (to.time - from.time).asSeconds();
+	return from.position + (to.position - from.position) * ratio;
+}
+
+bool InterpolationBuffer::isEmpty() const
+{
+	return size_ == 0;
+}
+
+const InterpolationBuffer::Entry& InterpolationBuffer::getEntry(std::size_t index) const
+{
+	return entries_[(head_ + Capacity - size_ + index) % Capacity];
+}
+
+ServerClock::ServerClock()
+	: isSynchronized_(false)
+	, lastSequence_(0)
+	, tick_(0)
+	, offset_(sf::Time::Zero)
+{
+}
+
+sf::Time ServerClock::synchronize(sf::Uint16 sequence, sf::Time localTime)
+{
+	// Sequence numbers wrap after 65536 ticks, their difference does not
+	if (isSynchronized_)
+	{
+		tick_ += static_cast<sf::Int16>(sequence - lastSequence_);
+	}
+	else
+	{
+		tick_ = sequence;
+	}
+	lastSequence_ = sequence;
+
+	sf::Time serverTime = sf::seconds(tick_ / ServerTickRate);
+	sf::Time offset = serverTime - localTime;
+
+	// The least delayed snapshot gives the best estimate, later ones only pull it back slowly in case the latency grew
+	if (!isSynchronized_ || offset > offset_ || std::abs((offset - offset_).asMicroseconds()) > ResynchronizeThreshold.asMicroseconds())
+	{
+		offset_ = offset;
+		isSynchronized_ = true;
+	}
+	else
+	{
+		offset_ += (offset - offset_) * ClockCorrection;
+	}
+
+	return serverTime;
+}
+
+sf::Time ServerClock::getTime(sf::Time localTime) const
+{
+	return localTime + offset_;
+}
+
+bool ServerClock::isSynchronized() const
+{
+	return isSynchronized_;
+}
@@ -1,12 +1,30 @@
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Network/IpAddress.hpp>
 
+#include <algorithm>
 #include <fstream>
 
 #include "MultiplayerGameState.h"
 #include "Utility.h"
 #include "MusicPlayer.h"
 
+namespace
+{
+	// Time a frame may spend handling server packets, bursts beyond it are spread over the next frames
+	const sf::Time PacketBudget = sf::milliseconds(4);
+
+	// Two server ticks: the next state has almost always arrived when an aircraft is drawn
+	const sf::Time DefaultInterpolationDelay = sf::milliseconds(100);
+
+	// Remote aircraft keep their last velocity this long when states stop arriving, then they stop
+	const sf::Time MaxExtrapolation = sf::milliseconds(250);
+
+	// Half a second of steps: a server state older than that no longer matches any predicted position
+	const std::size_t PredictionHistory = 30;
+
+	// Distance of the server position to the prediction that still counts as agreeing, two steps at full speed
+	const float ReconciliationTolerance = 8.f;
+}
 
 sf::IpAddress getAddressFromFile()
 {
@@ -27,12 +45,33 @@ sf::IpAddress getAddressFromFile()
 	return localAddress;
 }
 
+// Optional "loss% latencyMs jitterMs" to try the transports on loopback, without the file the link is not simulated
+NetworkSimulator::Settings getNetworkSimulationFromFile()
+{
+	NetworkSimulator::Settings settings;
+
+	std::ifstream inputFile("netsim.txt");
+	float lossPercent = 0.f;
+	sf::Int32 latency = 0;
+	sf::Int32 jitter = 0;
+	if (inputFile >> lossPercent >> latency >> jitter)
+	{
+		settings.lossRate = lossPercent / 100.f;
+		settings.latency = sf::milliseconds(latency);
+		settings.jitter = sf::milliseconds(jitter);
+	}
+
+	return settings;
+}
+
 
 MultiplayerGameState::MultiplayerGameState(StateStack& stack, Context context, bool isHost)
 	: State(stack, context)
 	, world_(*context.window, *context.fonts, *context.sounds, true)
 	, window_(*context.window)
 	, textureHolder_(*context.textures)
+	, sendBuffer_(socket_)
+	, incomingPackets_()
 	, isConnected_(false)
 	, gameServer_(nullptr)
 	, isActiveState_(true)
@@ -41,7 +80,29 @@ MultiplayerGameState::MultiplayerGameState(StateStack& stack, Context context, b
 	, isGameStarted_(false)
 	, clientTimeout_(sf::seconds(2.f))
 	, timeSinceLastPacket_(sf::Time::Zero)
+	, protocolVersion_(0)
+	, snapshots_()
+	, snapshot_()
+	, receivedSnapshot_()
+	, remoteAircraftStates_()
+	, serverClock_()
+	, networkTime_(sf::Time::Zero)
+	, interpolationDelay_(DefaultInterpolationDelay)
+	, predictedPositions_()
+	, udpSocket_()
+	, serverUdpPort_(0)
+	, udpToken_(0)
+	, inputSequence_(0)
+	, hasSnapshot_(false)
+	, sentRealtimeActions_()
+	, streamSimulator_(NetworkSimulator::Stream)
+	, datagramSimulator_(NetworkSimulator::Datagram)
 {
+	world_.setProfiler(context.profiler);
+	world_.setThreadPool(context.threadPool);
+	world_.setGraphicsSettings(context.graphics);
+	setNetworkSimulation(getNetworkSimulationFromFile());
+
 	broadcastText_.setFont(context.fonts->get(Fonts::Main));
 	broadcastText_.setPosition(1024.f / 2, 100.f);
 
@@ -80,6 +141,12 @@ MultiplayerGameState::MultiplayerGameState(StateStack& stack, Context context, b
 	if (socket_.connect(ip, ServerPort, sf::seconds(5.f)) == sf::TcpSocket::Done)
 	{
 		isConnected_ = true;
+
+		// Offer the compact protocol, servers which do not know it ignore the packet and keep version 0
+		sf::Packet helloPacket;
+		helloPacket << static_cast<sf::Int32>(ClientPacketType::ProtocolHello) << ProtocolVersion;
+		sendBuffer_.append(helloPacket);
+		sendBuffer_.flush();
 	}
 	else
 	{
@@ -97,7 +164,7 @@ void MultiplayerGameState::draw()
 {
 	if (isConnected_)
 	{
-		world_.draw();
+		world_.draw(getRenderAlpha());
 
 		// Broadcast message in default view
 		window_.setView(window_.getDefaultView());
@@ -131,7 +198,8 @@ void MultiplayerGameState::onDestroy()
 		sf::Packet packet;
 		packet << static_cast<sf::Int32>(ClientPacketType::Quit);
 
-		socket_.send(packet);
+		sendBuffer_.append(packet);
+		sendBuffer_.flush();
 	}
 }
 
@@ -141,6 +209,8 @@ bool MultiplayerGameState::update(sf::Time dt)
 	if (isConnected_)
 	{
 		world_.update(dt);
+		networkTime_ += dt;
+		recordPredictedPositions();
 
 		// Remove players whose aircrafts were destroyed
 		bool foundLocalPlayer = false;
@@ -191,29 +261,30 @@ bool MultiplayerGameState::update(sf::Time dt)
 			player.second->handleRealtimeNetworkInput(commands);
 		}
 
-		// Handle messages from the server that may have arrived
-		sf::Packet packet;
-		if (socket_.receive(packet) == sf::Socket::Done)
+		// Input changes go out at once, the regular tick below repeats them in case the datagram is lost
+		if (haveRealtimeActionsChanged())
+		{
+			sendInputDatagram();
+		}
+
+		// Handle messages from the server that may have arrived, with the UDP channel open the stream may be quiet
+		std::size_t receivedPackets = receiveIncomingPackets();
+		receivedPackets += receiveIncomingDatagrams();
+		if (receivedPackets > 0)
 		{
 			timeSinceLastPacket_ = sf::seconds(0.f);
-			sf::Int32 packetType;
-			packet >> packetType;
-			handlePacket(packetType, packet);
 		}
 		else
 		{
 			// Check for timeout with the server
 			if (timeSinceLastPacket_ > clientTimeout_)
 			{
-				isConnected_ = false;
-
-				failedConnectionText_.setString("Lost connection to the server!");
-				centerOrigin(failedConnectionText_);
-
-				failedConnectionClock_.restart();
+				loseConnection();
 			}
 		}
 
+		interpolateRemoteAircraft();
+
 		updateBroadcastMessage(dt);
 
 		// Time counter for blinking 2nd player text
@@ -223,44 +294,69 @@ bool MultiplayerGameState::update(sf::Time dt)
 			playerInvitationTime_ = sf::Time::Zero;
 		}
 
-		// Events occurring in the game
+		// Events occurring in the game. A server that negotiated the protocol simulates them itself,
+		// only one that never answered the hello takes them over from the clients.
 		GameActions::Action gameAction;
 		while (world_.pollGameAction(gameAction))
 		{
-			sf::Packet gameActionPacket;
-			gameActionPacket << static_cast<sf::Int32>(ClientPacketType::GameEvent);
-			gameActionPacket << static_cast<sf::Int32>(gameAction.type);
-			gameActionPacket << gameAction.position.x;
-			gameActionPacket << gameAction.position.y;
+			if (protocolVersion_ == 0)
+			{
+				sf::Packet gameActionPacket;
+				gameActionPacket << static_cast<sf::Int32>(ClientPacketType::GameEvent);
+				gameActionPacket << static_cast<sf::Int32>(gameAction.type);
+				gameActionPacket << gameAction.position.x;
+				gameActionPacket << gameAction.position.y;
 
-			socket_.send(gameActionPacket);
+				sendBuffer_.append(gameActionPacket);
+			}
 		}
 
-		// Reguler position update
+		// Reguler position update, only for servers without their own world like the game events
 		if (tickClock_.getElapsedTime() > sf::seconds(1.f / 20.f))
 		{
-			sf::Packet positionUpdatePacket;
-			positionUpdatePacket << static_cast<sf::Int32>(ClientPacketType::PositionUpdate);
-			positionUpdatePacket << static_cast<sf::Int32>(localPlayerIdentifiers_.size());
-
-			for (const auto& identifier : localPlayerIdentifiers_)
+			if (protocolVersion_ == 0)
 			{
-				Aircraft* aircraft = world_.getAircraft(identifier);
-				if (aircraft)
+				sf::Packet positionUpdatePacket;
+				positionUpdatePacket << static_cast<sf::Int32>(ClientPacketType::PositionUpdate);
+				positionUpdatePacket << static_cast<sf::Int32>(localPlayerIdentifiers_.size());
+
+				for (const auto& identifier : localPlayerIdentifiers_)
 				{
-					positionUpdatePacket << identifier;
-					positionUpdatePacket << aircraft->getPosition().x;
-					positionUpdatePacket << aircraft->getPosition().y;
-					positionUpdatePacket << static_cast<sf::Int32>(aircraft->getHitpoints());
-					positionUpdatePacket << static_cast<sf::Int32>(aircraft->getMissileAmmo());
+					Aircraft* aircraft = world_.getAircraft(identifier);
+					if (aircraft)
+					{
+						positionUpdatePacket << identifier;
+						positionUpdatePacket << aircraft->getPosition().x;
+						positionUpdatePacket << aircraft->getPosition().y;
+						positionUpdatePacket << static_cast<sf::Int32>(aircraft->getHitpoints());
+						positionUpdatePacket << static_cast<sf::Int32>(aircraft->getMissileAmmo());
+					}
 				}
+
+				sendBuffer_.append(positionUpdatePacket);
 			}
 
-			socket_.send(positionUpdatePacket);
+			sendInputDatagram();
 			tickClock_.restart();
 		}
 
 		timeSinceLastPacket_ += dt;
+
+		// Everything this frame produced, including the input events handled before it, goes out in one send
+		sendBuffer_.flush();
+		if (sendBuffer_.isStalled())
+		{
+			// The server stopped reading, the messages it missed cannot be sent again
+			loseConnection();
+		}
+
+		if (Profiler* profiler = getContext().profiler)
+		{
+			SendBuffer::Counters sends = sendBuffer_.takeCounters();
+			profiler->addCount("messages sent", static_cast<double>(sends.messages));
+			profiler->addCount("send calls", static_cast<double>(sends.sendCalls));
+			profiler->addCount("bytes sent", static_cast<double>(sends.bytes));
+		}
 	}
 
 	// Failed to connect and waited for more than 5 seconds: back to menu
@@ -273,6 +369,17 @@ bool MultiplayerGameState::update(sf::Time dt)
 	return true;
 }
 
+void MultiplayerGameState::setInterpolationDelay(sf::Time delay)
+{
+	interpolationDelay_ = delay;
+}
+
+void MultiplayerGameState::setNetworkSimulation(const NetworkSimulator::Settings& settings)
+{
+	streamSimulator_.setSettings(settings);
+	datagramSimulator_.setSettings(settings);
+}
+
 void MultiplayerGameState::disableAllRealtimeActions()
 {
 	isActiveState_ = false;
@@ -280,6 +387,10 @@ void MultiplayerGameState::disableAllRealtimeActions()
 	{
 		players_[player]->disableAllRealtimeActions();
 	}
+
+	// The state is paused now, the server must not wait for the next frame's flush or input datagram
+	sendBuffer_.flush();
+	sendInputDatagram();
 }
 
 bool MultiplayerGameState::handleEvent(const sf::Event& event)
@@ -301,7 +412,7 @@ bool MultiplayerGameState::handleEvent(const sf::Event& event)
 			sf::Packet packet;
 			packet << static_cast<sf::Int32>(ClientPacketType::RequestCoopPartner);
 
-			socket_.send(packet);
+			sendBuffer_.append(packet);
 		}
 
 		// Escape pressed, trigger the pause screen
@@ -323,6 +434,16 @@ bool MultiplayerGameState::handleEvent(const sf::Event& event)
 	return true;
 }
 
+void MultiplayerGameState::loseConnection()
+{
+	isConnected_ = false;
+
+	failedConnectionText_.setString("Lost connection to the server!");
+	centerOrigin(failedConnectionText_);
+
+	failedConnectionClock_.restart();
+}
+
 void MultiplayerGameState::updateBroadcastMessage(sf::Time elapsedTime)
 {
 	if (broadcasts_.empty())
@@ -347,9 +468,53 @@ void MultiplayerGameState::updateBroadcastMessage(sf::Time elapsedTime)
 	}
 }
 
-void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet)
+std::size_t MultiplayerGameState::receiveIncomingPackets()
 {
-	switch (static_cast<ServerPacketType>(packetType))
+	std::size_t receivedPackets = 0;
+	if (streamSimulator_.isActive())
+	{
+		// Received packets pass the emulated link before they are queued for handling
+		sf::Packet packet;
+		while (socket_.receive(packet) == sf::Socket::Done)
+		{
+			streamSimulator_.push(networkTime_, packet);
+			++receivedPackets;
+		}
+
+		while (streamSimulator_.pop(networkTime_, packet))
+		{
+			incomingPackets_.push(packet);
+		}
+	}
+	else
+	{
+		receivedPackets = incomingPackets_.receive(socket_);
+	}
+
+	// Handle packets in arrival order until the frame's budget is used up, the rest waits for the next frame.
+	// The packet type is only read here, since a ProtocolAccept changes the framing of the packets after it
+	sf::Clock budgetClock;
+	std::size_t handledPackets = 0;
+	while (!incomingPackets_.isEmpty() && budgetClock.getElapsedTime() < PacketBudget)
+	{
+		sf::Packet& packet = incomingPackets_.front();
+		handlePacket(readServerPacketType(packet, protocolVersion_), packet);
+		incomingPackets_.pop();
+		++handledPackets;
+	}
+
+	if (Profiler* profiler = getContext().profiler)
+	{
+		profiler->addCount("packets handled", static_cast<double>(handledPackets));
+		profiler->addCount("packet backlog", static_cast<double>(incomingPackets_.getSize()));
+	}
+
+	return receivedPackets;
+}
+
+void MultiplayerGameState::handlePacket(ServerPacketType packetType, sf::Packet& packet)
+{
+	switch (packetType)
 	{
 		// Send message to all clients
 	case ServerPacketType::BroadcastMessage:
@@ -378,7 +543,7 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 		Aircraft* aircraft = world_.addAircraft(aircraftIdentifier);
 		aircraft->setPosition(aircraftPosition);
 
-		players_[aircraftIdentifier].reset(new Player(&socket_, aircraftIdentifier, getContext().keys1));
+		players_[aircraftIdentifier].reset(new Player(&sendBuffer_, aircraftIdentifier, getContext().keys1));
 		localPlayerIdentifiers_.push_back(aircraftIdentifier);
 
 		isGameStarted_ = true;
@@ -394,7 +559,7 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 		Aircraft* aircraft = world_.addAircraft(aircraftIdentifier);
 		aircraft->setPosition(aircraftPosition);
 
-		players_[aircraftIdentifier].reset(new Player(&socket_, aircraftIdentifier, nullptr));
+		players_[aircraftIdentifier].reset(new Player(&sendBuffer_, aircraftIdentifier, nullptr));
 	}
 	break;
 
@@ -432,7 +597,7 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 			aircraft->setHitpoints(hitpoints);
 			aircraft->setMissileAmmo(missileAmmo);
 
-			players_[aircraftIdentifier].reset(new Player(&socket_, aircraftIdentifier, nullptr));
+			players_[aircraftIdentifier].reset(new Player(&sendBuffer_, aircraftIdentifier, nullptr));
 		}
 	}
 	break;
@@ -443,7 +608,7 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 		packet >> aircraftIdentifier;
 
 		world_.addAircraft(aircraftIdentifier);
-		players_[aircraftIdentifier].reset(new Player(&socket_, aircraftIdentifier, getContext().keys2));
+		players_[aircraftIdentifier].reset(new Player(&sendBuffer_, aircraftIdentifier, getContext().keys2));
 		localPlayerIdentifiers_.push_back(aircraftIdentifier);
 	}
 	break;
@@ -508,17 +673,14 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 	}
 	break;
 
-	//
+	// Server state in the original format (protocol version 0)
 	case ServerPacketType::UpdateClientState:
 	{
 		float currentWorldPosition;
 		sf::Int32 aircraftCount;
 		packet >> currentWorldPosition >> aircraftCount;
 
-		float currentViewPosition = world_.getViewBounds().top + world_.getViewBounds().height;
-
-		// Set the world's scroll compensation according to the client's position
-		world_.setWorldScrollCompensation(currentViewPosition / currentWorldPosition);
+		updateScrollCompensation(currentWorldPosition);
 
 		for (sf::Int32 i = 0; i < aircraftCount; ++i)
 		{
@@ -526,15 +688,291 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 			sf::Vector2f aircraftPosition;
 			packet >> aircraftIdentifier >> aircraftPosition.x >> aircraftPosition.y;
 
-			Aircraft* aircraft = world_.getAircraft(aircraftIdentifier);
-			bool isLocalPlane = std::find(localPlayerIdentifiers_.begin(), localPlayerIdentifiers_.end(), aircraftIdentifier) != localPlayerIdentifiers_.end();
-			if (aircraft && !isLocalPlane)
-			{
-				sf::Vector2f interpolatedPosition = aircraft->getPosition() + (aircraftPosition - aircraft->getPosition()) * 0.1f;
-				aircraft->setPosition(interpolatedPosition);
-			}
+			// Version 0 has no server tick, the arrival time has to do
+			updateAircraft(aircraftIdentifier, aircraftPosition, networkTime_);
+		}
+	}
+	break;
+
+	// Server accepted a protocol version, all following packets use its framing
+	case ServerPacketType::ProtocolAccept:
+	{
+		packet >> protocolVersion_;
+
+		// States so far were stamped with their arrival time, snapshots carry the server time
+		remoteAircraftStates_.clear();
+
+		// A server that negotiates runs the authoritative world, player hitpoints come with its snapshots
+		world_.setPlayerDamageEnabled(false);
+	}
+	break;
+
+	// Server state since protocol version 1, delta encoded against an acknowledged snapshot
+	case ServerPacketType::Snapshot:
+	{
+		if (handleSnapshot(packet))
+		{
+			sf::Packet ackPacket;
+			ackPacket << static_cast<sf::Int32>(ClientPacketType::SnapshotAck) << snapshot_.sequence;
+			sendBuffer_.append(ackPacket);
 		}
 	}
 	break;
+
+	// Server offers the UDP channel (protocol version 2), the first input datagram opens it
+	case ServerPacketType::UdpChannel:
+	{
+		packet >> serverUdpPort_ >> udpToken_;
+
+		udpSocket_.setBlocking(false);
+		if (udpSocket_.bind(sf::Socket::AnyPort) != sf::Socket::Done)
+		{
+			serverUdpPort_ = 0;
+			break;
+		}
+
+		sendInputDatagram();
+	}
+	break;
+
+	default:
+		break;
+	}
+}
+
+std::size_t MultiplayerGameState::receiveIncomingDatagrams()
+{
+	if (serverUdpPort_ == 0)
+	{
+		return 0;
+	}
+
+	std::size_t receivedDatagrams = 0;
+	sf::Packet packet;
+	sf::IpAddress sender;
+	unsigned short port;
+	while (udpSocket_.receive(packet, sender, port) == sf::Socket::Done)
+	{
+		// Only the port is checked, a multihomed server may answer from another address than the one connected to
+		if (port != serverUdpPort_)
+		{
+			continue;
+		}
+
+		++receivedDatagrams;
+		if (datagramSimulator_.isActive())
+		{
+			datagramSimulator_.push(networkTime_, packet);
+		}
+		else
+		{
+			handleDatagram(packet);
+		}
+	}
+
+	while (datagramSimulator_.pop(networkTime_, packet))
+	{
+		handleDatagram(packet);
+	}
+
+	return receivedDatagrams;
+}
+
+void MultiplayerGameState::handleDatagram(sf::Packet& packet)
+{
+	if (readServerPacketType(packet, protocolVersion_) != ServerPacketType::Snapshot || !handleSnapshot(packet))
+	{
+		return;
+	}
+
+	// Realtime actions of the remote aircraft, they replace PlayerRealtimeChange on the UDP channel
+	sf::Uint8 aircraftCount = 0;
+	packet >> aircraftCount;
+	for (sf::Uint8 i = 0; i < aircraftCount; ++i)
+	{
+		sf::Int32 aircraftIdentifier;
+		sf::Uint8 actions;
+		if (!(packet >> aircraftIdentifier >> actions))
+		{
+			break;
+		}
+
+		bool isLocalPlane = std::find(localPlayerIdentifiers_.begin(), localPlayerIdentifiers_.end(), aircraftIdentifier) != localPlayerIdentifiers_.end();
+		auto itr = players_.find(aircraftIdentifier);
+		if (itr != players_.end() && !isLocalPlane)
+		{
+			itr->second->handleNetworkRealtimeActions(actions);
+		}
+	}
+
+	// The snapshot is acknowledged right away, the input state comes along
+	sendInputDatagram();
+}
+
+bool MultiplayerGameState::handleSnapshot(sf::Packet& packet)
+{
+	// Datagrams may arrive out of order, a snapshot older than the applied one would turn back the scroll,
+	// the server clock and the remote realtime actions
+	sf::Uint16 sequence;
+	if (!Snapshot::peekSequence(packet, sequence)
+		|| (hasSnapshot_ && static_cast<sf::Int16>(sequence - snapshot_.sequence) <= 0))
+	{
+		return false;
+	}
+
+	// Without its base the snapshot cannot be rebuilt, the next one is based on an older acknowledgement.
+	// It is read aside, so the applied snapshot stays the one acknowledged.
+	if (!receivedSnapshot_.read(packet, snapshots_))
+	{
+		return false;
+	}
+
+	std::swap(snapshot_, receivedSnapshot_);
+	snapshots_.add(snapshot_);
+	hasSnapshot_ = true;
+
+	updateScrollCompensation(Snapshot::dequantize(snapshot_.battleFieldPosition));
+
+	sf::Time serverTime = serverClock_.synchronize(snapshot_.sequence, networkTime_);
+	for (const Snapshot::Entry& entry : snapshot_.entries)
+	{
+		// Only PlayerDisconnect destroys an aircraft, the last snapshots may still show it without hitpoints
+		Aircraft* aircraft = world_.getAircraft(entry.identifier);
+		if (aircraft && entry.hitpoints > 0)
+		{
+			aircraft->setHitpoints(entry.hitpoints);
+			aircraft->setMissileAmmo(entry.missileAmmo);
+		}
+
+		updateAircraft(entry.identifier, snapshot_.getPosition(entry), serverTime);
+	}
+
+	return true;
+}
+
+bool MultiplayerGameState::haveRealtimeActionsChanged() const
+{
+	for (const auto& identifier : localPlayerIdentifiers_)
+	{
+		auto player = players_.find(identifier);
+		auto sent = sentRealtimeActions_.find(identifier);
+		if (player != players_.end() && (sent == sentRealtimeActions_.end() || sent->second != player->second->getRealtimeActions()))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void MultiplayerGameState::sendInputDatagram()
+{
+	if (serverUdpPort_ == 0)
+	{
+		return;
+	}
+
+	sf::Packet datagram;
+	datagram << udpToken_ << ++inputSequence_ << hasSnapshot_ << snapshot_.sequence;
+	datagram << static_cast<sf::Uint8>(localPlayerIdentifiers_.size());
+
+	for (const auto& identifier : localPlayerIdentifiers_)
+	{
+		auto player = players_.find(identifier);
+		sf::Uint8 actions = player != players_.end() ? player->second->getRealtimeActions() : 0;
+
+		datagram << identifier << actions;
+		sentRealtimeActions_[identifier] = actions;
+	}
+
+	udpSocket_.send(datagram.getData(), datagram.getDataSize(), socket_.getRemoteAddress(), serverUdpPort_);
+}
+
+void MultiplayerGameState::updateScrollCompensation(float currentWorldPosition)
+{
+	float currentViewPosition = world_.getViewBounds().top + world_.getViewBounds().height;
+
+	// Set the world's scroll compensation according to the client's position
+	world_.setWorldScrollCompensation(currentViewPosition / currentWorldPosition);
+}
+
+void MultiplayerGameState::updateAircraft(sf::Int32 aircraftIdentifier, sf::Vector2f aircraftPosition, sf::Time serverTime)
+{
+	Aircraft* aircraft = world_.getAircraft(aircraftIdentifier);
+	bool isLocalPlane = std::find(localPlayerIdentifiers_.begin(), localPlayerIdentifiers_.end(), aircraftIdentifier) != localPlayerIdentifiers_.end();
+	if (aircraft && isLocalPlane)
+	{
+		reconcileLocalAircraft(*aircraft, aircraftPosition);
+	}
+	else if (aircraft)
+	{
+		remoteAircraftStates_[aircraftIdentifier].push(serverTime, aircraftPosition);
+	}
+}
+
+void MultiplayerGameState::reconcileLocalAircraft(Aircraft& aircraft, sf::Vector2f serverPosition)
+{
+	// The server state answers input sent about a round trip ago, so it is held against the predicted
+	// position closest to it rather than the current one
+	std::deque<sf::Vector2f>& predictedPositions = predictedPositions_[aircraft.getIdentifier()];
+	sf::Vector2f matchedPosition = aircraft.getPosition();
+	for (sf::Vector2f position : predictedPositions)
+	{
+		if (length(serverPosition - position) < length(serverPosition - matchedPosition))
+		{
+			matchedPosition = position;
+		}
+	}
+
+	if (length(serverPosition - matchedPosition) <= ReconciliationTolerance)
+	{
+		return;
+	}
+
+	// The prediction went elsewhere: move it by the error, keeping the input applied since the matched position
+	sf::Vector2f correction = serverPosition - matchedPosition;
+	aircraft.move(correction);
+	for (sf::Vector2f& position : predictedPositions)
+	{
+		position += correction;
+	}
+}
+
+void MultiplayerGameState::recordPredictedPositions()
+{
+	for (const auto& identifier : localPlayerIdentifiers_)
+	{
+		Aircraft* aircraft = world_.getAircraft(identifier);
+		if (!aircraft)
+		{
+			predictedPositions_.erase(identifier);
+			continue;
+		}
+
+		std::deque<sf::Vector2f>& predictedPositions = predictedPositions_[identifier];
+		predictedPositions.push_back(aircraft->getPosition());
+		if (predictedPositions.size() > PredictionHistory)
+		{
+			predictedPositions.pop_front();
+		}
+	}
+}
+
+void MultiplayerGameState::interpolateRemoteAircraft()
+{
+	// Without a synchronized clock (protocol version 0) the server time is the arrival time
+	sf::Time renderTime = serverClock_.getTime(networkTime_) - interpolationDelay_;
+
+	for (auto itr = remoteAircraftStates_.begin(); itr != remoteAircraftStates_.end();)
+	{
+		Aircraft* aircraft = world_.getAircraft(itr->first);
+		if (!aircraft)
+		{
+			remoteAircraftStates_.erase(itr++);
+			continue;
+		}
+
+		aircraft->setPosition(itr->second.sample(renderTime, MaxExtrapolation));
+		++itr;
 	}
 }
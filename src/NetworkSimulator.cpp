@@ -0,0 +1,90 @@
+#include <algorithm>
+
+#include "NetworkSimulator.h"
+#include "Utility.h"
+
+namespace
+{
+	// Minimum retransmission timeout of common TCP stacks, doubled for every further loss of the same packet
+	const sf::Time RetransmissionTimeout = sf::milliseconds(200);
+	const std::size_t MaxRetransmissions = 8;
+
+	bool isLost(float lossRate)
+	{
+		return randomInt(10000) < static_cast<int>(lossRate * 10000.f);
+	}
+}
+
+NetworkSimulator::Settings::Settings()
+	: lossRate(0.f)
+	, latency(sf::Time::Zero)
+	, jitter(sf::Time::Zero)
+{
+}
+
+
+NetworkSimulator::NetworkSimulator(Mode mode)
+	: mode_(mode)
+	, settings_()
+	, packets_()
+	, lastDeliveryTime_(sf::Time::Zero)
+{
+}
+
+void NetworkSimulator::setSettings(const Settings& settings)
+{
+	settings_ = settings;
+	settings_.lossRate = std::clamp(settings.lossRate, 0.f, 1.f);
+}
+
+bool NetworkSimulator::isActive() const
+{
+	return settings_.lossRate > 0.f || settings_.latency > sf::Time::Zero || settings_.jitter > sf::Time::Zero || !packets_.empty();
+}
+
+void NetworkSimulator::push(sf::Time now, const sf::Packet& packet)
+{
+	sf::Time deliveryTime = now + settings_.latency;
+	if (settings_.jitter > sf::Time::Zero)
+	{
+		deliveryTime += sf::microseconds(randomInt(static_cast<int>(settings_.jitter.asMicroseconds()) + 1));
+	}
+
+	if (mode_ == Datagram)
+	{
+		if (isLost(settings_.lossRate))
+		{
+			return;
+		}
+	}
+	else
+	{
+		// At a loss rate near 1 the retransmissions would go on forever, the packet arrives after the last one
+		sf::Time timeout = RetransmissionTimeout;
+		for (std::size_t retransmission = 0; retransmission < MaxRetransmissions && isLost(settings_.lossRate); ++retransmission)
+		{
+			deliveryTime += timeout;
+			timeout *= 2.f;
+		}
+
+		// In order delivery: nothing overtakes a packet that is still being retransmitted
+		deliveryTime = std::max(deliveryTime, lastDeliveryTime_);
+		lastDeliveryTime_ = deliveryTime;
+	}
+
+	auto position = std::upper_bound(packets_.begin(), packets_.end(), deliveryTime,
+		[](sf::Time time, const DelayedPacket& delayed) { return time < delayed.deliveryTime; });
+	packets_.insert(position, DelayedPacket{ deliveryTime, packet });
+}
+
+bool NetworkSimulator::pop(sf::Time now, sf::Packet& packet)
+{
+	if (packets_.empty() || packets_.front().deliveryTime > now)
+	{
+		return false;
+	}
+
+	packet = packets_.front().packet;
+	packets_.pop_front();
+	return true;
+}
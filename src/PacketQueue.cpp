@@ -0,0 +1,86 @@
+#include <cassert>
+
+#include "PacketQueue.h"
+
+namespace
+{
+	const std::size_t InitialCapacity = 64;
+}
+
+PacketQueue::PacketQueue()
+	: buffer_(InitialCapacity)
+	, head_(0)
+	, size_(0)
+{
+}
+
+std::size_t PacketQueue::receive(sf::TcpSocket& socket)
+{
+	std::size_t received = 0;
+	while (received < MaxPacketsPerReceive)
+	{
+		if (size_ == buffer_.size())
+		{
+			grow();
+		}
+
+		// Receive straight into the next free slot, it only counts once the packet is complete
+		sf::Packet& packet = buffer_[(head_ + size_) % buffer_.size()];
+		if (socket.receive(packet) != sf::Socket::Done)
+		{
+			break;
+		}
+
+		++size_;
+		++received;
+	}
+
+	return received;
+}
+
+void PacketQueue::push(const sf::Packet& packet)
+{
+	if (size_ == buffer_.size())
+	{
+		grow();
+	}
+
+	buffer_[(head_ + size_) % buffer_.size()] = packet;
+	++size_;
+}
+
+sf::Packet& PacketQueue::front()
+{
+	assert(size_ != 0 && "PacketQueue::front - Queue is empty");
+	return buffer_[head_];
+}
+
+void PacketQueue::pop()
+{
+	assert(size_ != 0 && "PacketQueue::pop - Queue is empty");
+	head_ = (head_ + 1) % buffer_.size();
+	--size_;
+}
+
+bool PacketQueue::isEmpty() const
+{
+	return size_ == 0;
+}
+
+std::size_t PacketQueue::getSize() const
+{
+	return size_;
+}
+
+void PacketQueue::grow()
+{
+	// Unroll the ring into a buffer of twice the size, oldest packet first
+	std::vector<sf::Packet> buffer(buffer_.size() * 2);
+	for (std::size_t i = 0; i < size_; ++i)
+	{
+		buffer[i] = buffer_[(head_ + i) % buffer_.size()];
+	}
+
+	buffer_.swap(buffer);
+	head_ = 0;
+}
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cassert>
+
+#include "ParticleBuffer.h"
+
+namespace
+{
+	sf::Color lerpColor(sf::Color from, sf::Color to, float ratio)
+	{
+		auto lerp = [ratio](sf::Uint8 a, sf::Uint8 b) { return static_cast<sf::Uint8>(a + (b - a) * ratio); };
+		return sf::Color(lerp(from.r, to.r), lerp(from.g, to.g), lerp(from.b, to.b), lerp(from.a, to.a));
+	}
+}
+
+ParticleBuffer::ParticleBuffer(std::size_t capacity, float lifetime)
+	: positionsX_(capacity)
+	, positionsY_(capacity)
+	, velocitiesX_(capacity)
+	, velocitiesY_(capacity)
+	, spawnTimes_(capacity)
+	, ages_(capacity)
+	, head_(0)
+	, size_(0)
+	, addedCount_(0)
+	, time_(0.f)
+	, lifetime_(lifetime)
+{
+	assert(capacity > 0 && "ParticleBuffer::ParticleBuffer - Capacity must not be zero");
+}
+
+void ParticleBuffer::add(sf::Vector2f position, sf::Vector2f velocity)
+{
+	const std::size_t capacity = spawnTimes_.size();
+
+	// Full: the new particle takes the slot of the oldest one
+	if (size_ == capacity)
+	{
+		head_ = (head_ + 1) % capacity;
+		--size_;
+	}
+
+	std::size_t index = (head_ + size_) % capacity;
+	positionsX_[index] = position.x;
+	positionsY_[index] = position.y;
+	velocitiesX_[index] = velocity.x;
+	velocitiesY_[index] = velocity.y;
+	spawnTimes_[index] = time_;
+	++size_;
+	++addedCount_;
+}
+
+void ParticleBuffer::age(float seconds)
+{
+	time_ += seconds;
+
+	const std::size_t capacity = spawnTimes_.size();
+	while (size_ > 0 && time_ - spawnTimes_[head_] >= lifetime_)
+	{
+		head_ = (head_ + 1) % capacity;
+		--size_;
+	}
+}
+
+std::size_t ParticleBuffer::getSize() const
+{
+	return size_;
+}
+
+std::size_t ParticleBuffer::getCapacity() const
+{
+	return spawnTimes_.size();
+}
+
+float ParticleBuffer::getTime() const
+{
+	return time_;
+}
+
+float ParticleBuffer::getLifetime() const
+{
+	return lifetime_;
+}
+
+void ParticleBuffer::writeVertices(sf::Vertex* vertices, const ParticleStyle& style) const
+{
+	const float time = time_;
+	const float* spawnTimes = spawnTimes_.data();
+	float* ages = ages_.data();
+
+	forEachRange([&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				ages[i] = time - spawnTimes[i];
+			}
+		});
+
+	const float invLifetime = 1.f / lifetime_;
+	const sf::Vector2f sizeChange = style.endSize - style.startSize;
+	const sf::Vector2f texture = style.textureSize;
+	sf::Vertex* quad = vertices;
+
+	forEachRange([&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i, quad += 4)
+			{
+				const float age = ages[i];
+				const float ratio = std::min(age * invLifetime, 1.f);
+
+				const float x = positionsX_[i] + velocitiesX_[i] * age;
+				const float y = positionsY_[i] + velocitiesY_[i] * age;
+				const sf::Vector2f half = (style.startSize + sizeChange * ratio) / 2.f;
+				const sf::Color color = lerpColor(style.startColor, style.endColor, ratio);
+
+				quad[0] = sf::Vertex(sf::Vector2f(x - half.x, y - half.y), color, sf::Vector2f(0.f, 0.f));
+				quad[1] = sf::Vertex(sf::Vector2f(x + half.x, y - half.y), color, sf::Vector2f(texture.x, 0.f));
+				quad[2] = sf::Vertex(sf::Vector2f(x + half.x, y + half.y), color, sf::Vector2f(texture.x, texture.y));
+				quad[3] = sf::Vertex(sf::Vector2f(x - half.x, y + half.y), color, sf::Vector2f(0.f, texture.y));
+			}
+		});
+}
+
+std::size_t ParticleBuffer::getHead() const
+{
+	return head_;
+}
+
+std::size_t ParticleBuffer::getAddedCount() const
+{
+	return addedCount_;
+}
+
+sf::Vector2f ParticleBuffer::getPosition(std::size_t slot) const
+{
+	return sf::Vector2f(positionsX_[slot], positionsY_[slot]);
+}
+
+sf::Vector2f ParticleBuffer::getVelocity(std::size_t slot) const
+{
+	return sf::Vector2f(velocitiesX_[slot], velocitiesY_[slot]);
+}
+
+float ParticleBuffer::getSpawnTime(std::size_t slot) const
+{
+	return spawnTimes_[slot];
+}
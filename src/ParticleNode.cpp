@@ -1,9 +1,7 @@
-#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Texture.hpp>
 
-#include <algorithm>
-
 #include "ParticleNode.h"
+#include "SpriteBatch.h"
 #include "DataTables.h"
 #include "ResourceHolder.h"
 
@@ -12,24 +10,39 @@ namespace
 	const std::vector<ParticleData> Table = initializeParticleData();
 }
 
+std::size_t ParticleNode::uploadedByteCount_ = 0;
+
 ParticleNode::ParticleNode(Particle::Type type, const TextureHolder& textures)
 	: SceneNode()
-	, particles_()
-	, texture_(textures.get(Textures::Particle))
+	, particles_(Table[type].capacity, Table[type].lifetime.asSeconds())
+	, texture_(textures.find(Textures::Particle))
 	, type_(type)
+	, style_()
+	, renderer_()
 	, vertexArray_(sf::Quads)
 	, isNeedsVertexUpdate_(true)
 {
+	const sf::Vector2f textureSize = (texture_ != nullptr) ? sf::Vector2f(texture_->getSize()) : sf::Vector2f();
+	style_ = ParticleStyle{ textureSize, textureSize * Table[type].startSize, textureSize * Table[type].endSize,
+		Table[type].startColor, Table[type].endColor };
+
+	if (texture_ != nullptr && ParticleRenderer::isSupported())
+	{
+		renderer_ = std::make_unique<ParticleRenderer>(particles_, *texture_, style_);
+		if (!renderer_->isLoaded())
+		{
+			renderer_.reset();
+		}
+	}
+
+	// Shrinking keeps the storage, so building the vertices never reallocates
+	vertexArray_.resize(particles_.getCapacity() * 4);
+	vertexArray_.resize(0);
 }
 
-void ParticleNode::addParticle(sf::Vector2f position)
+void ParticleNode::addParticle(sf::Vector2f position, sf::Vector2f velocity)
 {
-	Particle particle;
-	particle.position = position;
-	particle.color = Table[type_].color;
-	particle.lifetime = Table[type_].lifetime;
-
-	particles_.push_back(particle);
+	particles_.add(position, velocity);
 }
 
 Particle::Type ParticleNode::getParticleType() const
@@ -37,30 +50,41 @@ Particle::Type ParticleNode::getParticleType() const
 	return type_;
 }
 
+std::size_t ParticleNode::getParticleCount() const
+{
+	return particles_.getSize();
+}
+
 Category ParticleNode::getCategory() const
 {
 	return Category::ParticleSystem;
 }
 
-void ParticleNode::updateCurrent(sf::Time dt, CommandQueue&)
+std::size_t ParticleNode::getUploadedByteCount()
 {
-	// Remove expired particles at beginning
-	while (!particles_.empty() && particles_.front().lifetime <= sf::Time::Zero)
-	{
-		particles_.pop_front();
-	}
+	return uploadedByteCount_;
+}
 
-	// Decrease lifetime of all particles
-	for (Particle& particle : particles_)
-	{
-		particle.lifetime -= dt;
-	}
+void ParticleNode::resetUploadedByteCount()
+{
+	uploadedByteCount_ = 0;
+}
 
+void ParticleNode::integrateCurrent(sf::Time dt, CommandQueue&)
+{
+	particles_.age(dt.asSeconds());
 	isNeedsVertexUpdate_ = true;
 }
 
-void ParticleNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+void ParticleNode::drawCurrent(SpriteBatch& batch, sf::RenderStates states, float) const
 {
+	if (renderer_)
+	{
+		uploadedByteCount_ += renderer_->update();
+		batch.draw(*renderer_, states);
+		return;
+	}
+
 	if (isNeedsVertexUpdate_)
 	{
 		computeVertices();
@@ -68,40 +92,18 @@ void ParticleNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states
 	}
 
 	// Apply particle texture
-	states.texture = &texture_;
+	states.texture = texture_;
 
-	// Draw vertices
-	target.draw(vertexArray_, states);
-}
-
-void ParticleNode::addVertex(float worldX, float worldY, float texCoordX, float texCoordY, sf::Color color) const
-{
-	sf::Vertex vertex;
-	vertex.position = sf::Vector2f(worldX, worldY);
-	vertex.color = color;	
-	vertex.texCoords = sf::Vector2f(texCoordX, texCoordY);
-
-	vertexArray_.append(vertex);
+	// Draw vertices, the batch sends all of them again every frame
+	batch.draw(vertexArray_, states);
+	uploadedByteCount_ += vertexArray_.getVertexCount() * sizeof(sf::Vertex);
 }
 
 void ParticleNode::computeVertices() const
 {
-	sf::Vector2f size{ texture_.getSize() };
-	sf::Vector2f half = size / 2.f;
-
-	// Refill vertex array
-	vertexArray_.clear();
-	for (const Particle& particle : particles_)
+	vertexArray_.resize(particles_.getSize() * 4);
+	if (particles_.getSize() > 0)
 	{
-		sf::Vector2f position = particle.position;
-		sf::Color color = particle.color;
-
-		float ratio = particle.lifetime.asSeconds() / Table[type_].lifetime.asSeconds();
-		color.a = static_cast<sf::Uint8>(255 * std::max(ratio, 0.f));
-
-		addVertex(position.x - half.x, position.y - half.y, 0.f, 0.f, color);
-		addVertex(position.x + half.x, position.y - half.y, size.x, 0.f, color);
-		addVertex(position.x + half.x, position.y + half.y, size.x, size.y, color);
-		addVertex(position.x - half.x, position.y + half.y, 0.f, size.y, color);
+		particles_.writeVertices(&vertexArray_[0], style_);
 	}
 }
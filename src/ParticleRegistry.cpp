@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "ParticleRegistry.h"
+#include "ParticleNode.h"
+#include "EmitterNode.h"
+#include "DataTables.h"
+#include "Utility.h"
+
+namespace
+{
+	const std::vector<ParticleData> Table = initializeParticleData();
+}
+
+ParticleRegistry::ParticleRegistry()
+	: entries_()
+	, bursts_()
+	, requests_()
+	, randomEngine_()
+	, budget_(DefaultBudget)
+	, emittedCount_(0)
+	, skippedCount_(0)
+{
+}
+
+void ParticleRegistry::addSystem(ParticleNode& system)
+{
+	Entry& entry = entries_[system.getParticleType()];
+	assert(entry.system == nullptr && "ParticleRegistry::addSystem - One system per particle type");
+
+	entry.system = &system;
+}
+
+ParticleNode* ParticleRegistry::findSystem(Particle::Type type) const
+{
+	return entries_[type].system;
+}
+
+void ParticleRegistry::addEmitter(EmitterNode& emitter, Particle::Type type)
+{
+	entries_[type].emitters.push_back(&emitter);
+}
+
+void ParticleRegistry::removeEmitter(EmitterNode& emitter, Particle::Type type)
+{
+	std::vector<EmitterNode*>& emitters = entries_[type].emitters;
+
+	// Kept in order, particles are emitted in the order the emitters were created
+	auto found = std::find(emitters.begin(), emitters.end(), &emitter);
+	assert(found != emitters.end());
+
+	emitters.erase(found);
+}
+
+std::size_t ParticleRegistry::getEmitterCount(Particle::Type type) const
+{
+	return entries_[type].emitters.size();
+}
+
+void ParticleRegistry::burst(Particle::Type type, sf::Vector2f position, sf::Vector2f direction)
+{
+	if (entries_[type].system != nullptr)
+	{
+		bursts_.push_back(Request{ type, position, direction, Table[type].burstCount });
+	}
+}
+
+void ParticleRegistry::emit(sf::Time dt)
+{
+	requests_.clear();
+
+	for (std::size_t type = 0; type < entries_.size(); ++type)
+	{
+		if (entries_[type].system == nullptr)
+		{
+			continue;
+		}
+
+		for (EmitterNode* emitter : entries_[type].emitters)
+		{
+			if (std::size_t count = emitter->takeDueParticles(dt))
+			{
+				requests_.push_back(Request{ static_cast<Particle::Type>(type), emitter->getWorldPosition(),
+					emitter->getEmissionDirection(), count });
+			}
+		}
+	}
+
+	requests_.insert(requests_.end(), bursts_.begin(), bursts_.end());
+	bursts_.clear();
+
+	std::size_t requestedCount = 0;
+	for (const Request& request : requests_)
+	{
+		requestedCount += request.count;
+	}
+
+	// Requests take their share of the budget in turn, the fractions carry over to the next one
+	const double share = (requestedCount > budget_) ? static_cast<double>(budget_) / static_cast<double>(requestedCount) : 1.0;
+	double quota = 0.0;
+	emittedCount_ = 0;
+
+	for (const Request& request : requests_)
+	{
+		quota += static_cast<double>(request.count) * share;
+		std::size_t count = static_cast<std::size_t>(quota);
+		quota -= static_cast<double>(count);
+
+		ParticleNode& system = *entries_[request.type].system;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			system.addParticle(request.position, randomVelocity(request.type, request.direction));
+		}
+
+		emittedCount_ += count;
+	}
+
+	skippedCount_ = requestedCount - emittedCount_;
+}
+
+void ParticleRegistry::setBudget(std::size_t particlesPerStep)
+{
+	budget_ = particlesPerStep;
+}
+
+std::size_t ParticleRegistry::getEmittedCount() const
+{
+	return emittedCount_;
+}
+
+std::size_t ParticleRegistry::getSkippedCount() const
+{
+	return skippedCount_;
+}
+
+sf::Vector2f ParticleRegistry::randomVelocity(Particle::Type type, sf::Vector2f direction)
+{
+	const ParticleData& data = Table[type];
+	if (data.speed <= 0.f)
+	{
+		return sf::Vector2f();
+	}
+
+	// Between half and the full speed, within spread / 2 degrees to either side of the direction
+	std::uniform_real_distribution<float> unit(0.f, 1.f);
+	float baseAngle = (direction == sf::Vector2f()) ? 0.f : std::atan2(direction.y, direction.x);
+	float angle = baseAngle + toRadian((unit(randomEngine_) - 0.5f) * data.spread);
+	float speed = data.speed * (0.5f + 0.5f * unit(randomEngine_));
+
+	return sf::Vector2f(std::cos(angle), std::sin(angle)) * speed;
+}
@@ -0,0 +1,127 @@
+#include <algorithm>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include "ParticleRenderer.h"
+#include "ParticleBuffer.h"
+
+namespace
+{
+	// Velocity components are stored as 16 bit fixed point in [-MaxSpeed, MaxSpeed], the shader decodes them
+	const float MaxSpeed = 512.f;
+
+	sf::Uint16 encodeSpeed(float speed)
+	{
+		float normalized = std::clamp(speed / MaxSpeed, -1.f, 1.f) * 0.5f + 0.5f;
+		return static_cast<sf::Uint16>(normalized * 65535.f + 0.5f);
+	}
+
+	sf::Color encodeVelocity(sf::Vector2f velocity)
+	{
+		sf::Uint16 x = encodeSpeed(velocity.x);
+		sf::Uint16 y = encodeSpeed(velocity.y);
+		return sf::Color(static_cast<sf::Uint8>(x >> 8), static_cast<sf::Uint8>(x & 0xff),
+			static_cast<sf::Uint8>(y >> 8), static_cast<sf::Uint8>(y & 0xff));
+	}
+}
+
+ParticleRenderer::ParticleRenderer(const ParticleBuffer& particles, const sf::Texture& texture, const ParticleStyle& style)
+	: particles_(particles)
+	, texture_(texture)
+	, shader_()
+	, vertexBuffer_(sf::Quads, sf::VertexBuffer::Stream)
+	, staging_(particles.getCapacity() * 4)
+	, uploadedCount_(0)
+	, isLoaded_(false)
+{
+	isLoaded_ = shader_.loadFromFile("Media/Shaders/Particle.vert", "Media/Shaders/Particle.frag")
+		&& vertexBuffer_.create(particles.getCapacity() * 4);
+
+	if (isLoaded_)
+	{
+		shader_.setUniform("source", sf::Shader::CurrentTexture);
+		shader_.setUniform("lifetime", particles.getLifetime());
+		shader_.setUniform("maxSpeed", MaxSpeed);
+		shader_.setUniform("startSize", style.startSize);
+		shader_.setUniform("endSize", style.endSize);
+		shader_.setUniform("startColor", sf::Glsl::Vec4(style.startColor));
+		shader_.setUniform("endColor", sf::Glsl::Vec4(style.endColor));
+	}
+}
+
+bool ParticleRenderer::isLoaded() const
+{
+	return isLoaded_;
+}
+
+std::size_t ParticleRenderer::update()
+{
+	shader_.setUniform("time", particles_.getTime());
+
+	// Newer particles than the buffer holds replaced each other, only the live ones are uploaded
+	std::size_t count = std::min(particles_.getAddedCount() - uploadedCount_, particles_.getSize());
+	uploadedCount_ = particles_.getAddedCount();
+
+	// The new particles end at the tail of the ring, split in two ranges where it wraps
+	const std::size_t capacity = particles_.getCapacity();
+	std::size_t begin = (particles_.getHead() + particles_.getSize() - count) % capacity;
+	std::size_t firstCount = std::min(count, capacity - begin);
+
+	upload(begin, firstCount);
+	upload(0, count - firstCount);
+
+	return count * 4 * sizeof(sf::Vertex);
+}
+
+bool ParticleRenderer::isSupported()
+{
+	return sf::VertexBuffer::isAvailable() && sf::Shader::isAvailable();
+}
+
+void ParticleRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	const std::size_t size = particles_.getSize();
+	if (size == 0)
+	{
+		return;
+	}
+
+	states.texture = &texture_;
+	states.shader = &shader_;
+
+	// Oldest first like the CPU path, so overlapping particles blend in the same order
+	const std::size_t head = particles_.getHead();
+	std::size_t firstCount = std::min(size, particles_.getCapacity() - head);
+
+	target.draw(vertexBuffer_, head * 4, firstCount * 4, states);
+	if (size > firstCount)
+	{
+		target.draw(vertexBuffer_, 0, (size - firstCount) * 4, states);
+	}
+}
+
+void ParticleRenderer::upload(std::size_t begin, std::size_t count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// The first texture coordinate encodes the corner as u + 2v, the second one is the spawn time
+	sf::Vertex* quad = staging_.data();
+
+	for (std::size_t slot = begin; slot < begin + count; ++slot, quad += 4)
+	{
+		const sf::Vector2f position = particles_.getPosition(slot);
+		const sf::Color velocity = encodeVelocity(particles_.getVelocity(slot));
+		const float spawnTime = particles_.getSpawnTime(slot);
+
+		quad[0] = sf::Vertex(position, velocity, sf::Vector2f(0.f, spawnTime));
+		quad[1] = sf::Vertex(position, velocity, sf::Vector2f(1.f, spawnTime));
+		quad[2] = sf::Vertex(position, velocity, sf::Vector2f(3.f, spawnTime));
+		quad[3] = sf::Vertex(position, velocity, sf::Vector2f(2.f, spawnTime));
+	}
+
+	vertexBuffer_.update(staging_.data(), count * 4, static_cast<unsigned int>(begin * 4));
+}
@@ -1,6 +1,5 @@
-#include <SFML/Graphics/RenderTarget.hpp>
-
 #include "Pickup.h"
+#include "SpriteBatch.h"
 #include "DataTables.h"
 #include "Aircraft.h"
 #include "Utility.h"
@@ -16,8 +15,14 @@ namespace
 Pickup::Pickup(Type type, const TextureHolder& textures)
 	: Entity(1)
 	, type_(type)
-	, sprite_(textures.get(Table[type].texture), Table[type].textureRect)
+	, sprite_()
 {
+	sprite_.setTextureRect(Table[type].textureRect);
+	if (const sf::Texture* texture = textures.find(Table[type].texture))
+	{
+		sprite_.setTexture(*texture);
+	}
+
 	centerOrigin(sprite_);
 }
 
@@ -36,7 +41,7 @@ void Pickup::apply(Aircraft& player) const
 	Table[type_].action(player);
 }
 
-void Pickup::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+void Pickup::drawCurrent(SpriteBatch& batch, sf::RenderStates states, float) const
 {
-	target.draw(sprite_, states);
+	batch.draw(sprite_, states);
 }
@@ -65,11 +65,21 @@ struct AircraftMissileTrigger
 	int aircraftID;
 };
 
-Player::Player(sf::TcpSocket* socket, sf::Int32 identifier, const KeyBinding* binding)
+namespace
+{
+	// Bit of the action in Player::getRealtimeActions()
+	sf::Uint8 getActionBit(PlayerAction action)
+	{
+		return static_cast<sf::Uint8>(1 << static_cast<int>(action));
+	}
+}
+
+Player::Player(SendBuffer* sendBuffer, sf::Int32 identifier, const KeyBinding* binding)
 	: keyBinding_(binding)
+	, realtimeActions_(0)
 	, currentMissionStatus_(MissionRunning)
 	, identifier_(identifier)
-	, socket_(socket)
+	, sendBuffer_(sendBuffer)
 {
 	// Set initial action bindings
 	initializeActions();
@@ -90,13 +100,13 @@ void Player::handleEvent(const sf::Event& event, CommandQueue& commands)
 		if (keyBinding_ && keyBinding_->checkAction(event.key.code, action) && !isRealtimeAction(action))
 		{
 			// Network game: In case of an action is triggered, send it to the server
-			if (socket_)
+			if (sendBuffer_)
 			{
 				sf::Packet packet;
 				packet << static_cast<sf::Int32>(ClientPacketType::PlayerEvent);
 				packet << identifier_;
 				packet << static_cast<sf::Int32>(action);
-				socket_->send(packet);
+				sendBuffer_->append(packet);
 			}
 
 			// Network disconnected -> local event
@@ -108,7 +118,7 @@ void Player::handleEvent(const sf::Event& event, CommandQueue& commands)
 	}
 
 	// Realtime change (network game)
-	if ((event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased) && socket_)
+	if ((event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased) && sendBuffer_)
 	{
 		Action action;
 		if (keyBinding_ && keyBinding_->checkAction(event.key.code, action) && isRealtimeAction(action))
@@ -119,7 +129,10 @@ void Player::handleEvent(const sf::Event& event, CommandQueue& commands)
 			packet << identifier_;
 			packet << static_cast<sf::Int32>(action);
 			packet << (event.type == sf::Event::KeyPressed);
-			socket_->send(packet);
+			sendBuffer_->append(packet);
+
+			// The server does not echo the change back, remember it so it can be released in disableAllRealtimeActions()
+			handleNetworkRealtimeChange(action, event.type == sf::Event::KeyPressed);
 		}
 	}
 }
@@ -132,22 +145,27 @@ bool Player::isLocal() const
 
 void Player::disableAllRealtimeActions()
 {
-	for (const auto& action : actionProxies_)
+	for (const auto& pair : actionBinding_)
 	{
-		sf::Packet packet;
-		packet << static_cast<sf::Int32>(ClientPacketType::PlayerRealtimeChange);
-		packet << identifier_;
-		packet << static_cast<sf::Int32>(action.first);
-		packet << false;
+		if (realtimeActions_ & getActionBit(pair.first))
+		{
+			sf::Packet packet;
+			packet << static_cast<sf::Int32>(ClientPacketType::PlayerRealtimeChange);
+			packet << identifier_;
+			packet << static_cast<sf::Int32>(pair.first);
+			packet << false;
 
-		socket_->send(packet);
+			sendBuffer_->append(packet);
+		}
 	}
+
+	realtimeActions_ = 0;
 }
 
 void Player::handleRealtimeInput(CommandQueue& commands)
 {
 	// Check if this is a network game and local player or just a single player game
-	if ((socket_ && isLocal()) || !socket_)
+	if ((sendBuffer_ && isLocal()) || !sendBuffer_)
 	{
 		// Lookup all actions and push corresponding commands to the queue
 		std::vector<Action> activeActions = keyBinding_->getRealTimeActions();
@@ -161,14 +179,14 @@ void Player::handleRealtimeInput(CommandQueue& commands)
 void Player::handleRealtimeNetworkInput(CommandQueue& commands)
 {
 	// Check if this is a network game and it is not a local player
-	if (socket_ && !isLocal())
+	if (sendBuffer_ && !isLocal())
 	{
 		// Push commands from the network
-		for (const auto& pair : actionProxies_)
+		for (const auto& pair : actionBinding_)
 		{
-			if (pair.second && isRealtimeAction(pair.first))
+			if (realtimeActions_ & getActionBit(pair.first))
 			{
-				commands.push(actionBinding_[pair.first]);
+				commands.push(pair.second);
 			}
 		}
 	}
@@ -181,7 +199,32 @@ void Player::handleNetworkEvent(Action action, CommandQueue& commands)
 
 void Player::handleNetworkRealtimeChange(Action action, bool actionEnable)
 {
-	actionProxies_[action] = actionEnable;
+	if (!isRealtimeAction(action))
+	{
+		return;
+	}
+
+	if (actionEnable)
+	{
+		realtimeActions_ |= getActionBit(action);
+	}
+	else
+	{
+		realtimeActions_ &= static_cast<sf::Uint8>(~getActionBit(action));
+	}
+}
+
+sf::Uint8 Player::getRealtimeActions() const
+{
+	return realtimeActions_;
+}
+
+void Player::handleNetworkRealtimeActions(sf::Uint8 actions)
+{
+	for (const auto& pair : actionBinding_)
+	{
+		handleNetworkRealtimeChange(pair.first, (actions & getActionBit(pair.first)) != 0);
+	}
 }
 
 void Player::setMissionStatus(MissionStatus status)
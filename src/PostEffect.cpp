@@ -2,7 +2,18 @@
 
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Shader.hpp>
-#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+namespace
+{
+	// Fullscreen quad in unit coordinates, the render states scale it to the output
+	const sf::Vertex Quad[] = {
+		sf::Vertex(sf::Vector2f(0.f, 0.f), sf::Vector2f(0.f, 1.f)),
+		sf::Vertex(sf::Vector2f(1.f, 0.f), sf::Vector2f(1.f, 1.f)),
+		sf::Vertex(sf::Vector2f(0.f, 1.f), sf::Vector2f(0.f, 0.f)),
+		sf::Vertex(sf::Vector2f(1.f, 1.f), sf::Vector2f(1.f, 0.f)),
+	};
+}
 
 PostEffect::~PostEffect()
 {
@@ -10,19 +21,12 @@ PostEffect::~PostEffect()
 
 void PostEffect::applyShader(const sf::Shader& shader, sf::RenderTarget& output)
 {
-	sf::Vector2f outputSize{ output.getSize() };
-
-	sf::VertexArray vertices(sf::TrianglesStrip, 4);
-	vertices[0] = sf::Vertex{ sf::Vector2f(0.f, 0.f), sf::Vector2f(0, 1.f) };
-	vertices[1] = sf::Vertex{ sf::Vector2f(outputSize.x, 0), sf::Vector2f(1, 1) };
-	vertices[2] = sf::Vertex{ sf::Vector2f(0.f, outputSize.y), sf::Vector2f(0, 0) };
-	vertices[3] = sf::Vertex{ sf::Vector2f(outputSize), sf::Vector2f(1, 0) };
-
 	sf::RenderStates states;
 	states.shader = &shader;
 	states.blendMode = sf::BlendNone;
+	states.transform.scale(sf::Vector2f(output.getSize()));
 
-	output.draw(vertices, &shader);
+	output.draw(Quad, 4, sf::TriangleStrip, states);
 }
 
 bool PostEffect::isSupported()
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+#include "Profiler.h"
+
+
+Profiler::Profiler()
+	: sections_()
+	, openSections_()
+	, historyIndex_(0)
+	, historyCount_(0)
+	, epoch_(Clock::now())
+	, trace_()
+	, traceNext_(0)
+{
+	trace_.reserve(TraceCapacity);
+}
+
+void Profiler::beginFrame()
+{
+	assert(openSections_.empty() && "Profiler::beginFrame - Sections are still open");
+
+	for (Section& section : sections_)
+	{
+		section.history[historyIndex_] = section.value;
+		section.value = 0.0;
+	}
+
+	historyIndex_ = (historyIndex_ + 1) % HistorySize;
+	historyCount_ = std::min(historyCount_ + 1, HistorySize);
+}
+
+void Profiler::beginSection(const char* name)
+{
+	openSections_.push_back(OpenSection{ findSection(name, false), Clock::now() });
+}
+
+void Profiler::endSection()
+{
+	assert(!openSections_.empty() && "Profiler::endSection - No open section");
+
+	const Clock::time_point end = Clock::now();
+	const OpenSection open = openSections_.back();
+	openSections_.pop_back();
+
+	Section& section = sections_[open.index];
+	const double duration = std::chrono::duration<double, std::micro>(end - open.start).count();
+	section.value += duration;
+
+	// Ring buffer: fill up to the capacity once, then overwrite the oldest event
+	TraceEvent event{ section.name, std::chrono::duration<double, std::micro>(open.start - epoch_).count(), duration };
+	if (trace_.size() < TraceCapacity)
+	{
+		trace_.push_back(event);
+	}
+	else
+	{
+		trace_[traceNext_] = event;
+	}
+	traceNext_ = (traceNext_ + 1) % TraceCapacity;
+}
+
+void Profiler::addCount(const char* name, double count)
+{
+	sections_[findSection(name, true)].value += count;
+}
+
+const std::vector<Profiler::Section>& Profiler::getSections() const
+{
+	return sections_;
+}
+
+Profiler::Statistics Profiler::getStatistics(const Section& section) const
+{
+	if (historyCount_ == 0)
+	{
+		return Statistics{ 0.0, 0.0, 0.0 };
+	}
+
+	Statistics statistics{ section.history[0], 0.0, section.history[0] };
+	for (std::size_t i = 0; i < historyCount_; ++i)
+	{
+		statistics.min = std::min(statistics.min, section.history[i]);
+		statistics.max = std::max(statistics.max, section.history[i]);
+		statistics.average += section.history[i];
+	}
+	statistics.average /= static_cast<double>(historyCount_);
+
+	return statistics;
+}
+
+bool Profiler::writeTrace(const std::string& filename) const
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		return false;
+	}
+
+	// Complete events ("X") with microsecond timestamps, nesting is derived from the times by the viewer
+	file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+
+	const std::size_t oldest = (trace_.size() < TraceCapacity) ? 0 : traceNext_;
+	for (std::size_t i = 0; i < trace_.size(); ++i)
+	{
+		const TraceEvent& event = trace_[(oldest + i) % trace_.size()];
+
+		file << (i == 0 ? "\n" : ",\n")
+			<< "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+			<< ",\"ts\":" << event.start << ",\"dur\":" << event.duration << "}";
+	}
+
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return static_cast<bool>(file);
+}
+
+std::size_t Profiler::findSection(const char* name, bool isCounter)
+{
+	// Only a handful of sections, a linear search beats any map here
+	for (std::size_t i = 0; i < sections_.size(); ++i)
+	{
+		if (sections_[i].name == name || std::strcmp(sections_[i].name, name) == 0)
+		{
+			return i;
+		}
+	}
+
+	sections_.push_back(Section{ name, openSections_.size(), isCounter, 0.0, {} });
+	return sections_.size() - 1;
+}
+
+ProfileScope::ProfileScope(Profiler* profiler, const char* name)
+	: profiler_(profiler)
+{
+	if (profiler_)
+	{
+		profiler_->beginSection(name);
+	}
+}
+
+ProfileScope::~ProfileScope()
+{
+	if (profiler_)
+	{
+		profiler_->endSection();
+	}
+}
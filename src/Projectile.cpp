@@ -1,8 +1,7 @@
 #include <cmath>
 
-#include <SFML/Graphics/RenderTarget.hpp>
-
 #include "Projectile.h"
+#include "SpriteBatch.h"
 #include "DataTables.h"
 #include "Utility.h"
 #include "ResourceHolder.h"
@@ -13,22 +12,28 @@ namespace
 	const std::vector<ProjectileData> Table = initializeProjectileData();
 }
 
-Projectile::Projectile(Type type, const TextureHolder &textures)
+Projectile::Projectile(Type type, const TextureHolder &textures, ParticleRegistry& particles)
 	: Entity(1),
 	type_(type),
-	sprite_(textures.get(Table[type].texture), Table[type].textureRect),
+	sprite_(),
 	targetDirection_()
 {
+	sprite_.setTextureRect(Table[type].textureRect);
+	if (const sf::Texture* texture = textures.find(Table[type].texture))
+	{
+		sprite_.setTexture(*texture);
+	}
+
 	centerOrigin(sprite_);
 
 	// Add particle system for missiles
 	if (isGuided())
 	{
-		std::unique_ptr<EmitterNode> smoke = std::make_unique<EmitterNode>(Particle::Smoke);
+		std::unique_ptr<EmitterNode> smoke = std::make_unique<EmitterNode>(Particle::Smoke, particles, sf::Vector2f(0.f, 1.f));
 		smoke->setPosition(0.f, getBoundingRect().height / 2.f);
 		attachChild(std::move(smoke));
 
-		std::unique_ptr<EmitterNode> propellant = std::make_unique<EmitterNode>(Particle::Propellant);
+		std::unique_ptr<EmitterNode> propellant = std::make_unique<EmitterNode>(Particle::Propellant, particles, sf::Vector2f(0.f, 1.f));
 		propellant->setPosition(0.f, getBoundingRect().height / 2.f);
 		attachChild(std::move(propellant));
 	}
@@ -45,7 +50,7 @@ bool Projectile::isGuided() const
 	return type_ == Missile;
 }
 
-void Projectile::updateCurrent(sf::Time dt, CommandQueue &commands)
+void Projectile::integrateCurrent(sf::Time dt, CommandQueue &commands)
 {
 	if (isGuided())
 	{
@@ -59,18 +64,18 @@ void Projectile::updateCurrent(sf::Time dt, CommandQueue &commands)
 		setVelocity(newVelocity);
 	}
 
-	Entity::updateCurrent(dt, commands);
+	Entity::integrateCurrent(dt, commands);
 }
 
-void Projectile::drawCurrent(sf::RenderTarget &target, sf::RenderStates states) const
+void Projectile::drawCurrent(SpriteBatch& batch, sf::RenderStates states, float) const
 {
-	target.draw(sprite_, states);
+	batch.draw(sprite_, states);
 }
 
 Category Projectile::getCategory() const
 {
 	if (type_ == EnemyBullet)
-		return Category::EnemyAircraft;
+		return Category::EnemyProjectile;
 	else
 		return Category::AlliedProjectile;
 }
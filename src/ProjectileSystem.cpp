@@ -0,0 +1,200 @@
+#include <cassert>
+
+#include <SFML/Graphics/Texture.hpp>
+
+#include "ProjectileSystem.h"
+#include "SpriteBatch.h"
+#include "CollisionGrid.h"
+#include "DataTables.h"
+#include "ResourceHolder.h"
+
+namespace
+{
+	const std::vector<ProjectileData> Table = initializeProjectileData();
+
+	// Storage reserved up front, enough for a busy screen without growing
+	const std::size_t InitialCapacity = 256;
+}
+
+ProjectileSystem::ProjectileSystem(const TextureHolder& textures)
+	: SceneNode()
+	, texture_(textures.find(Textures::Entities))
+	, positions_()
+	, velocities_()
+	, types_()
+	, damages_()
+	, alive_()
+	, deadCount_(0)
+	, stepSeconds_(0.f)
+	, textureRects_()
+	, vertexArray_(sf::Quads)
+{
+	positions_.reserve(InitialCapacity);
+	velocities_.reserve(InitialCapacity);
+	types_.reserve(InitialCapacity);
+	damages_.reserve(InitialCapacity);
+	alive_.reserve(InitialCapacity);
+
+	for (std::size_t type = 0; type < Projectile::TypeCount; ++type)
+	{
+		// All bullets are drawn in one batch, so they must share the texture
+		assert(type == Projectile::Missile || Table[type].texture == Textures::Entities);
+		textureRects_[type] = Table[type].textureRect;
+	}
+}
+
+void ProjectileSystem::spawn(Projectile::Type type, sf::Vector2f position, sf::Vector2f velocity)
+{
+	assert(type != Projectile::Missile && "ProjectileSystem::spawn - Missiles are scene nodes");
+
+	positions_.push_back(position);
+	velocities_.push_back(velocity);
+	types_.push_back(type);
+	damages_.push_back(Table[type].damage);
+	alive_.push_back(1);
+}
+
+float ProjectileSystem::getMaxSpeed(Projectile::Type type) const
+{
+	return Table[type].speed;
+}
+
+std::size_t ProjectileSystem::getBulletCount() const
+{
+	return positions_.size() - deadCount_;
+}
+
+void ProjectileSystem::removeOutside(const sf::FloatRect& bounds)
+{
+	for (std::size_t i = 0; i < positions_.size(); ++i)
+	{
+		if (alive_[i] && !bounds.intersects(getBounds(i)))
+		{
+			kill(i);
+		}
+	}
+
+	removeDead();
+}
+
+void ProjectileSystem::checkCollisions(const CollisionGrid& grid, std::vector<Hit>& hits)
+{
+	hits.clear();
+
+	for (std::size_t i = 0; i < positions_.size(); ++i)
+	{
+		if (!alive_[i])
+		{
+			continue;
+		}
+
+		Category targets = (types_[i] == Projectile::AlliedBullet) ? Category::EnemyAircraft : Category::PlayerAircraft;
+
+		// A bullet is used up by the first aircraft it touches
+		if (SceneNode* target = grid.findFirst(getBounds(i), targets))
+		{
+			hits.push_back(Hit{ target, damages_[i], positions_[i], velocities_[i] });
+			kill(i);
+		}
+	}
+
+	removeDead();
+}
+
+Category ProjectileSystem::getCategory() const
+{
+	return Category::ProjectileSystem;
+}
+
+void ProjectileSystem::integrateCurrent(sf::Time dt, CommandQueue&)
+{
+	const float seconds = dt.asSeconds();
+	const std::size_t count = positions_.size();
+	stepSeconds_ = seconds;
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		positions_[i] += velocities_[i] * seconds;
+	}
+}
+
+void ProjectileSystem::drawCurrent(SpriteBatch& batch, sf::RenderStates states, float alpha) const
+{
+	computeVertices(alpha);
+
+	states.texture = texture_;
+	batch.draw(vertexArray_, states);
+}
+
+sf::FloatRect ProjectileSystem::getBounds(std::size_t index) const
+{
+	const sf::IntRect& rect = textureRects_[types_[index]];
+	sf::Vector2f size(static_cast<float>(rect.width), static_cast<float>(rect.height));
+
+	// Positions are bullet centers, like the centered sprite origin of Projectile
+	return sf::FloatRect(positions_[index] - size / 2.f, size);
+}
+
+void ProjectileSystem::kill(std::size_t index)
+{
+	alive_[index] = 0;
+	++deadCount_;
+}
+
+void ProjectileSystem::removeDead()
+{
+	if (deadCount_ == 0)
+	{
+		return;
+	}
+
+	// Swap dead bullets with the last live one, the order of bullets does not matter
+	std::size_t i = 0;
+	while (i < positions_.size())
+	{
+		if (alive_[i])
+		{
+			++i;
+			continue;
+		}
+
+		positions_[i] = positions_.back();
+		velocities_[i] = velocities_.back();
+		types_[i] = types_.back();
+		damages_[i] = damages_.back();
+		alive_[i] = alive_.back();
+
+		positions_.pop_back();
+		velocities_.pop_back();
+		types_.pop_back();
+		damages_.pop_back();
+		alive_.pop_back();
+	}
+
+	deadCount_ = 0;
+}
+
+void ProjectileSystem::computeVertices(float alpha) const
+{
+	vertexArray_.resize(positions_.size() * 4);
+	const float interpolationSeconds = stepSeconds_ * (alpha - 1.f);
+
+	for (std::size_t i = 0; i < positions_.size(); ++i)
+	{
+		sf::FloatRect bounds = getBounds(i);
+		bounds.left += velocities_[i].x * interpolationSeconds;
+		bounds.top += velocities_[i].y * interpolationSeconds;
+		const sf::IntRect& rect = textureRects_[types_[i]];
+
+		float left = static_cast<float>(rect.left);
+		float top = static_cast<float>(rect.top);
+		float right = static_cast<float>(rect.left + rect.width);
+		float bottom = static_cast<float>(rect.top + rect.height);
+
+		sf::Vertex* quad = &vertexArray_[i * 4];
+		quad[0] = sf::Vertex(sf::Vector2f(bounds.left, bounds.top), sf::Vector2f(left, top));
+		quad[1] = sf::Vertex(sf::Vector2f(bounds.left + bounds.width, bounds.top), sf::Vector2f(right, top));
+		quad[2] = sf::Vertex(sf::Vector2f(bounds.left + bounds.width, bounds.top + bounds.height), sf::Vector2f(right, bottom));
+		quad[3] = sf::Vertex(sf::Vector2f(bounds.left, bounds.top + bounds.height), sf::Vector2f(left, bottom));
+	}
+}
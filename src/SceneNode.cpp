@@ -1,24 +1,40 @@
 #include <cassert>
 #include <limits>
 #include <cmath>
+#include <algorithm>
+#include <functional>
 
 #include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 
 #include "SceneNode.h"
 #include "Command.h"
+#include "CollisionGrid.h"
+#include "CategoryRegistry.h"
+#include "SpriteBatch.h"
 
 
 SceneNode::SceneNode(Category category)
 	: children_()
 	, parent_(nullptr)
 	, defaultCategory_(category)
+	, categoryRegistry_(nullptr)
+	, worldTransform_()
+	, isWorldTransformDirty_(true)
+	, previousPosition_()
+	, previousRotation_(0.f)
+	, hasPreviousState_(false)
 {
 }
 
 void SceneNode::attachChild(Ptr child)
 {
 	child->parent_ = this;
+	child->markWorldTransformDirty();
+	if (categoryRegistry_ != nullptr)
+	{
+		child->setCategoryRegistry(categoryRegistry_);
+	}
 	children_.push_back(std::move(child));
 }
 
@@ -31,6 +47,8 @@ SceneNode::Ptr SceneNode::detachChild(const SceneNode& node)
 
 	Ptr result = std::move(*found);
 	result->parent_ = nullptr;
+	result->markWorldTransformDirty();
+	result->setCategoryRegistry(nullptr);
 	children_.erase(found);
 	return result;
 }
@@ -53,26 +71,86 @@ void SceneNode::updateChildren(sf::Time dt, CommandQueue& commands)
 	}
 }
 
+void SceneNode::integrate(sf::Time dt, CommandQueue& commands)
+{
+	integrateCurrent(dt, commands);
+
+	for (const Ptr& child : children_)
+	{
+		child->integrate(dt, commands);
+	}
+}
+
+void SceneNode::integrateCurrent(sf::Time, CommandQueue&)
+{
+}
+
 void SceneNode::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	// Drawn directly as sf::Drawable: batch this subtree on its own
+	SpriteBatch batch;
+	draw(batch, states, 1.f);
+	batch.flush(target);
+}
+
+void SceneNode::draw(SpriteBatch& batch, sf::RenderStates states, float alpha) const
 {
 	// Apply transform of current node
-	states.transform *= getTransform();
+	states.transform *= getInterpolatedTransform(alpha);
 
 	// Draw node and children with changed transform
-	drawCurrent(target, states);
-	drawChildren(target, states);
+	drawCurrent(batch, states, alpha);
+	drawChildren(batch, states, alpha);
 }
 
-void SceneNode::drawCurrent(sf::RenderTarget&, sf::RenderStates) const
+void SceneNode::drawCurrent(SpriteBatch&, sf::RenderStates, float) const
 {
 	// Do nothing by default
 }
 
-void SceneNode::drawChildren(sf::RenderTarget& target, sf::RenderStates states) const
+void SceneNode::drawChildren(SpriteBatch& batch, sf::RenderStates states, float alpha) const
+{
+	for (const Ptr& child : children_)
+	{
+		child->draw(batch, states, alpha);
+	}
+}
+
+sf::Transform SceneNode::getInterpolatedTransform(float alpha) const
+{
+	// Most nodes did not move during the step, they keep the cached transform
+	if (!hasPreviousState_ || alpha >= 1.f || (previousPosition_ == getPosition() && previousRotation_ == getRotation()))
+	{
+		return getTransform();
+	}
+
+	// Turn the short way round, rotations are kept in [0, 360)
+	float rotationDelta = getRotation() - previousRotation_;
+	if (rotationDelta > 180.f)
+	{
+		rotationDelta -= 360.f;
+	}
+	else if (rotationDelta < -180.f)
+	{
+		rotationDelta += 360.f;
+	}
+
+	sf::Transformable interpolated(*this);
+	interpolated.setPosition(previousPosition_ + (getPosition() - previousPosition_) * alpha);
+	interpolated.setRotation(previousRotation_ + rotationDelta * alpha);
+
+	return interpolated.getTransform();
+}
+
+void SceneNode::storePreviousState()
 {
+	previousPosition_ = getPosition();
+	previousRotation_ = getRotation();
+	hasPreviousState_ = true;
+
 	for (const Ptr& child : children_)
 	{
-		child->draw(target, states);
+		child->storePreviousState();
 	}
 }
 
@@ -97,14 +175,102 @@ sf::Vector2f SceneNode::getWorldPosition() const
 
 sf::Transform SceneNode::getWorldTransform() const
 {
-	sf::Transform transform = sf::Transform::Identity;
+	// Only recompute if this node or one of its ancestors changed since the last call
+	if (isWorldTransformDirty_)
+	{
+		worldTransform_ = (parent_ != nullptr) ? parent_->getWorldTransform() * getTransform() : getTransform();
+		isWorldTransformDirty_ = false;
+	}
+
+	return worldTransform_;
+}
+
+void SceneNode::setPosition(float x, float y)
+{
+	sf::Transformable::setPosition(x, y);
+	markWorldTransformDirty();
+}
+
+void SceneNode::setPosition(const sf::Vector2f& position)
+{
+	sf::Transformable::setPosition(position);
+	markWorldTransformDirty();
+}
+
+void SceneNode::setRotation(float angle)
+{
+	sf::Transformable::setRotation(angle);
+	markWorldTransformDirty();
+}
+
+void SceneNode::setScale(float factorX, float factorY)
+{
+	sf::Transformable::setScale(factorX, factorY);
+	markWorldTransformDirty();
+}
+
+void SceneNode::setScale(const sf::Vector2f& factors)
+{
+	sf::Transformable::setScale(factors);
+	markWorldTransformDirty();
+}
+
+void SceneNode::setOrigin(float x, float y)
+{
+	sf::Transformable::setOrigin(x, y);
+	markWorldTransformDirty();
+}
+
+void SceneNode::setOrigin(const sf::Vector2f& origin)
+{
+	sf::Transformable::setOrigin(origin);
+	markWorldTransformDirty();
+}
+
+void SceneNode::move(float offsetX, float offsetY)
+{
+	sf::Transformable::move(offsetX, offsetY);
+	markWorldTransformDirty();
+}
 
-	for (const SceneNode* node = this; node != nullptr; node = node->parent_)
+void SceneNode::move(const sf::Vector2f& offset)
+{
+	sf::Transformable::move(offset);
+	markWorldTransformDirty();
+}
+
+void SceneNode::rotate(float angle)
+{
+	sf::Transformable::rotate(angle);
+	markWorldTransformDirty();
+}
+
+void SceneNode::scale(float factorX, float factorY)
+{
+	sf::Transformable::scale(factorX, factorY);
+	markWorldTransformDirty();
+}
+
+void SceneNode::scale(const sf::Vector2f& factor)
+{
+	sf::Transformable::scale(factor);
+	markWorldTransformDirty();
+}
+
+void SceneNode::markWorldTransformDirty()
+{
+	// A dirty node never has clean descendants (a clean transform requires clean ancestors),
+	// so propagation can stop at nodes that are already dirty
+	if (isWorldTransformDirty_)
 	{
-		transform = node->getTransform() * transform;
+		return;
 	}
 
-	return transform;
+	isWorldTransformDirty_ = true;
+	for (const Ptr& child : children_)
+	{
+		child->markWorldTransformDirty();
+	}
 }
 
 void SceneNode::onCommand(const Command& command, sf::Time dt)
@@ -127,6 +293,52 @@ Category SceneNode::getCategory() const
 	return defaultCategory_;
 }
 
+void SceneNode::setCategoryRegistry(CategoryRegistry* registry)
+{
+	if (categoryRegistry_ == registry)
+	{
+		return;
+	}
+
+	if (categoryRegistry_ != nullptr)
+	{
+		categoryRegistry_->remove(*this);
+	}
+
+	categoryRegistry_ = registry;
+	if (categoryRegistry_ != nullptr && getCategory() != Category::None)
+	{
+		categoryRegistry_->add(*this);
+	}
+
+	for (const Ptr& child : children_)
+	{
+		child->setCategoryRegistry(registry);
+	}
+}
+
+void SceneNode::collectChildren(std::vector<SceneNode*>& nodes) const
+{
+	for (const Ptr& child : children_)
+	{
+		nodes.push_back(child.get());
+	}
+}
+
+void SceneNode::scheduleCategoryRemoval()
+{
+	if (categoryRegistry_ != nullptr)
+	{
+		categoryRegistry_->scheduleRemoval(*this);
+		categoryRegistry_ = nullptr;
+	}
+
+	for (const Ptr& child : children_)
+	{
+		child->scheduleCategoryRemoval();
+	}
+}
+
 void SceneNode::checkSceneCollision(SceneNode& sceneGraph, std::set<Pair>& collisionPairs)
 {
 	checkNodeCollision(sceneGraph, collisionPairs);
@@ -148,14 +360,44 @@ void SceneNode::checkNodeCollision(SceneNode& node, std::set<Pair>& collisionPai
 	}
 }
 
+void SceneNode::insertColliders(CollisionGrid& grid)
+{
+	// Bounding rect is computed once per node and frame, destroyed nodes never collide
+	if (grid.isCollidable(getCategory()) && !isDestroyed())
+	{
+		grid.insert(*this, getBoundingRect());
+	}
+
+	for (const Ptr& child : children_)
+	{
+		child->insertColliders(grid);
+	}
+}
+
 void SceneNode::removeWrecks()
 {
-	// Remove all children which request to
-	auto wreckFieldBegin = std::remove_if(children_.begin(), children_.end(), std::mem_fn(&SceneNode::isMarkedForRemoval));
+	// Remove all children which request to (partition instead of remove_if, the wrecks must stay valid until erased).
+	// Swapping the survivors forward keeps their order like std::stable_partition, without its temporary buffer.
+	auto wreckFieldBegin = children_.begin();
+	for (auto itr = children_.begin(); itr != children_.end(); ++itr)
+	{
+		if (!(*itr)->isMarkedForRemoval())
+		{
+			std::iter_swap(wreckFieldBegin++, itr);
+		}
+	}
+
+	std::for_each(wreckFieldBegin, children_.end(), std::mem_fn(&SceneNode::scheduleCategoryRemoval));
 	children_.erase(wreckFieldBegin, children_.end());
 
 	// Call function recursively on children
 	std::for_each(children_.begin(), children_.end(), std::mem_fn(&SceneNode::removeWrecks));
+
+	// The root compacts the registry once, after the wrecks of the whole graph have been collected
+	if (parent_ == nullptr && categoryRegistry_ != nullptr)
+	{
+		categoryRegistry_->compact();
+	}
 }
 
 sf::FloatRect SceneNode::getBoundingRect() const
@@ -0,0 +1,117 @@
+#include "SendBuffer.h"
+
+SendBuffer::Counters::Counters()
+	: messages(0)
+	, sendCalls(0)
+	, bytes(0)
+{
+}
+
+void SendBuffer::Counters::add(const Counters& counters)
+{
+	messages += counters.messages;
+	sendCalls += counters.sendCalls;
+	bytes += counters.bytes;
+}
+
+
+SendBuffer::SendBuffer(sf::TcpSocket& socket)
+	: socket_(socket)
+	, buffer_()
+	, counters_()
+	, isStalled_(false)
+{
+}
+
+void SendBuffer::append(const sf::Packet& packet)
+{
+	if (isStalled_)
+	{
+		return;
+	}
+
+	// Same size prefix as sf::TcpSocket::send(sf::Packet&): big endian, counting the data only
+	const std::size_t size = packet.getDataSize();
+	const char header[] =
+	{
+		static_cast<char>(size >> 24),
+		static_cast<char>(size >> 16),
+		static_cast<char>(size >> 8),
+		static_cast<char>(size),
+	};
+
+	if (buffer_.size() + sizeof(header) + size > FlushSize)
+	{
+		flush();
+	}
+
+	const char* data = static_cast<const char*>(packet.getData());
+	buffer_.insert(buffer_.end(), header, header + sizeof(header));
+	buffer_.insert(buffer_.end(), data, data + size);
+	++counters_.messages;
+}
+
+void SendBuffer::appendFramed(const void* data, std::size_t size)
+{
+	if (isStalled_)
+	{
+		return;
+	}
+
+	if (buffer_.size() + size > FlushSize)
+	{
+		flush();
+	}
+
+	const char* bytes = static_cast<const char*>(data);
+	buffer_.insert(buffer_.end(), bytes, bytes + size);
+	++counters_.messages;
+}
+
+void SendBuffer::flush()
+{
+	if (buffer_.empty())
+	{
+		return;
+	}
+
+	std::size_t sent = 0;
+	sf::Socket::Status status = socket_.send(buffer_.data(), buffer_.size(), sent);
+	++counters_.sendCalls;
+	counters_.bytes += sent;
+
+	if (status == sf::Socket::Partial || status == sf::Socket::NotReady)
+	{
+		// The socket's own buffer is full, the rest goes out with the next flush
+		buffer_.erase(buffer_.begin(), buffer_.begin() + sent);
+
+		if (buffer_.size() > MaxPendingSize)
+		{
+			buffer_.clear();
+			buffer_.shrink_to_fit();
+			isStalled_ = true;
+		}
+	}
+	else
+	{
+		// Sent completely, or the connection is gone and the owner notices its timeout
+		buffer_.clear();
+	}
+}
+
+bool SendBuffer::isEmpty() const
+{
+	return buffer_.empty();
+}
+
+bool SendBuffer::isStalled() const
+{
+	return isStalled_;
+}
+
+SendBuffer::Counters SendBuffer::takeCounters()
+{
+	Counters counters = counters_;
+	counters_ = Counters();
+	return counters;
+}
@@ -21,6 +21,7 @@ SettingsState::SettingsState(StateStack& stack, Context context)
 		addButtonLabel(magic_enum::enum_integer(PlayerAction::LaunchMissile), x, 5, "Missile", context);
 	}
 
+	addGraphicsButtons(context);
 	updateLabels();
 
 	auto backButton = std::make_shared<GUI::Button>(context);
@@ -100,6 +101,11 @@ void SettingsState::updateLabels()
 		bindingLabels_[i + magic_enum::enum_count<PlayerAction>()]->setText(toString(key2));
 
 	}
+
+	const std::array<const char*, 3> qualityNames = { "Off", "Low", "High" };
+	const GraphicsSettings& graphics = *getContext().graphics;
+	bloomQualityLabel_->setText(qualityNames[magic_enum::enum_integer(graphics.bloomQuality)]);
+	bloomRateLabel_->setText(graphics.isBloomHalfRate ? "Half" : "Full");
 }
 
 void SettingsState::addButtonLabel(std::size_t index, std::size_t x, std::size_t y, const std::string& text, Context context)
@@ -118,3 +124,37 @@ void SettingsState::addButtonLabel(std::size_t index, std::size_t x, std::size_t
 	guiContainer_.pack(bindingButtons_[index]);
 	guiContainer_.pack(bindingLabels_[index]);
 }
+
+void SettingsState::addGraphicsButtons(Context context)
+{
+	// Each click selects the next bloom quality: Off, Low, High
+	auto bloomQualityButton = std::make_shared<GUI::Button>(context);
+	bloomQualityButton->setPosition(480.f, 620.f);
+	bloomQualityButton->setText("Bloom");
+	bloomQualityButton->setCallback([this]()
+		{
+			BloomQuality& quality = getContext().graphics->bloomQuality;
+			quality = static_cast<BloomQuality>((magic_enum::enum_integer(quality) + 1) % magic_enum::enum_count<BloomQuality>());
+			updateLabels();
+		});
+
+	bloomQualityLabel_ = std::make_shared<GUI::Label>("", *context.fonts);
+	bloomQualityLabel_->setPosition(700.f, 635.f);
+
+	auto bloomRateButton = std::make_shared<GUI::Button>(context);
+	bloomRateButton->setPosition(480.f, 670.f);
+	bloomRateButton->setText("Bloom Rate");
+	bloomRateButton->setCallback([this]()
+		{
+			getContext().graphics->isBloomHalfRate = !getContext().graphics->isBloomHalfRate;
+			updateLabels();
+		});
+
+	bloomRateLabel_ = std::make_shared<GUI::Label>("", *context.fonts);
+	bloomRateLabel_->setPosition(700.f, 685.f);
+
+	guiContainer_.pack(bloomQualityButton);
+	guiContainer_.pack(bloomQualityLabel_);
+	guiContainer_.pack(bloomRateButton);
+	guiContainer_.pack(bloomRateLabel_);
+}
@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "Snapshot.h"
+
+namespace
+{
+	// Positions travel in quarter pixels, Int16 covers +-8191 pixels which fits the 5000 pixel world
+	const float QuantizationScale = 4.f;
+
+	// Set in the identifier of an entry encoded as Int8 offset to its base position
+	const sf::Uint16 DeltaFlag = 0x8000;
+
+	// Set in the identifier of an entry followed by its hitpoints and missile ammo
+	const sf::Uint16 StatusFlag = 0x4000;
+
+	bool lessIdentifier(const Snapshot::Entry& entry, sf::Uint16 identifier)
+	{
+		return entry.identifier < identifier;
+	}
+
+	bool fitsInt8(int value)
+	{
+		return value >= std::numeric_limits<sf::Int8>::min() && value <= std::numeric_limits<sf::Int8>::max();
+	}
+
+	bool hasSameStatus(const Snapshot::Entry& entry, const Snapshot::Entry& baseEntry)
+	{
+		return entry.hitpoints == baseEntry.hitpoints && entry.missileAmmo == baseEntry.missileAmmo;
+	}
+
+	// Walks two identifier-sorted entry lists, calling removed(baseEntry) for entries only in base
+	// and changed(entry, baseEntryOrNull) for new entries or entries whose position or status differs
+	template <typename Removed, typename Changed>
+	void compare(const std::vector<Snapshot::Entry>& current, const std::vector<Snapshot::Entry>& base, Removed removed, Changed changed)
+	{
+		auto itr = current.begin();
+		auto baseItr = base.begin();
+
+		while (itr != current.end() || baseItr != base.end())
+		{
+			if (baseItr == base.end() || (itr != current.end() && itr->identifier < baseItr->identifier))
+			{
+				changed(*itr++, nullptr);
+			}
+			else if (itr == current.end() || baseItr->identifier < itr->identifier)
+			{
+				removed(*baseItr++);
+			}
+			else
+			{
+				if (itr->x != baseItr->x || itr->y != baseItr->y || !hasSameStatus(*itr, *baseItr))
+				{
+					changed(*itr, &*baseItr);
+				}
+				++itr;
+				++baseItr;
+			}
+		}
+	}
+}
+
+Snapshot::Snapshot()
+	: sequence(0)
+	, battleFieldPosition(0)
+	, entries()
+{
+}
+
+sf::Int16 Snapshot::quantize(float value)
+{
+	float scaled = std::round(value * QuantizationScale);
+	scaled = std::clamp(scaled, static_cast<float>(std::numeric_limits<sf::Int16>::min()), static_cast<float>(std::numeric_limits<sf::Int16>::max()));
+	return static_cast<sf::Int16>(scaled);
+}
+
+float Snapshot::dequantize(sf::Int16 value)
+{
+	return static_cast<float>(value) / QuantizationScale;
+}
+
+void Snapshot::setAircraft(sf::Int32 identifier, sf::Vector2f position, int hitpoints, int missileAmmo)
+{
+	assert(identifier >= 0 && identifier < StatusFlag && "Snapshot::setAircraft - Identifier does not fit the snapshot format");
+
+	const sf::Uint16 key = static_cast<sf::Uint16>(identifier);
+	auto itr = std::lower_bound(entries.begin(), entries.end(), key, lessIdentifier);
+	if (itr == entries.end() || itr->identifier != key)
+	{
+		itr = entries.insert(itr, Entry{ key, 0, 0, 0, 0 });
+	}
+
+	itr->x = quantize(position.x);
+	itr->y = quantize(position.y);
+	itr->hitpoints = static_cast<sf::Uint16>(std::clamp(hitpoints, 0, static_cast<int>(std::numeric_limits<sf::Uint16>::max())));
+	itr->missileAmmo = static_cast<sf::Uint8>(std::clamp(missileAmmo, 0, static_cast<int>(std::numeric_limits<sf::Uint8>::max())));
+}
+
+sf::Vector2f Snapshot::getPosition(const Entry& entry) const
+{
+	return sf::Vector2f(dequantize(entry.x), dequantize(entry.y));
+}
+
+void Snapshot::write(sf::Packet& packet, const Snapshot* base) const
+{
+	static const std::vector<Entry> NoEntries;
+	const std::vector<Entry>& baseEntries = base ? base->entries : NoEntries;
+
+	packet << sequence << (base ? base->sequence : sequence) << battleFieldPosition;
+
+	// Counts go first, so the lists are walked twice instead of being collected
+	sf::Uint8 removedCount = 0;
+	sf::Uint8 changedCount = 0;
+	compare(entries, baseEntries,
+		[&](const Entry&) { ++removedCount; },
+		[&](const Entry&, const Entry*) { ++changedCount; });
+
+	packet << removedCount;
+	compare(entries, baseEntries,
+		[&](const Entry& removed) { packet << removed.identifier; },
+		[](const Entry&, const Entry*) {});
+
+	packet << changedCount;
+	compare(entries, baseEntries,
+		[](const Entry&) {},
+		[&](const Entry& entry, const Entry* baseEntry)
+		{
+			// Hitpoints and ammo change far less often than the position, they only go out when they did
+			const bool hasStatus = !baseEntry || !hasSameStatus(entry, *baseEntry);
+			const sf::Uint16 identifier = hasStatus ? static_cast<sf::Uint16>(entry.identifier | StatusFlag) : entry.identifier;
+
+			// Most aircraft only moved a few pixels since the base, which fits in one byte per axis
+			if (baseEntry && fitsInt8(entry.x - baseEntry->x) && fitsInt8(entry.y - baseEntry->y))
+			{
+				packet << static_cast<sf::Uint16>(identifier | DeltaFlag)
+					<< static_cast<sf::Int8>(entry.x - baseEntry->x)
+					<< static_cast<sf::Int8>(entry.y - baseEntry->y);
+			}
+			else
+			{
+				packet << identifier << entry.x << entry.y;
+			}
+
+			if (hasStatus)
+			{
+				packet << entry.hitpoints << entry.missileAmmo;
+			}
+		});
+}
+
+bool Snapshot::read(sf::Packet& packet, const SnapshotHistory& history)
+{
+	sf::Uint16 baseSequence;
+	packet >> sequence >> baseSequence >> battleFieldPosition;
+
+	entries.clear();
+	if (baseSequence != sequence)
+	{
+		const Snapshot* base = history.find(baseSequence);
+		if (!base)
+		{
+			return false;
+		}
+		entries = base->entries;
+	}
+
+	sf::Uint8 removedCount = 0;
+	packet >> removedCount;
+	for (sf::Uint8 i = 0; i < removedCount; ++i)
+	{
+		sf::Uint16 identifier;
+		packet >> identifier;
+
+		auto itr = std::lower_bound(entries.begin(), entries.end(), identifier, lessIdentifier);
+		if (itr != entries.end() && itr->identifier == identifier)
+		{
+			entries.erase(itr);
+		}
+	}
+
+	sf::Uint8 changedCount = 0;
+	packet >> changedCount;
+	for (sf::Uint8 i = 0; i < changedCount && packet; ++i)
+	{
+		sf::Uint16 identifier;
+		packet >> identifier;
+
+		const bool isDelta = (identifier & DeltaFlag) != 0;
+		const bool hasStatus = (identifier & StatusFlag) != 0;
+		identifier &= ~(DeltaFlag | StatusFlag);
+
+		auto itr = std::lower_bound(entries.begin(), entries.end(), identifier, lessIdentifier);
+		if (itr == entries.end() || itr->identifier != identifier)
+		{
+			// A delta or a missing status needs the aircraft in the base snapshot
+			if (isDelta || !hasStatus)
+			{
+				return false;
+			}
+			itr = entries.insert(itr, Entry{ identifier, 0, 0, 0, 0 });
+		}
+
+		if (isDelta)
+		{
+			sf::Int8 dx;
+			sf::Int8 dy;
+			packet >> dx >> dy;
+
+			itr->x = static_cast<sf::Int16>(itr->x + dx);
+			itr->y = static_cast<sf::Int16>(itr->y + dy);
+		}
+		else
+		{
+			packet >> itr->x >> itr->y;
+		}
+
+		if (hasStatus)
+		{
+			packet >> itr->hitpoints >> itr->missileAmmo;
+		}
+	}
+
+	return static_cast<bool>(packet);
+}
+
+bool Snapshot::peekSequence(const sf::Packet& packet, sf::Uint16& sequence)
+{
+	const std::size_t position = packet.getReadPosition();
+	if (packet.getDataSize() < position + sizeof(sf::Uint16))
+	{
+		return false;
+	}
+
+	// Network byte order, like sf::Packet's operator>>
+	const sf::Uint8* data = static_cast<const sf::Uint8*>(packet.getData()) + position;
+	sequence = static_cast<sf::Uint16>((data[0] << 8) | data[1]);
+	return true;
+}
+
+SnapshotHistory::SnapshotHistory()
+	: snapshots_()
+	, isUsed_()
+{
+}
+
+void SnapshotHistory::add(const Snapshot& snapshot)
+{
+	const std::size_t slot = snapshot.sequence % Size;
+	snapshots_[slot] = snapshot;
+	isUsed_[slot] = true;
+}
+
+const Snapshot* SnapshotHistory::find(sf::Uint16 sequence) const
+{
+	// A slot is reused every Size sequences, older snapshots are gone
+	const std::size_t slot = sequence % Size;
+	if (!isUsed_[slot] || snapshots_[slot].sequence != sequence)
+	{
+		return nullptr;
+	}
+
+	return &snapshots_[slot];
+}
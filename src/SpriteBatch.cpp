@@ -0,0 +1,139 @@
+#include <cmath>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include "SpriteBatch.h"
+
+std::size_t SpriteBatch::drawCallCount_ = 0;
+
+SpriteBatch::SpriteBatch()
+	: vertices_()
+	, items_()
+	, overlayItems_()
+{
+}
+
+void SpriteBatch::draw(const sf::Sprite& sprite, sf::RenderStates states)
+{
+	// Like sf::Sprite, nothing is drawn without texture
+	if (sprite.getTexture() == nullptr)
+	{
+		return;
+	}
+
+	states.texture = sprite.getTexture();
+	states.transform *= sprite.getTransform();
+
+	const sf::IntRect& rect = sprite.getTextureRect();
+	const float width = static_cast<float>(std::abs(rect.width));
+	const float height = static_cast<float>(std::abs(rect.height));
+
+	const float left = static_cast<float>(rect.left);
+	const float top = static_cast<float>(rect.top);
+	const float right = left + static_cast<float>(rect.width);
+	const float bottom = top + static_cast<float>(rect.height);
+
+	const sf::Color color = sprite.getColor();
+	const sf::Transform& transform = states.transform;
+
+	Item& batch = getBatch(states);
+	vertices_.push_back(sf::Vertex(transform.transformPoint(0.f, 0.f), color, sf::Vector2f(left, top)));
+	vertices_.push_back(sf::Vertex(transform.transformPoint(width, 0.f), color, sf::Vector2f(right, top)));
+	vertices_.push_back(sf::Vertex(transform.transformPoint(width, height), color, sf::Vector2f(right, bottom)));
+	vertices_.push_back(sf::Vertex(transform.transformPoint(0.f, height), color, sf::Vector2f(left, bottom)));
+	batch.vertexEnd = vertices_.size();
+}
+
+void SpriteBatch::draw(const sf::VertexArray& vertices, const sf::RenderStates& states)
+{
+	// Only quads can be appended to a batch
+	if (vertices.getPrimitiveType() != sf::Quads)
+	{
+		draw(static_cast<const sf::Drawable&>(vertices), states);
+		return;
+	}
+
+	Item& batch = getBatch(states);
+	for (std::size_t i = 0; i < vertices.getVertexCount(); ++i)
+	{
+		sf::Vertex vertex = vertices[i];
+		vertex.position = states.transform.transformPoint(vertex.position);
+		vertices_.push_back(vertex);
+	}
+	batch.vertexEnd = vertices_.size();
+}
+
+void SpriteBatch::draw(const sf::Drawable& drawable, const sf::RenderStates& states)
+{
+	items_.push_back(Item{ &drawable, states, 0, 0 });
+}
+
+void SpriteBatch::drawOverlay(const sf::Drawable& drawable, const sf::RenderStates& states)
+{
+	overlayItems_.push_back(Item{ &drawable, states, 0, 0 });
+}
+
+void SpriteBatch::flush(sf::RenderTarget& target)
+{
+	for (const Item& item : items_)
+	{
+		submit(target, item);
+	}
+
+	for (const Item& item : overlayItems_)
+	{
+		submit(target, item);
+	}
+
+	// Keep the capacity for the next frame
+	vertices_.clear();
+	items_.clear();
+	overlayItems_.clear();
+}
+
+std::size_t SpriteBatch::getDrawCallCount()
+{
+	return drawCallCount_;
+}
+
+void SpriteBatch::resetDrawCallCount()
+{
+	drawCallCount_ = 0;
+}
+
+SpriteBatch::Item& SpriteBatch::getBatch(const sf::RenderStates& states)
+{
+	// Continue the last batch if it has the same render states, vertices are already transformed
+	if (!items_.empty())
+	{
+		Item& last = items_.back();
+		if (last.drawable == nullptr && last.states.texture == states.texture
+			&& last.states.shader == states.shader && last.states.blendMode == states.blendMode)
+		{
+			return last;
+		}
+	}
+
+	sf::RenderStates batchStates(states.blendMode, sf::Transform::Identity, states.texture, states.shader);
+	items_.push_back(Item{ nullptr, batchStates, vertices_.size(), vertices_.size() });
+	return items_.back();
+}
+
+void SpriteBatch::submit(sf::RenderTarget& target, const Item& item)
+{
+	if (item.drawable != nullptr)
+	{
+		target.draw(*item.drawable, item.states);
+	}
+	else if (item.vertexEnd > item.vertexBegin)
+	{
+		target.draw(&vertices_[item.vertexBegin], item.vertexEnd - item.vertexBegin, sf::Quads, item.states);
+	}
+	else
+	{
+		return;
+	}
+
+	++drawCallCount_;
+}
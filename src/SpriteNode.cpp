@@ -1,6 +1,5 @@
-#include <SFML/Graphics/RenderTarget.hpp>
-
 #include "SpriteNode.h"
+#include "SpriteBatch.h"
 
 SpriteNode::SpriteNode(const sf::Texture& texture)
 	: sprite_(texture)
@@ -12,7 +11,7 @@ SpriteNode::SpriteNode(const sf::Texture& texture, const sf::IntRect& textureRec
 {
 }
 
-void SpriteNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+void SpriteNode::drawCurrent(SpriteBatch& batch, sf::RenderStates states, float) const
 {
-	target.draw(sprite_, states);
+	batch.draw(sprite_, states);
 }
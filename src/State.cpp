@@ -2,7 +2,8 @@
 #include "State.h"
 
 State::Context::Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts,
-	MusicPlayer& music, SoundPlayer& sounds, KeyBinding& keys1, KeyBinding& keys2)
+	MusicPlayer& music, SoundPlayer& sounds, KeyBinding& keys1, KeyBinding& keys2, Profiler& profiler,
+	ThreadPool& threadPool, GraphicsSettings& graphics)
 	: window(&window)
 	, textures(&textures)
 	, fonts(&fonts)
@@ -10,6 +11,9 @@ State::Context::Context(sf::RenderWindow& window, TextureHolder& textures, FontH
 	, sounds(&sounds)
 	, keys1(&keys1)
 	, keys2(&keys2)
+	, profiler(&profiler)
+	, threadPool(&threadPool)
+	, graphics(&graphics)
 {
 }
 
@@ -43,6 +47,11 @@ State::Context State::getContext() const
 	return context_;
 }
 
+float State::getRenderAlpha() const
+{
+	return stack_->getRenderAlpha();
+}
+
 void State::onActivate()
 {
 }
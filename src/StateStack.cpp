@@ -8,14 +8,20 @@ StateStack::StateStack(State::Context context)
 	, pendingList_()
 	, context_(context)
 	, factories_()
+	, updatedStateCount_(0)
+	, renderAlpha_(1.f)
 {
 }
 
 void StateStack::update(sf::Time dt)
 {
+	ProfileScope scope(context_.profiler, "state update");
+
 	// Iterate from top to bottom, stop as soon as update() returns false
+	updatedStateCount_ = 0;
 	for (auto itr = stack_.rbegin(); itr != stack_.rend(); ++itr)
 	{
+		++updatedStateCount_;
 		if (!(*itr)->update(dt))
 			break;
 	}
@@ -23,15 +29,23 @@ void StateStack::update(sf::Time dt)
 	applyPendingChanges();
 }
 
-void StateStack::draw()
+void StateStack::draw(float alpha)
 {
+	ProfileScope scope(context_.profiler, "state draw");
+
 	// Draw all active states from bottom to top
-	for (const auto& state : stack_)
+	for (std::size_t i = 0; i < stack_.size(); ++i)
 	{
-		state->draw();
+		renderAlpha_ = (i + updatedStateCount_ >= stack_.size()) ? alpha : 1.f;
+		stack_[i]->draw();
 	}
 }
 
+float StateStack::getRenderAlpha() const
+{
+	return renderAlpha_;
+}
+
 void StateStack::handleEvent(const sf::Event& event)
 {
 	// Iterate from top to bottom, stop as soom as handlEvent() returns false
@@ -1,20 +1,23 @@
-#include <SFML/Graphics/RenderTarget.hpp>
-
-
 #include "TextNode.h"
+#include "SpriteBatch.h"
 #include "Utility.h"
 
 
 TextNode::TextNode(const FontHolder& fonts, const std::string& text)
 {
-	text_.setFont(fonts.get(Fonts::Main));
+	// Headless worlds pass an empty font holder, an sf::Text without font never builds glyphs
+	if (const sf::Font* font = fonts.find(Fonts::Main))
+	{
+		text_.setFont(*font);
+	}
 	text_.setCharacterSize(20);
 	setString(text);
 }
 
-void TextNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+void TextNode::drawCurrent(SpriteBatch& batch, sf::RenderStates states, float) const
 {
-	target.draw(text_, states);
+	// Text uses the font texture, keep it from splitting the sprite batches
+	batch.drawOverlay(text_, states);
 }
 
 void TextNode::setString(const std::string& text)
@@ -0,0 +1,107 @@
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+	: workers_()
+	, mutex_()
+	, workAvailable_()
+	, workersIdle_()
+	, task_(nullptr)
+	, taskCount_(0)
+	, nextIndex_(0)
+	, generation_(0)
+	, busyWorkers_(0)
+	, isStopping_(false)
+{
+	if (threadCount == 0)
+	{
+		// hardware_concurrency() may not know the core count and return 0
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (std::size_t i = 1; i < threadCount; ++i)
+	{
+		workers_.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		isStopping_ = true;
+	}
+	workAvailable_.notify_all();
+
+	for (std::thread& worker : workers_)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::parallelFor(std::size_t count, const Task& task)
+{
+	{
+		// A worker still finishing the previous batch would otherwise pick up indices of this one
+		std::unique_lock<std::mutex> lock(mutex_);
+		workersIdle_.wait(lock, [this]() { return busyWorkers_ == 0; });
+
+		task_ = &task;
+		taskCount_ = count;
+		nextIndex_ = 0;
+		++generation_;
+	}
+	workAvailable_.notify_all();
+
+	runTasks(&task, count);
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	workersIdle_.wait(lock, [this]() { return busyWorkers_ == 0; });
+}
+
+std::size_t ThreadPool::getThreadCount() const
+{
+	return workers_.size() + 1;
+}
+
+void ThreadPool::workerLoop()
+{
+	std::size_t seenGeneration = 0;
+
+	while (true)
+	{
+		const Task* task;
+		std::size_t count;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			workAvailable_.wait(lock, [&]() { return isStopping_ || generation_ != seenGeneration; });
+			if (isStopping_)
+			{
+				return;
+			}
+
+			seenGeneration = generation_;
+			task = task_;
+			count = taskCount_;
+			++busyWorkers_;
+		}
+
+		// Waking up late is harmless: all indices are taken by then and the task is not called
+		runTasks(task, count);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			--busyWorkers_;
+		}
+		workersIdle_.notify_all();
+	}
+}
+
+void ThreadPool::runTasks(const Task* task, std::size_t count)
+{
+	for (std::size_t index = nextIndex_++; index < count; index = nextIndex_++)
+	{
+		(*task)(index);
+	}
+}
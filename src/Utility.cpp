@@ -15,7 +15,8 @@ namespace
 		return std::default_random_engine(seed);
 	}
 
-	auto RandomEngine = createRandomEngine();
+	// One engine per thread: the game server simulates its own world next to the client's
+	thread_local auto RandomEngine = createRandomEngine();
 }
 
 std::string toString(sf::Keyboard::Key key)
@@ -169,6 +170,11 @@ int randomInt(int exclusiveMax)
 	return random(RandomEngine);
 }
 
+void seedRandomEngine(unsigned int seed)
+{
+	RandomEngine.seed(seed);
+}
+
 float length(sf::Vector2f vector)
 {
 	return std::sqrt(vector.x * vector.x + vector.y * vector.y);
@@ -1,4 +1,7 @@
+#include <cassert>
 #include <cmath>
+#include <algorithm>
+#include <functional>
 
 #include "SpriteNode.h"
 #include "World.h"
@@ -7,17 +10,47 @@
 #include "SoundNode.h"
 #include "Category.h"
 #include "ResourceIdentifiers.h"
+#include "ThreadPool.h"
+
+namespace
+{
+	// A headless world has no target to take its view from, use the window size of the game
+	const sf::FloatRect HeadlessViewRect(0.f, 0.f, 1024.f, 768.f);
+
+	// Subtrees integrated per pool task, and the count below which waking the pool costs more than it saves
+	const std::size_t IntegrationChunkSize = 64;
+	const std::size_t ParallelIntegrationMinimum = 512;
+}
 
 
 World::World(sf::RenderTarget& outputTarget, FontHolder& fonts, SoundPlayer& sounds, bool isNetworked)
+	: World(&outputTarget, fonts, &sounds, isNetworked)
+{
+}
+
+World::World(FontHolder& fonts, bool isNetworked)
+	: World(nullptr, fonts, nullptr, isNetworked)
+{
+}
+
+World::World(sf::RenderTarget* outputTarget, FontHolder& fonts, SoundPlayer* sounds, bool isNetworked)
 	: target_(outputTarget)
 	, sceneTexture_()
-	, worldView_(outputTarget.getDefaultView())
+	, worldView_(outputTarget ? outputTarget->getDefaultView() : sf::View(HeadlessViewRect))
+	, previousViewCenter_()
 	, textures_()
 	, fonts_(fonts)
 	, sounds_(sounds)
+	, categoryRegistry_()
+	, particleRegistry_()
 	, sceneGraph_()
 	, sceneLayers_()
+	, spriteBatch_()
+	, integrationNodes_()
+	, integrationCommands_()
+	, collisionGrid_()
+	, collisionPairs_()
+	, bulletHits_()
 	, worldBounds_(0.f, 0.f, worldView_.getSize().x, 5000.f)
 	, spawnPosition_(worldView_.getSize().x / 2.f, worldBounds_.height - worldView_.getSize().y / 2.f)
 	, scrollSpeed_(-50.f)
@@ -25,17 +58,38 @@ World::World(sf::RenderTarget& outputTarget, FontHolder& fonts, SoundPlayer& sou
 	, playerAircrafts_()
 	, enemySpawnPoints_()
 	, activeEnemies_()
+	, bloomEffect_()
+	, profiler_(nullptr)
+	, threadPool_(nullptr)
+	, graphics_(nullptr)
 	, isNetworkedWorld_(isNetworked)
+	, isPlayerDamageEnabled_(true)
 	, networkNode_(nullptr)
+	, projectileSystem_(nullptr)
 	, finishSprite_(nullptr)
 {
-	sceneTexture_.create(target_.getSize().x, target_.getSize().y);
+	if (!isHeadless())
+	{
+		sceneTexture_ = std::make_unique<sf::RenderTexture>();
+		sceneTexture_->create(target_->getSize().x, target_->getSize().y);
+		bloomEffect_ = std::make_unique<BloomEffect>();
+	}
+
+	// Only these category pairs are handled in handleCollisions(), the broad phase ignores all others
+	collisionGrid_.addCollisionPair(Category::PlayerAircraft, Category::EnemyAircraft);
+	collisionGrid_.addCollisionPair(Category::PlayerAircraft, Category::Pickup);
+	collisionGrid_.addCollisionPair(Category::EnemyAircraft, Category::AlliedProjectile);
+	collisionGrid_.addCollisionPair(Category::PlayerAircraft, Category::EnemyProjectile);
+
+	// Every node attached below the root is registered by category for command dispatch
+	sceneGraph_.setCategoryRegistry(&categoryRegistry_);
 
 	loadTextures();
 	buildScene();
 
 	// Prepare the view
 	worldView_.setCenter(spawnPosition_);
+	previousViewCenter_ = spawnPosition_;
 }
 
 void World::setWorldScrollCompensation(float compensation)
@@ -45,6 +99,13 @@ void World::setWorldScrollCompensation(float compensation)
 
 void World::update(sf::Time dt)
 {
+	// Drawing interpolates from the state before this step, a headless world is never drawn
+	if (!isHeadless())
+	{
+		previousViewCenter_ = worldView_.getCenter();
+		sceneGraph_.storePreviousState();
+	}
+
 	// Scroll the world, reset player velocity
 	worldView_.move(0.f, scrollSpeed_ * dt.asSeconds() * scrollSpeedCompensation_);
 
@@ -53,55 +114,194 @@ void World::update(sf::Time dt)
 		aircraft->setVelocity(0.f, 0.f);
 	}
 
-	// Setup commands to destory entities, and guide missiles
-	destroyEntitiesOutsideView();
-	guideMissiles();
+	{
+		ProfileScope scope(profiler_, "commands");
+
+		// Setup commands to destory entities, and guide missiles
+		destroyEntitiesOutsideView();
+		guideMissiles();
+
+		// Forward commands to the nodes of matching category, adapt player velocity
+		categoryRegistry_.resetCounters();
+		Command command;
+		while (commandQueue_.pop(command))
+		{
+			categoryRegistry_.dispatch(command, dt);
+		}
+
+		// Adapt player velocity
+		adaptPlayerVelocity();
+	}
 
-	// Forward commands to scene graph, adapt player velocity
-	while (!commandQueue_.isEmpty())
 	{
-		sceneGraph_.onCommand(commandQueue_.pop(), dt);
+		ProfileScope scope(profiler_, "collisions");
+		handleCollisions();
 	}
 
-	// Adapt player velocity
-	adaptPlayerVelocity();
+	{
+		ProfileScope scope(profiler_, "removeWrecks");
+
+		// Remove aircrafts that were destroyed (World::removeWrecks() only destroys the entities, not the pointers in playerAircraft_)
+		auto firstToRemove = std::remove_if(playerAircrafts_.begin(), playerAircrafts_.end(), std::mem_fn(&Aircraft::isMarkedForRemoval));
+		playerAircrafts_.erase(firstToRemove, playerAircrafts_.end());
+
+		// Remove all destoryed entities
+		sceneGraph_.removeWrecks();
+	}
+
+	{
+		ProfileScope scope(profiler_, "spawn");
+		spawnEnemies();
+	}
 
-	// Handle collisions
-	handleCollisions();
+	{
+		ProfileScope scope(profiler_, "scene update");
 
-	// Remove aircrafts that were destroyed (World::removeWrecks() only destroys the entities, not the pointers in playerAircraft_)
-	auto firstToRemove = std::remove_if(playerAircrafts_.begin(), playerAircrafts_.end(), std::mem_fn(&Aircraft::isMarkedForRemoval));
-	playerAircrafts_.erase(firstToRemove, playerAircrafts_.end());
+		// Update scene, then let the emitters add their particles
+		sceneGraph_.update(dt, commandQueue_);
+		particleRegistry_.emit(dt);
 
-	// Remove all destoryed entities, create new ones
-	sceneGraph_.removeWrecks();
-	spawnEnemies();
+		if (profiler_)
+		{
+			profiler_->addCount("particles emitted", static_cast<double>(particleRegistry_.getEmittedCount()));
+			profiler_->addCount("particles skipped", static_cast<double>(particleRegistry_.getSkippedCount()));
+		}
+	}
 
-	// Update scene
-	sceneGraph_.update(dt, commandQueue_);
+	{
+		ProfileScope scope(profiler_, "integrate");
+		integrateScene(dt);
 
-	// Adapt player position based on velocity
-	adaptPlayerPosition();
+		// Adapt player position based on velocity
+		adaptPlayerPosition();
+	}
 
-	updateSounds();
+	if (!isHeadless())
+	{
+		ProfileScope scope(profiler_, "sounds");
+		updateSounds();
+	}
 }
 
-void World::draw()
+void World::draw(float alpha)
 {
-	if (PostEffect::isSupported())
+	assert(!isHeadless() && "World::draw - A headless world has no render target");
+
+	sf::View view(worldView_);
+	view.setCenter(previousViewCenter_ + (worldView_.getCenter() - previousViewCenter_) * alpha);
+
+	const BloomQuality bloomQuality = graphics_ ? graphics_->bloomQuality : BloomQuality::High;
+
+	if (PostEffect::isSupported() && bloomQuality != BloomQuality::Off)
 	{
-		sceneTexture_.clear();
-		sceneTexture_.setView(worldView_);
-		sceneTexture_.draw(sceneGraph_);
-		sceneTexture_.display();
-		bloomEffect_.apply(sceneTexture_, target_);
+		bloomEffect_->setQuality(bloomQuality);
+		bloomEffect_->setHalfRate(graphics_ && graphics_->isBloomHalfRate);
+
+		{
+			ProfileScope scope(profiler_, "render scene");
+			sceneTexture_->clear();
+			sceneTexture_->setView(view);
+			drawScene(*sceneTexture_, alpha);
+			sceneTexture_->display();
+		}
+
+		ProfileScope scope(profiler_, "bloom");
+		bloomEffect_->apply(*sceneTexture_, *target_);
 		// target_.setView(worldView_);
 		// target_.draw(sceneGraph_);
 	}
 	else
 	{
-		target_.setView(worldView_);
-		target_.draw(sceneGraph_);
+		ProfileScope scope(profiler_, "render scene");
+		target_->setView(view);
+		drawScene(*target_, alpha);
+	}
+}
+
+bool World::isHeadless() const
+{
+	return target_ == nullptr;
+}
+
+void World::setProfiler(Profiler* profiler)
+{
+	profiler_ = profiler;
+
+	if (bloomEffect_)
+	{
+		bloomEffect_->setProfiler(profiler);
+	}
+}
+
+void World::setThreadPool(ThreadPool* threadPool)
+{
+	threadPool_ = threadPool;
+}
+
+void World::setGraphicsSettings(const GraphicsSettings* graphics)
+{
+	graphics_ = graphics;
+}
+
+void World::setPlayerDamageEnabled(bool enabled)
+{
+	isPlayerDamageEnabled_ = enabled;
+}
+
+void World::integrateScene(sf::Time dt)
+{
+	// Every entity lives below a layer, and integrating a subtree only changes that subtree
+	integrationNodes_.clear();
+	for (SceneNode* layer : sceneLayers_)
+	{
+		// Integrated nodes may read their world position, their parents' transforms must not be computed concurrently
+		layer->getWorldTransform();
+		layer->collectChildren(integrationNodes_);
+	}
+
+	const std::size_t nodeCount = integrationNodes_.size();
+	if (threadPool_ == nullptr || nodeCount < ParallelIntegrationMinimum)
+	{
+		for (SceneNode* node : integrationNodes_)
+		{
+			node->integrate(dt, commandQueue_);
+		}
+		return;
+	}
+
+	// Commands are buffered per chunk and appended in chunk order, so the queue is the same as in a serial run
+	const std::size_t chunkCount = (nodeCount + IntegrationChunkSize - 1) / IntegrationChunkSize;
+	if (integrationCommands_.size() < chunkCount)
+	{
+		integrationCommands_.resize(chunkCount);
+	}
+
+	threadPool_->parallelFor(chunkCount, [&](std::size_t chunk)
+		{
+			const std::size_t end = std::min(nodeCount, (chunk + 1) * IntegrationChunkSize);
+			for (std::size_t i = chunk * IntegrationChunkSize; i < end; ++i)
+			{
+				integrationNodes_[i]->integrate(dt, integrationCommands_[chunk]);
+			}
+		});
+
+	Command command;
+	for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+	{
+		while (integrationCommands_[chunk].pop(command))
+		{
+			commandQueue_.push(command);
+		}
+	}
+}
+
+void World::drawScene(sf::RenderTarget& target, float alpha)
+{
+	// One flush per layer keeps the layer order, within a layer sprites sharing a texture become one draw call
+	for (SceneNode* layer : sceneLayers_)
+	{
+		layer->draw(spriteBatch_, sf::RenderStates::Default, alpha);
+		spriteBatch_.flush(target);
 	}
 }
 
@@ -110,6 +310,11 @@ CommandQueue& World::getCommandQueue()
 	return commandQueue_;
 }
 
+const CategoryRegistry& World::getCategoryRegistry() const
+{
+	return categoryRegistry_;
+}
+
 Aircraft* World::getAircraft(int identifier) const
 {
 	for (const auto& aircraft : playerAircrafts_)
@@ -134,7 +339,7 @@ void World::removeAircraft(int identifier)
 
 Aircraft* World::addAircraft(int identifier)
 {
-	std::unique_ptr<Aircraft> player = std::make_unique<Aircraft>(Aircraft::Eagle, textures_, fonts_);
+	std::unique_ptr<Aircraft> player = std::make_unique<Aircraft>(Aircraft::Eagle, textures_, fonts_, particleRegistry_);
 	player->setPosition(worldView_.getCenter());
 	player->setIdentifier(identifier);
 
@@ -159,6 +364,7 @@ bool World::pollGameAction(GameActions::Action& out)
 void World::setCurrentBattleFieldPosition(float lineY)
 {
 	worldView_.setCenter(worldView_.getCenter().x, lineY - worldView_.getSize().y / 2);
+	previousViewCenter_ = worldView_.getCenter();
 	spawnPosition_.y = worldBounds_.height;
 }
 
@@ -184,6 +390,12 @@ bool World::hasPlayerReachedEnd() const
 
 void World::loadTextures()
 {
+	// Creating textures needs an OpenGL context, nodes of a headless world do without
+	if (isHeadless())
+	{
+		return;
+	}
+
 	textures_.load(Textures::Entities, "Media/Textures/Entities.png");
 	textures_.load(Textures::Jungle, "Media/Textures/Jungle.png");
 	textures_.load(Textures::Explosion, "Media/Textures/Explosion.png");
@@ -248,10 +460,12 @@ bool matchesCategories(SceneNode::Pair& colliders, Category type1, Category type
 
 void World::handleCollisions()
 {
-	std::set<SceneNode::Pair> collisionPairs;
-	sceneGraph_.checkSceneCollision(sceneGraph_, collisionPairs);
+	// Broad phase: bucket all collidable entities into the grid, then gather overlapping pairs
+	collisionGrid_.clear();
+	sceneGraph_.insertColliders(collisionGrid_);
+	collisionGrid_.computePairs(collisionPairs_);
 
-	for (auto pair : collisionPairs)
+	for (auto pair : collisionPairs_)
 	{
 		if (matchesCategories(pair, Category::PlayerAircraft, Category::EnemyAircraft))
 		{
@@ -259,7 +473,7 @@ void World::handleCollisions()
 			auto& enemy = static_cast<Aircraft&>(*pair.second);
 
 			// Collision: Player damage = enemy's remaining hitpoints
-			player.damage(enemy.getHitpoints());
+			applyDamage(player, enemy.getHitpoints());
 			enemy.destroy();
 		}
 		else if (matchesCategories(pair, Category::PlayerAircraft, Category::Pickup))
@@ -279,10 +493,27 @@ void World::handleCollisions()
 			auto& projectile = static_cast<Projectile&>(*pair.second);
 
 			// Apply projectile damage to aircraft
-			aircraft.damage(projectile.getDamage());
+			applyDamage(aircraft, projectile.getDamage());
 			projectile.destroy();
 		}
 	}
+
+	// Bullets are not scene nodes, the projectile system tests them against the aircraft in the grid
+	projectileSystem_->checkCollisions(collisionGrid_, bulletHits_);
+	for (const ProjectileSystem::Hit& hit : bulletHits_)
+	{
+		applyDamage(static_cast<Aircraft&>(*hit.target), hit.damage);
+		particleRegistry_.burst(Particle::Spark, hit.position, -hit.velocity);
+	}
+}
+
+void World::applyDamage(Aircraft& aircraft, int points)
+{
+	// The hit itself still happens, only the hitpoints of player aircraft wait for the server
+	if (isPlayerDamageEnabled_ || !aircraft.isAllied())
+	{
+		aircraft.damage(points);
+	}
 }
 
 void World::updateSounds()
@@ -305,10 +536,10 @@ void World::updateSounds()
 	}
 
 	// Set listener position to the player's position
-	sounds_.setListenerPosition(listenerPosition);
+	sounds_->setListenerPosition(listenerPosition);
 
 	// Remove unused sounds
-	sounds_.removeStoppedSounds();
+	sounds_->removeStoppedSounds();
 }
 
 void World::buildScene()
@@ -324,37 +555,53 @@ void World::buildScene()
 		sceneGraph_.attachChild(std::move(layer));
 	}
 
-	// Prepare the tiled background
-	sf::Texture& jungleTexture = textures_.get(Textures::Jungle);
-	jungleTexture.setRepeated(true);
-
-	float viewHeight = worldView_.getSize().y;
-	sf::IntRect textureRect(worldBounds_);
-	textureRect.height += static_cast<int>(viewHeight);
-
-	// Add the background sprite to the scene
-	std::unique_ptr<SpriteNode> jungleSprite = std::make_unique<SpriteNode>(jungleTexture, textureRect);
-	jungleSprite->setPosition(worldBounds_.left, worldBounds_.top - viewHeight);
-	sceneLayers_[Background]->attachChild(std::move(jungleSprite));
-
-	// Add the finish line to the scene
-	sf::Texture& finishTexture = textures_.get(Textures::FinishLine);
-	std::unique_ptr<SpriteNode> finishSprite = std::make_unique<SpriteNode>(finishTexture);
-	finishSprite->setPosition(0.f, -76.f);
-	finishSprite_ = finishSprite.get();
-	sceneLayers_[Background]->attachChild(std::move(finishSprite));
+	// The background sprites are purely visual, a headless world leaves them out
+	if (!isHeadless())
+	{
+		// Prepare the tiled background
+		sf::Texture& jungleTexture = textures_.get(Textures::Jungle);
+		jungleTexture.setRepeated(true);
+
+		float viewHeight = worldView_.getSize().y;
+		sf::IntRect textureRect(worldBounds_);
+		textureRect.height += static_cast<int>(viewHeight);
+
+		// Add the background sprite to the scene
+		std::unique_ptr<SpriteNode> jungleSprite = std::make_unique<SpriteNode>(jungleTexture, textureRect);
+		jungleSprite->setPosition(worldBounds_.left, worldBounds_.top - viewHeight);
+		sceneLayers_[Background]->attachChild(std::move(jungleSprite));
+
+		// Add the finish line to the scene
+		sf::Texture& finishTexture = textures_.get(Textures::FinishLine);
+		std::unique_ptr<SpriteNode> finishSprite = std::make_unique<SpriteNode>(finishTexture);
+		finishSprite->setPosition(0.f, -76.f);
+		finishSprite_ = finishSprite.get();
+		sceneLayers_[Background]->attachChild(std::move(finishSprite));
+	}
 
-	// Add particle node to the scene
-	std::unique_ptr<ParticleNode> smokeNode = std::make_unique<ParticleNode>(Particle::Smoke, textures_);
-	sceneLayers_[LowerAir]->attachChild(std::move(smokeNode));
+	// Add a particle node per type to the scene, in drawing order. A headless world registers none, so its emitters
+	// and bursts cost nothing.
+	for (Particle::Type type : { Particle::EngineTrail, Particle::Smoke, Particle::Propellant, Particle::Debris, Particle::Spark })
+	{
+		std::unique_ptr<ParticleNode> particleNode = std::make_unique<ParticleNode>(type, textures_);
+		if (!isHeadless())
+		{
+			particleRegistry_.addSystem(*particleNode);
+		}
+		sceneLayers_[LowerAir]->attachChild(std::move(particleNode));
+	}
 
-	// Add propellant particle node to the scene
-	std::unique_ptr<ParticleNode> propellantNode = std::make_unique<ParticleNode>(Particle::Propellant, textures_);
-	sceneLayers_[LowerAir]->attachChild(std::move(propellantNode));
+	// Add projectile system, which simulates and draws all bullets
+	std::unique_ptr<ProjectileSystem> projectileSystem = std::make_unique<ProjectileSystem>(textures_);
+	projectileSystem_ = projectileSystem.get();
+	sceneLayers_[LowerAir]->attachChild(std::move(projectileSystem));
 
-	// Add sound effect node
-	std::unique_ptr<SoundNode> soundNode = std::make_unique<SoundNode>(sounds_);
-	sceneGraph_.attachChild(std::move(soundNode));
+	// Add sound effect node, without sound player the sound commands simply find no receiver
+	if (sounds_)
+	{
+		std::unique_ptr<SoundNode> soundNode = std::make_unique<SoundNode>(*sounds_);
+		sceneGraph_.attachChild(std::move(soundNode));
+	}
 
 	// Add network node, if necessary
 	if (isNetworkedWorld_)
@@ -426,7 +673,7 @@ void World::spawnEnemies()
 	{
 		SpawnPoint spawn = enemySpawnPoints_.back();
 
-		std::unique_ptr<Aircraft> enemy = std::make_unique<Aircraft>(spawn.type, textures_, fonts_);
+		std::unique_ptr<Aircraft> enemy = std::make_unique<Aircraft>(spawn.type, textures_, fonts_, particleRegistry_);
 		enemy->setPosition(spawn.x, spawn.y);
 		enemy->setRotation(180.f);
 		if (isNetworkedWorld_)
@@ -454,6 +701,7 @@ void World::destroyEntitiesOutsideView()
 		});
 
 	commandQueue_.push(command);
+	projectileSystem_->removeOutside(getBattleFieldBounds());
 }
 
 void World::guideMissiles()